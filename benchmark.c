@@ -0,0 +1,1102 @@
+//-----------------------------------------------------------------------------//
+// CRingBuffer MPMC - FIFO helper                                              //
+// (c) 2023 Laurent Lardinois https://be.linkedin.com/in/laurentlardinois      //
+//                                                                             //
+// https://github.com/type-one/CRingBuffer_MPSC                                //
+//                                                                             //
+// This software is provided 'as-is', without any express or implied           //
+// warranty.In no event will the authors be held liable for any damages        //
+// arising from the use of this software.                                      //
+//                                                                             //
+// Permission is granted to anyone to use this software for any purpose,       //
+// including commercial applications, and to alter itand redistribute it       //
+// freely, subject to the following restrictions :                             //
+//                                                                             //
+// 1. The origin of this software must not be misrepresented; you must not     //
+// claim that you wrote the original software.If you use this software         //
+// in a product, an acknowledgment in the product documentation would be       //
+// appreciated but is not required.                                            //
+// 2. Altered source versions must be plainly marked as such, and must not be  //
+// misrepresented as being the original software.                              //
+// 3. This notice may not be removed or altered from any source distribution.  //
+//-----------------------------------------------------------------------------//
+
+/* benchmark harness: runs a matrix of producer/consumer scenarios given on the command line
+   and reports throughput, per-message latency percentiles and drop rate as text, csv or json */
+
+#include "tools/atomic_helper.h"
+#include "tools/mem_alloc.h"
+#include "tools/ring_buffer_broadcast.h"
+#include "tools/ring_buffer_mpmc.h"
+#include "tools/ring_buffer_mpmc_inline.h"
+#include "tools/ring_buffer_segmented.h"
+#include "tools/ring_buffer_numa.h"
+#include "tools/ring_buffer_priority.h"
+#include "tools/ring_buffer_sharded.h"
+#include "tools/ring_buffer_mpmc_lf.h"
+#include "tools/ring_buffer_spsc.h"
+#include "tools/thread_helper.h"
+#include "tools/timer_chrono.h"
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#if defined(_WIN32)
+#include <windows.h>
+#elif defined(__STDC_NO_THREADS__)
+#include <pthread.h>
+#include <sched.h>
+#else
+#include <threads.h>
+#endif
+
+#define BENCH_MAX_LIST 16
+#define BENCH_MAX_THREADS 256
+#define BENCH_PRIORITY_CLASSES 4 /* messages spread round-robin over the classes, weights 8, 4, 2, 1 */
+#define BENCH_WAIT_TIMEOUT_US 10000UL /* blocking mode, to check regularly for an aborted run */
+
+enum bench_engine
+{
+    BENCH_ENGINE_MPMC,
+    BENCH_ENGINE_LF,
+    BENCH_ENGINE_SPSC,
+    BENCH_ENGINE_INLINE,
+    BENCH_ENGINE_SEGMENTED,
+    BENCH_ENGINE_SHARDED,
+    BENCH_ENGINE_NUMA,
+    BENCH_ENGINE_PIPELINE, /* ring_buffer_broadcast, the consumers are stages chained with depends_on */
+    BENCH_ENGINE_PRIORITY, /* ring_buffer_priority, strict policy */
+    BENCH_ENGINE_WEIGHTED, /* ring_buffer_priority, weighted round-robin policy */
+    BENCH_ENGINE_COUNT
+};
+
+enum bench_mode
+{
+    BENCH_MODE_DROP,  /* push once, drop the message when full (the 'no wait' scenarios of main.c) */
+    BENCH_MODE_RETRY, /* retry (yield) until the push succeeds */
+    BENCH_MODE_BLOCK, /* ring_buffer_push_wait/pop_wait, mutex engine only */
+    BENCH_MODE_COUNT
+};
+
+enum bench_placement
+{
+    BENCH_PLACEMENT_NONE,   /* left to the OS scheduler */
+    BENCH_PLACEMENT_SMT,    /* producer and consumer on the SMT siblings of a core */
+    BENCH_PLACEMENT_CORE,   /* different cores of the same socket */
+    BENCH_PLACEMENT_SOCKET, /* producers on one socket, consumers on another */
+    BENCH_PLACEMENT_COUNT
+};
+
+/* ring layout this binary is built with (cringbuffer_bench_packed: RING_BUFFER_MPMC_CACHE_ALIGNED=0) */
+#if RING_BUFFER_MPMC_CACHE_ALIGNED
+#define BENCH_LAYOUT "aligned"
+#else
+#define BENCH_LAYOUT "packed"
+#endif
+
+enum bench_format
+{
+    BENCH_FORMAT_TEXT,
+    BENCH_FORMAT_CSV,
+    BENCH_FORMAT_JSON
+};
+
+static const char* const st_engine_names[BENCH_ENGINE_COUNT] = { "mpmc", "lf", "spsc", "inline", "segmented", "sharded", "numa", "pipeline", "priority",
+    "weighted" };
+static const char* const st_mode_names[BENCH_MODE_COUNT] = { "drop", "retry", "block" };
+static const char* const st_placement_names[BENCH_PLACEMENT_COUNT] = { "none", "smt", "core", "cross" };
+
+struct bench_options
+{
+    int m_engines[BENCH_MAX_LIST];
+    int m_nb_engines;
+    int m_modes[BENCH_MAX_LIST];
+    int m_nb_modes;
+    int m_placements[BENCH_MAX_LIST];
+    int m_nb_placements;
+    int m_producers[BENCH_MAX_LIST];
+    int m_nb_producers;
+    int m_consumers[BENCH_MAX_LIST];
+    int m_nb_consumers;
+    long m_messages; /* per producer */
+    unsigned long long m_capacity;
+    int m_work;
+    int m_repeat;
+    enum bench_format m_format;
+    bool m_header; /* false: rows only, to append to the output of another build */
+};
+
+struct bench_msg
+{
+    uint64_t m_stamp_ticks; /* push time, time stamp counter */
+    int m_producer;
+    int m_priority; /* class of the priority engines */
+};
+
+struct bench_result
+{
+    double m_elapsed_ms;
+    long m_processed;
+    long m_dropped;
+    double m_p50_us;
+    double m_p90_us;
+    double m_p99_us;
+    double m_p999_us;
+    double m_max_us;
+    long long m_steals; /* numa: pops served by another node's ring */
+    long long m_spills; /* numa: pushes that overflowed into another node's ring */
+    double m_read_reloads;  /* spsc: loads of the shared consumer index by the producer, per message */
+    double m_write_reloads; /* spsc: loads of the shared producer index by the consumer, per message */
+    struct ring_buffer_mpmc_stats m_stats; /* mpmc: queue counters, all 0 unless built with RING_BUFFER_MPMC_STATS */
+};
+
+struct bench_context
+{
+    enum bench_engine m_engine;
+    enum bench_mode m_mode;
+    enum bench_placement m_placement;
+    int m_nb_producers;
+    int m_nb_consumers;
+    long m_messages;
+    int m_work;
+
+    union
+    {
+        struct ring_buffer_mpmc m_mpmc;
+        struct ring_buffer_mpmc_lf m_lf;
+        struct ring_buffer_spsc m_spsc;
+        struct ring_buffer_mpmc_inline m_inline;
+        struct ring_buffer_segmented m_segmented;
+        struct ring_buffer_sharded m_sharded;
+        struct ring_buffer_numa m_numa;
+        struct ring_buffer_broadcast m_broadcast;
+        struct ring_buffer_priority m_priority;
+    } m_fifo;
+
+    struct bench_msg* m_msgs; /* storage for the pointer based engines, m_messages per producer */
+    double* m_latencies_us;
+    _atomic_long m_nb_latencies;
+    _atomic_long m_remaining; /* messages not yet consumed nor dropped */
+    _atomic_long m_dropped;
+    _atomic_int m_next_producer;
+    _atomic_int m_next_consumer;
+    _atomic_bool m_start;
+};
+
+static void bench_yield(void)
+{
+#if defined(_WIN32)
+    Sleep(0);
+#elif defined(__STDC_NO_THREADS__)
+    sched_yield();
+#else
+    thrd_yield();
+#endif
+}
+
+static int bench_fifo_init(struct bench_context* ctxt, unsigned long long capacity)
+{
+    switch (ctxt->m_engine)
+    {
+        case BENCH_ENGINE_MPMC:
+            return init_ring_buffer_mpmc_ex(&(ctxt->m_fifo.m_mpmc), capacity, NULL);
+        case BENCH_ENGINE_LF:
+            return init_ring_buffer_mpmc_lf_ex(&(ctxt->m_fifo.m_lf), capacity, NULL);
+        case BENCH_ENGINE_SPSC:
+            return init_ring_buffer_spsc_ex(&(ctxt->m_fifo.m_spsc), capacity, NULL);
+        case BENCH_ENGINE_INLINE:
+            return init_ring_buffer_mpmc_inline_ex(&(ctxt->m_fifo.m_inline), capacity, sizeof(struct bench_msg), NULL);
+        case BENCH_ENGINE_SEGMENTED:
+            return init_ring_buffer_segmented_ex(&(ctxt->m_fifo.m_segmented), capacity, RING_BUFFER_SEGMENTED_MAX_SPARE);
+        case BENCH_ENGINE_SHARDED:
+            /* one lane per producer */
+            return init_ring_buffer_sharded_ex(&(ctxt->m_fifo.m_sharded), ctxt->m_nb_producers, capacity);
+        case BENCH_ENGINE_NUMA:
+            /* one ring per node of the machine */
+            return init_ring_buffer_numa_ex(&(ctxt->m_fifo.m_numa), 0, capacity, 0);
+        case BENCH_ENGINE_PIPELINE:
+            if (init_ring_buffer_broadcast_ex(&(ctxt->m_fifo.m_broadcast), ctxt->m_nb_consumers, capacity, NULL) < 0)
+            {
+                return -1;
+            }
+            /* every stage sees a message once the previous one released it */
+            for (int stage = 1; stage < ctxt->m_nb_consumers; ++stage)
+            {
+                (void)ring_buffer_broadcast_depends_on(&(ctxt->m_fifo.m_broadcast), stage, stage - 1);
+            }
+            return 0;
+        case BENCH_ENGINE_PRIORITY:
+            return init_ring_buffer_priority_ex(&(ctxt->m_fifo.m_priority), BENCH_PRIORITY_CLASSES, capacity, RING_BUFFER_PRIORITY_STRICT, NULL);
+        case BENCH_ENGINE_WEIGHTED:
+        {
+            static const unsigned int weights[BENCH_PRIORITY_CLASSES] = { 8U, 4U, 2U, 1U };
+            return init_ring_buffer_priority_ex(&(ctxt->m_fifo.m_priority), BENCH_PRIORITY_CLASSES, capacity, RING_BUFFER_PRIORITY_WEIGHTED, weights);
+        }
+        default:
+            return -1;
+    }
+}
+
+static void bench_fifo_deinit(struct bench_context* ctxt)
+{
+    switch (ctxt->m_engine)
+    {
+        case BENCH_ENGINE_MPMC:
+            (void)deinit_ring_buffer_mpmc(&(ctxt->m_fifo.m_mpmc));
+            break;
+        case BENCH_ENGINE_LF:
+            (void)deinit_ring_buffer_mpmc_lf(&(ctxt->m_fifo.m_lf));
+            break;
+        case BENCH_ENGINE_SPSC:
+            (void)deinit_ring_buffer_spsc(&(ctxt->m_fifo.m_spsc));
+            break;
+        case BENCH_ENGINE_INLINE:
+            (void)deinit_ring_buffer_mpmc_inline(&(ctxt->m_fifo.m_inline));
+            break;
+        case BENCH_ENGINE_SEGMENTED:
+            (void)deinit_ring_buffer_segmented(&(ctxt->m_fifo.m_segmented));
+            break;
+        case BENCH_ENGINE_SHARDED:
+            (void)deinit_ring_buffer_sharded(&(ctxt->m_fifo.m_sharded));
+            break;
+        case BENCH_ENGINE_NUMA:
+            (void)deinit_ring_buffer_numa(&(ctxt->m_fifo.m_numa));
+            break;
+        case BENCH_ENGINE_PIPELINE:
+            (void)deinit_ring_buffer_broadcast(&(ctxt->m_fifo.m_broadcast));
+            break;
+        case BENCH_ENGINE_PRIORITY:
+        case BENCH_ENGINE_WEIGHTED:
+            (void)deinit_ring_buffer_priority(&(ctxt->m_fifo.m_priority));
+            break;
+        default:
+            break;
+    }
+}
+
+static bool bench_fifo_push(struct bench_context* ctxt, struct bench_msg* msg)
+{
+    switch (ctxt->m_engine)
+    {
+        case BENCH_ENGINE_MPMC:
+            if (BENCH_MODE_BLOCK == ctxt->m_mode)
+            {
+                return (1 == ctxt->m_nb_producers) ? ring_buffer_push_wait_sp(&(ctxt->m_fifo.m_mpmc), msg, BENCH_WAIT_TIMEOUT_US)
+                                                   : ring_buffer_push_wait_mp(&(ctxt->m_fifo.m_mpmc), msg, BENCH_WAIT_TIMEOUT_US);
+            }
+            return (1 == ctxt->m_nb_producers) ? ring_buffer_push_sp(&(ctxt->m_fifo.m_mpmc), msg) : ring_buffer_push_mp(&(ctxt->m_fifo.m_mpmc), msg);
+        case BENCH_ENGINE_LF:
+            return ring_buffer_lf_push(&(ctxt->m_fifo.m_lf), msg);
+        case BENCH_ENGINE_SPSC:
+            return ring_buffer_spsc_push(&(ctxt->m_fifo.m_spsc), msg);
+        case BENCH_ENGINE_INLINE:
+            return ring_buffer_inline_push(&(ctxt->m_fifo.m_inline), msg);
+        case BENCH_ENGINE_SEGMENTED:
+            return (1 == ctxt->m_nb_producers) ? ring_buffer_segmented_push_sp(&(ctxt->m_fifo.m_segmented), msg)
+                                               : ring_buffer_segmented_push_mp(&(ctxt->m_fifo.m_segmented), msg);
+        case BENCH_ENGINE_SHARDED:
+            return ring_buffer_sharded_push_lane(&(ctxt->m_fifo.m_sharded), msg->m_producer, msg);
+        case BENCH_ENGINE_NUMA:
+            return ring_buffer_numa_push(&(ctxt->m_fifo.m_numa), msg);
+        case BENCH_ENGINE_PIPELINE:
+            return (1 == ctxt->m_nb_producers) ? ring_buffer_broadcast_push_sp(&(ctxt->m_fifo.m_broadcast), msg)
+                                               : ring_buffer_broadcast_push_mp(&(ctxt->m_fifo.m_broadcast), msg);
+        case BENCH_ENGINE_PRIORITY:
+        case BENCH_ENGINE_WEIGHTED:
+            return (1 == ctxt->m_nb_producers) ? ring_buffer_priority_push_sp(&(ctxt->m_fifo.m_priority), msg->m_priority, msg)
+                                               : ring_buffer_priority_push_mp(&(ctxt->m_fifo.m_priority), msg->m_priority, msg);
+        default:
+            return false;
+    }
+}
+
+/* msg receives a copy of the message, consumer is the stage of the pipeline engine */
+static bool bench_fifo_pop(struct bench_context* ctxt, int consumer, struct bench_msg* msg)
+{
+    void* elem = NULL;
+    bool ret = false;
+
+    switch (ctxt->m_engine)
+    {
+        case BENCH_ENGINE_MPMC:
+            if (BENCH_MODE_BLOCK == ctxt->m_mode)
+            {
+                ret = (1 == ctxt->m_nb_consumers) ? ring_buffer_pop_wait_sc(&(ctxt->m_fifo.m_mpmc), &elem, BENCH_WAIT_TIMEOUT_US)
+                                                  : ring_buffer_pop_wait_mc(&(ctxt->m_fifo.m_mpmc), &elem, BENCH_WAIT_TIMEOUT_US);
+            }
+            else
+            {
+                ret = (1 == ctxt->m_nb_consumers) ? ring_buffer_pop_sc(&(ctxt->m_fifo.m_mpmc), &elem) : ring_buffer_pop_mc(&(ctxt->m_fifo.m_mpmc), &elem);
+            }
+            break;
+        case BENCH_ENGINE_LF:
+            ret = ring_buffer_lf_pop(&(ctxt->m_fifo.m_lf), &elem);
+            break;
+        case BENCH_ENGINE_SPSC:
+            ret = ring_buffer_spsc_pop(&(ctxt->m_fifo.m_spsc), &elem);
+            break;
+        case BENCH_ENGINE_INLINE:
+            return ring_buffer_inline_pop(&(ctxt->m_fifo.m_inline), msg);
+        case BENCH_ENGINE_SEGMENTED:
+            ret = (1 == ctxt->m_nb_consumers) ? ring_buffer_segmented_pop_sc(&(ctxt->m_fifo.m_segmented), &elem)
+                                              : ring_buffer_segmented_pop_mc(&(ctxt->m_fifo.m_segmented), &elem);
+            break;
+        case BENCH_ENGINE_SHARDED:
+            ret = ring_buffer_sharded_pop(&(ctxt->m_fifo.m_sharded), &elem);
+            break;
+        case BENCH_ENGINE_NUMA:
+            ret = ring_buffer_numa_pop(&(ctxt->m_fifo.m_numa), &elem);
+            break;
+        case BENCH_ENGINE_PIPELINE:
+            ret = ring_buffer_broadcast_pop(&(ctxt->m_fifo.m_broadcast), consumer, &elem);
+            break;
+        case BENCH_ENGINE_PRIORITY:
+        case BENCH_ENGINE_WEIGHTED:
+            ret = (1 == ctxt->m_nb_consumers) ? ring_buffer_priority_pop_sc(&(ctxt->m_fifo.m_priority), &elem, NULL)
+                                              : ring_buffer_priority_pop_mc(&(ctxt->m_fifo.m_priority), &elem, NULL);
+            break;
+        default:
+            break;
+    }
+
+    if (ret && elem)
+    {
+        *msg = *(struct bench_msg*)elem;
+        return true;
+    }
+
+    return false;
+}
+
+static void bench_producer_thread(void* arg)
+{
+    struct bench_context* ctxt = (struct bench_context*)arg;
+    const int my_id = sync_atomic_inc_32(ctxt->m_next_producer);
+
+    while (!sync_atomic_load_acquire(ctxt->m_start))
+    {
+        bench_yield();
+    }
+
+    for (long i = 0; i < ctxt->m_messages; ++i)
+    {
+        struct bench_msg* msg = &(ctxt->m_msgs[(long)my_id * ctxt->m_messages + i]);
+        msg->m_producer = my_id;
+        msg->m_priority = (int)(i % BENCH_PRIORITY_CLASSES);
+        msg->m_stamp_ticks = timer_chrono_ticks();
+
+        while (!bench_fifo_push(ctxt, msg))
+        {
+            if (BENCH_MODE_DROP == ctxt->m_mode)
+            {
+                sync_atomic_inc_32(ctxt->m_dropped);
+                sync_atomic_dec_32(ctxt->m_remaining);
+                break;
+            }
+
+            /* the run was aborted, nobody will consume */
+            if (sync_atomic_load(ctxt->m_remaining) <= 0)
+            {
+                break;
+            }
+
+            if (BENCH_MODE_RETRY == ctxt->m_mode)
+            {
+                bench_yield();
+            }
+        }
+    }
+}
+
+static void bench_consumer_thread(void* arg)
+{
+    struct bench_context* ctxt = (struct bench_context*)arg;
+    const int my_id = sync_atomic_inc_32(ctxt->m_next_consumer);
+
+    /* every stage of the pipeline sees every message, the last one accounts for it */
+    const bool accounts = (BENCH_ENGINE_PIPELINE != ctxt->m_engine) || (my_id == ctxt->m_nb_consumers - 1);
+
+    while (!sync_atomic_load_acquire(ctxt->m_start))
+    {
+        bench_yield();
+    }
+
+    while (sync_atomic_load(ctxt->m_remaining) > 0)
+    {
+        struct bench_msg msg;
+
+        if (!bench_fifo_pop(ctxt, my_id, &msg))
+        {
+            if (BENCH_MODE_BLOCK != ctxt->m_mode)
+            {
+                bench_yield();
+            }
+            continue;
+        }
+
+        if (accounts)
+        {
+            const uint64_t now_ticks = timer_chrono_ticks();
+            const double latency_us = (now_ticks > msg.m_stamp_ticks) ? (double)timer_chrono_ticks_to_ns(now_ticks - msg.m_stamp_ticks) / 1000.0 : 0.0;
+            ctxt->m_latencies_us[sync_atomic_inc_32(ctxt->m_nb_latencies)] = latency_us;
+        }
+
+        /* simulate some processing */
+        for (volatile int i = 0; i < ctxt->m_work; ++i)
+        {
+        }
+
+        if (accounts)
+        {
+            sync_atomic_dec_32(ctxt->m_remaining);
+        }
+    }
+}
+
+static int bench_compare_double(const void* a, const void* b)
+{
+    const double da = *(const double*)a;
+    const double db = *(const double*)b;
+    return (da > db) - (da < db);
+}
+
+static double bench_percentile(const double* sorted, long count, double percentile)
+{
+    if (count <= 0)
+    {
+        return 0.0;
+    }
+
+    long idx = (long)(percentile * (double)(count - 1) / 100.0 + 0.5);
+    return sorted[(idx < count) ? idx : count - 1];
+}
+
+/* first allowed CPU of its core */
+static bool bench_is_first_of_core(const int* cores, int idx)
+{
+    for (int i = 0; i < idx; ++i)
+    {
+        if (cores[i] == cores[idx])
+        {
+            return false;
+        }
+    }
+
+    return true;
+}
+
+/* CPU of every thread (producers first) for a placement, false if the machine can not provide it */
+static bool bench_placement_cpus(enum bench_placement placement, int nb_producers, int nb_consumers, int* cpus)
+{
+    int cores[THREAD_MAX_CPUS];
+    int packages[THREAD_MAX_CPUS];
+    int producer_cpus[THREAD_MAX_CPUS];
+    int consumer_cpus[THREAD_MAX_CPUS];
+    int nb_producer_cpus = 0;
+    int nb_consumer_cpus = 0;
+    int nb_same_package = 0;
+    int consumer_package = -1;
+    int allowed[THREAD_MAX_CPUS];
+    int nb_cpus = 0;
+
+    if (BENCH_PLACEMENT_NONE == placement)
+    {
+        return true;
+    }
+
+    /* only the CPUs this process may run on (affinity mask, container cpuset), indexes below refer to allowed[] */
+    struct thread_cpu_set allowed_set;
+    (void)thread_cpu_allowed(&allowed_set);
+
+    for (int cpu = 0; cpu < THREAD_MAX_CPUS; ++cpu)
+    {
+        if (thread_cpu_set_has(&allowed_set, cpu))
+        {
+            if (thread_cpu_topology(cpu, &cores[nb_cpus], &packages[nb_cpus]) < 0)
+            {
+                return false;
+            }
+            allowed[nb_cpus++] = cpu;
+        }
+    }
+
+    for (int idx = 0; idx < nb_cpus; ++idx)
+    {
+        const int cpu = allowed[idx];
+
+        if (!bench_is_first_of_core(cores, idx))
+        {
+            continue;
+        }
+
+        switch (placement)
+        {
+            case BENCH_PLACEMENT_SMT:
+                /* pair the first two siblings of each core */
+                for (int sibling = idx + 1; sibling < nb_cpus; ++sibling)
+                {
+                    if (cores[sibling] == cores[idx])
+                    {
+                        producer_cpus[nb_producer_cpus++] = cpu;
+                        consumer_cpus[nb_consumer_cpus++] = allowed[sibling];
+                        break;
+                    }
+                }
+                break;
+            case BENCH_PLACEMENT_CORE:
+                /* alternate the cores of the first socket */
+                if (packages[idx] == packages[0])
+                {
+                    if (0 == (nb_same_package++ % 2))
+                    {
+                        producer_cpus[nb_producer_cpus++] = cpu;
+                    }
+                    else
+                    {
+                        consumer_cpus[nb_consumer_cpus++] = cpu;
+                    }
+                }
+                break;
+            case BENCH_PLACEMENT_SOCKET:
+                /* first socket against the next one found */
+                if (packages[idx] == packages[0])
+                {
+                    producer_cpus[nb_producer_cpus++] = cpu;
+                }
+                else if ((consumer_package < 0) || (packages[idx] == consumer_package))
+                {
+                    consumer_package = packages[idx];
+                    consumer_cpus[nb_consumer_cpus++] = cpu;
+                }
+                break;
+            default:
+                return false;
+        }
+    }
+
+    if ((0 == nb_producer_cpus) || (0 == nb_consumer_cpus))
+    {
+        return false;
+    }
+
+    /* more threads than CPUs: the threads share them round robin */
+    for (int i = 0; i < nb_producers; ++i)
+    {
+        cpus[i] = producer_cpus[i % nb_producer_cpus];
+    }
+    for (int i = 0; i < nb_consumers; ++i)
+    {
+        cpus[nb_producers + i] = consumer_cpus[i % nb_consumer_cpus];
+    }
+
+    return true;
+}
+
+/* bench_run result when the placement was refused by the system (no row is reported) */
+#define BENCH_RUN_NOT_PINNED (-2)
+
+static int bench_run(struct bench_context* ctxt, unsigned long long capacity, struct bench_result* result)
+{
+    const long total = ctxt->m_messages * ctxt->m_nb_producers;
+    const int nb_threads = ctxt->m_nb_producers + ctxt->m_nb_consumers;
+    struct thread_handle threads[BENCH_MAX_THREADS];
+    int cpus[BENCH_MAX_THREADS];
+    int nb_started = 0;
+    int ret = 0;
+
+    memset(result, 0, sizeof(struct bench_result));
+
+    if (!bench_placement_cpus(ctxt->m_placement, ctxt->m_nb_producers, ctxt->m_nb_consumers, cpus))
+    {
+        return -1;
+    }
+
+    if (bench_fifo_init(ctxt, capacity) < 0)
+    {
+        return -1;
+    }
+
+    ctxt->m_msgs = (struct bench_msg*)calloc((size_t)total, sizeof(struct bench_msg));
+    ctxt->m_latencies_us = (double*)calloc((size_t)total, sizeof(double));
+    if (!ctxt->m_msgs || !ctxt->m_latencies_us)
+    {
+        ret = -1;
+        goto release;
+    }
+
+    sync_atomic_store(ctxt->m_nb_latencies, 0L);
+    sync_atomic_store(ctxt->m_remaining, total);
+    sync_atomic_store(ctxt->m_dropped, 0L);
+    sync_atomic_store(ctxt->m_next_producer, 0);
+    sync_atomic_store(ctxt->m_next_consumer, 0);
+    sync_atomic_store(ctxt->m_start, false);
+
+    for (int i = 0; i < nb_threads; ++i)
+    {
+        const bool is_producer = (i < ctxt->m_nb_producers);
+        struct thread_cpu_set placement;
+
+        thread_cpu_set_clear(&placement);
+        thread_cpu_set_add(&placement, cpus[i]);
+
+        if (start_thread(&threads[i], is_producer ? bench_producer_thread : bench_consumer_thread, ctxt,
+                (BENCH_PLACEMENT_NONE == ctxt->m_placement) ? NULL : &placement) < 0)
+        {
+            /* let the started threads drain out */
+            sync_atomic_store(ctxt->m_remaining, 0L);
+            ret = (BENCH_PLACEMENT_NONE == ctxt->m_placement) ? -1 : BENCH_RUN_NOT_PINNED;
+            break;
+        }
+        ++nb_started;
+    }
+
+    struct timer_chrono timer;
+    (void)init_timer_chrono(&timer);
+    const double start_time = timer_chrono_current_time_ms(&timer);
+    sync_atomic_store_release(ctxt->m_start, true);
+
+    for (int i = 0; i < nb_started; ++i)
+    {
+        (void)join_thread(&threads[i]);
+    }
+
+    if (ret < 0)
+    {
+        goto release;
+    }
+
+    result->m_elapsed_ms = timer_chrono_current_time_ms(&timer) - start_time;
+    result->m_dropped = sync_atomic_load(ctxt->m_dropped);
+    result->m_processed = sync_atomic_load(ctxt->m_nb_latencies);
+
+    if (BENCH_ENGINE_NUMA == ctxt->m_engine)
+    {
+        result->m_steals = ring_buffer_numa_steals(&(ctxt->m_fifo.m_numa));
+        result->m_spills = ring_buffer_numa_spills(&(ctxt->m_fifo.m_numa));
+    }
+    else if ((BENCH_ENGINE_SPSC == ctxt->m_engine) && (result->m_processed > 0))
+    {
+        /* plain counters of each side, published to this thread by the joins */
+        result->m_read_reloads = (double)ctxt->m_fifo.m_spsc.m_read_idx_reloads / (double)result->m_processed;
+        result->m_write_reloads = (double)ctxt->m_fifo.m_spsc.m_write_idx_reloads / (double)result->m_processed;
+    }
+    else if (BENCH_ENGINE_MPMC == ctxt->m_engine)
+    {
+        ring_buffer_mpmc_stats_snapshot(&(ctxt->m_fifo.m_mpmc), &(result->m_stats));
+    }
+
+    qsort(ctxt->m_latencies_us, (size_t)result->m_processed, sizeof(double), bench_compare_double);
+    result->m_p50_us = bench_percentile(ctxt->m_latencies_us, result->m_processed, 50.0);
+    result->m_p90_us = bench_percentile(ctxt->m_latencies_us, result->m_processed, 90.0);
+    result->m_p99_us = bench_percentile(ctxt->m_latencies_us, result->m_processed, 99.0);
+    result->m_p999_us = bench_percentile(ctxt->m_latencies_us, result->m_processed, 99.9);
+    result->m_max_us = (result->m_processed > 0) ? ctxt->m_latencies_us[result->m_processed - 1] : 0.0;
+
+release:
+    free(ctxt->m_latencies_us);
+    free(ctxt->m_msgs);
+    ctxt->m_latencies_us = NULL;
+    ctxt->m_msgs = NULL;
+    bench_fifo_deinit(ctxt);
+
+    return ret;
+}
+
+static bool bench_is_supported(enum bench_engine engine, enum bench_mode mode, int nb_producers, int nb_consumers)
+{
+    if ((BENCH_ENGINE_SPSC == engine) && ((1 != nb_producers) || (1 != nb_consumers)))
+    {
+        return false;
+    }
+
+    if ((BENCH_MODE_BLOCK == mode) && (BENCH_ENGINE_MPMC != engine))
+    {
+        return false;
+    }
+
+    if ((BENCH_ENGINE_PIPELINE == engine) && (nb_consumers > RING_BUFFER_BROADCAST_MAX_CONSUMERS))
+    {
+        return false;
+    }
+
+    return (nb_producers > 0) && (nb_consumers > 0) && ((nb_producers + nb_consumers) <= BENCH_MAX_THREADS);
+}
+
+/* columns only present in some builds, appended to the header (result NULL) or to a row */
+static void bench_print_extra(enum bench_format format, const struct bench_result* result)
+{
+#if RING_BUFFER_MPMC_STATS
+    /* text: the main counters (spins and lock waits of both sides summed), csv/json: every counter */
+    if (BENCH_FORMAT_TEXT == format)
+    {
+        if (!result)
+        {
+            printf(" %10s %10s %10s %10s", "push_full", "pop_empty", "spins", "lock_waits");
+        }
+        else
+        {
+            const unsigned long long* counters = result->m_stats.m_counters;
+            printf(" %10llu %10llu %10llu %10llu", counters[RING_BUFFER_STAT_PUSH_FULL], counters[RING_BUFFER_STAT_POP_EMPTY],
+                counters[RING_BUFFER_STAT_WRITE_SPINS] + counters[RING_BUFFER_STAT_READ_SPINS],
+                counters[RING_BUFFER_STAT_WRITE_LOCK_WAITS] + counters[RING_BUFFER_STAT_READ_LOCK_WAITS]);
+        }
+        return;
+    }
+
+    for (int stat = 0; stat < RING_BUFFER_STAT_COUNT; ++stat)
+    {
+        const char* name = ring_buffer_mpmc_stat_name((enum ring_buffer_mpmc_stat)stat);
+
+        if (!result)
+        {
+            if (BENCH_FORMAT_CSV == format)
+            {
+                printf(",%s", name);
+            }
+        }
+        else if (BENCH_FORMAT_CSV == format)
+        {
+            printf(",%llu", result->m_stats.m_counters[stat]);
+        }
+        else
+        {
+            printf(", \"%s\": %llu", name, result->m_stats.m_counters[stat]);
+        }
+    }
+#else
+    (void)format;
+    (void)result;
+#endif
+}
+
+static void bench_print_header(enum bench_format format)
+{
+    switch (format)
+    {
+        case BENCH_FORMAT_CSV:
+            printf("engine,mode,placement,layout,producers,consumers,capacity,work,run,messages,processed,dropped,drop_rate,elapsed_ms,ops_per_s,"
+                   "p50_us,p90_us,p99_us,p999_us,max_us,steals,spills,read_reloads_per_msg,write_reloads_per_msg");
+            bench_print_extra(format, NULL);
+            printf("\n");
+            break;
+        case BENCH_FORMAT_JSON:
+            printf("[\n");
+            break;
+        default:
+            printf("%-9s %-6s %-5s %-7s %4s %4s %9s %6s %12s %9s %13s %9s %9s %9s %9s %10s %9s %9s %9s %9s", "engine", "mode", "place", "layout", "prod", "cons", "capacity",
+                "work", "messages", "drop%", "ops/s", "p50_us", "p90_us", "p99_us", "p99.9_us", "max_us", "steals", "spills", "rd_rld/m", "wr_rld/m");
+            bench_print_extra(format, NULL);
+            printf("\n");
+            break;
+    }
+}
+
+static void bench_print_result(const struct bench_options* options, const struct bench_context* ctxt, int run,
+    const struct bench_result* result, bool first)
+{
+    const long total = ctxt->m_messages * ctxt->m_nb_producers;
+    const double drop_rate = (total > 0) ? (double)result->m_dropped / (double)total : 0.0;
+    const double ops_per_s = (result->m_elapsed_ms > 0.0) ? (double)result->m_processed * 1000.0 / result->m_elapsed_ms : 0.0;
+
+    switch (options->m_format)
+    {
+        case BENCH_FORMAT_CSV:
+            printf("%s,%s,%s,%s,%d,%d,%llu,%d,%d,%ld,%ld,%ld,%.6f,%.3f,%.0f,%.3f,%.3f,%.3f,%.3f,%.3f,%lld,%lld,%.6f,%.6f", st_engine_names[ctxt->m_engine],
+                st_mode_names[ctxt->m_mode], st_placement_names[ctxt->m_placement], BENCH_LAYOUT, ctxt->m_nb_producers, ctxt->m_nb_consumers, options->m_capacity, ctxt->m_work, run, total,
+                result->m_processed, result->m_dropped, drop_rate, result->m_elapsed_ms, ops_per_s, result->m_p50_us, result->m_p90_us,
+                result->m_p99_us, result->m_p999_us, result->m_max_us, result->m_steals, result->m_spills, result->m_read_reloads,
+                result->m_write_reloads);
+            bench_print_extra(options->m_format, result);
+            printf("\n");
+            break;
+        case BENCH_FORMAT_JSON:
+            printf("%s  {\"engine\": \"%s\", \"mode\": \"%s\", \"placement\": \"%s\", \"layout\": \"%s\", \"producers\": %d, \"consumers\": %d, \"capacity\": %llu, \"work\": %d, "
+                   "\"run\": %d, \"messages\": %ld, \"processed\": %ld, \"dropped\": %ld, \"drop_rate\": %.6f, \"elapsed_ms\": %.3f, "
+                   "\"ops_per_s\": %.0f, \"latency_us\": {\"p50\": %.3f, \"p90\": %.3f, \"p99\": %.3f, \"p999\": %.3f, \"max\": %.3f}, "
+                   "\"steals\": %lld, \"spills\": %lld, \"read_reloads_per_msg\": %.6f, \"write_reloads_per_msg\": %.6f",
+                first ? "" : ",\n", st_engine_names[ctxt->m_engine], st_mode_names[ctxt->m_mode], st_placement_names[ctxt->m_placement], BENCH_LAYOUT,
+                ctxt->m_nb_producers,
+                ctxt->m_nb_consumers, options->m_capacity, ctxt->m_work, run, total, result->m_processed, result->m_dropped, drop_rate,
+                result->m_elapsed_ms, ops_per_s, result->m_p50_us, result->m_p90_us, result->m_p99_us, result->m_p999_us,
+                result->m_max_us, result->m_steals, result->m_spills, result->m_read_reloads, result->m_write_reloads);
+            bench_print_extra(options->m_format, result);
+            printf("}");
+            break;
+        default:
+            printf("%-9s %-6s %-5s %-7s %4d %4d %9llu %6d %12ld %9.3f %13.0f %9.3f %9.3f %9.3f %9.3f %10.3f %9lld %9lld %9.3f %9.3f", st_engine_names[ctxt->m_engine],
+                st_mode_names[ctxt->m_mode], st_placement_names[ctxt->m_placement], BENCH_LAYOUT, ctxt->m_nb_producers, ctxt->m_nb_consumers, options->m_capacity, ctxt->m_work, total,
+                drop_rate * 100.0, ops_per_s, result->m_p50_us, result->m_p90_us, result->m_p99_us, result->m_p999_us, result->m_max_us,
+                result->m_steals, result->m_spills, result->m_read_reloads, result->m_write_reloads);
+            bench_print_extra(options->m_format, result);
+            printf("\n");
+            break;
+    }
+}
+
+static void bench_usage(const char* program)
+{
+    fprintf(stderr,
+        "usage: %s [options]\n"
+        "  --engine LIST       mpmc,lf,spsc,inline,segmented,sharded,numa,pipeline,\n"
+        "                      priority,weighted (default mpmc)\n"
+        "  --mode LIST         drop,retry,block (default drop)\n"
+        "  --placement LIST    none,smt,core,cross (default none): threads left to the scheduler, producer and\n"
+        "                      consumer on SMT siblings, on different cores of a socket, on different sockets\n"
+        "  --producers LIST    number of producers (default 4)\n"
+        "  --consumers LIST    number of consumers (default 8)\n"
+        "  --messages N        messages per producer (default 100000)\n"
+        "  --capacity N        ring capacity, power of two (default %llu)\n"
+        "                      entries per segment for the segmented engine, per lane for sharded, per node for numa,\n"
+        "                      per class for priority/weighted (%d classes, messages spread round-robin)\n"
+        "  --work N            simulated work loop iterations per message (default 0)\n"
+        "  --repeat N          runs per scenario (default 1)\n"
+        "  --format FMT        text, csv or json (default text)\n"
+        "  --header N          0: no header line for text/csv, to append the rows of cringbuffer_bench_packed\n"
+        "                      (packed ring layout, see the layout column) to the ones of cringbuffer_bench\n"
+        "LIST is a comma separated list, every combination is run (spsc only with 1 producer\n"
+        "and 1 consumer, block only with the mpmc engine, pipeline up to %d consumers, each one\n"
+        "a stage seeing every message after the previous stage)\n",
+        program, (unsigned long long)RING_BUFFER_SIZE, BENCH_PRIORITY_CLASSES, RING_BUFFER_BROADCAST_MAX_CONSUMERS);
+}
+
+static int bench_lookup(const char* name, const char* const* names, int count)
+{
+    for (int i = 0; i < count; ++i)
+    {
+        if (0 == strcmp(name, names[i]))
+        {
+            return i;
+        }
+    }
+
+    return -1;
+}
+
+/* parse a comma separated list of names (if names is not NULL) or positive integers */
+static int bench_parse_list(const char* arg, const char* const* names, int nb_names, int* values)
+{
+    char buffer[256];
+    int count = 0;
+
+    strncpy(buffer, arg, sizeof(buffer) - 1);
+    buffer[sizeof(buffer) - 1] = '\0';
+
+    for (char* token = strtok(buffer, ","); token && (count < BENCH_MAX_LIST); token = strtok(NULL, ","))
+    {
+        const int value = names ? bench_lookup(token, names, nb_names) : atoi(token);
+        if ((value < 0) || (!names && (0 == value)))
+        {
+            fprintf(stderr, "invalid value '%s'\n", token);
+            return -1;
+        }
+        values[count++] = value;
+    }
+
+    return count;
+}
+
+static int bench_parse_options(int argc, char* argv[], struct bench_options* options)
+{
+    memset(options, 0, sizeof(struct bench_options));
+    options->m_engines[0] = BENCH_ENGINE_MPMC;
+    options->m_nb_engines = 1;
+    options->m_modes[0] = BENCH_MODE_DROP;
+    options->m_nb_modes = 1;
+    options->m_placements[0] = BENCH_PLACEMENT_NONE;
+    options->m_nb_placements = 1;
+    options->m_producers[0] = 4;
+    options->m_nb_producers = 1;
+    options->m_consumers[0] = 8;
+    options->m_nb_consumers = 1;
+    options->m_messages = 100000;
+    options->m_capacity = RING_BUFFER_SIZE;
+    options->m_work = 0;
+    options->m_repeat = 1;
+    options->m_format = BENCH_FORMAT_TEXT;
+    options->m_header = true;
+
+    for (int i = 1; i < argc; ++i)
+    {
+        const char* option = argv[i];
+        const char* value = (i + 1 < argc) ? argv[i + 1] : NULL;
+
+        if ((0 == strcmp(option, "--help")) || (0 == strcmp(option, "-h")))
+        {
+            return -1;
+        }
+
+        if (!value)
+        {
+            fprintf(stderr, "missing value for %s\n", option);
+            return -1;
+        }
+        ++i;
+
+        if (0 == strcmp(option, "--engine"))
+        {
+            options->m_nb_engines = bench_parse_list(value, st_engine_names, BENCH_ENGINE_COUNT, options->m_engines);
+        }
+        else if (0 == strcmp(option, "--mode"))
+        {
+            options->m_nb_modes = bench_parse_list(value, st_mode_names, BENCH_MODE_COUNT, options->m_modes);
+        }
+        else if (0 == strcmp(option, "--placement"))
+        {
+            options->m_nb_placements = bench_parse_list(value, st_placement_names, BENCH_PLACEMENT_COUNT, options->m_placements);
+        }
+        else if (0 == strcmp(option, "--producers"))
+        {
+            options->m_nb_producers = bench_parse_list(value, NULL, 0, options->m_producers);
+        }
+        else if (0 == strcmp(option, "--consumers"))
+        {
+            options->m_nb_consumers = bench_parse_list(value, NULL, 0, options->m_consumers);
+        }
+        else if (0 == strcmp(option, "--messages"))
+        {
+            options->m_messages = atol(value);
+        }
+        else if (0 == strcmp(option, "--capacity"))
+        {
+            options->m_capacity = strtoull(value, NULL, 10);
+        }
+        else if (0 == strcmp(option, "--work"))
+        {
+            options->m_work = atoi(value);
+        }
+        else if (0 == strcmp(option, "--repeat"))
+        {
+            options->m_repeat = atoi(value);
+        }
+        else if (0 == strcmp(option, "--format"))
+        {
+            static const char* const formats[] = { "text", "csv", "json" };
+            const int format = bench_lookup(value, formats, 3);
+            if (format < 0)
+            {
+                fprintf(stderr, "invalid format '%s'\n", value);
+                return -1;
+            }
+            options->m_format = (enum bench_format)format;
+        }
+        else if (0 == strcmp(option, "--header"))
+        {
+            options->m_header = (0 != atoi(value));
+        }
+        else
+        {
+            fprintf(stderr, "unknown option %s\n", option);
+            return -1;
+        }
+    }
+
+    if ((options->m_nb_engines <= 0) || (options->m_nb_modes <= 0) || (options->m_nb_placements <= 0) || (options->m_nb_producers <= 0) || (options->m_nb_consumers <= 0)
+        || (options->m_messages <= 0) || (options->m_repeat <= 0) || (options->m_work < 0))
+    {
+        return -1;
+    }
+
+    return 0;
+}
+
+int main(int argc, char* argv[])
+{
+    struct bench_options options;
+
+    if (bench_parse_options(argc, argv, &options) < 0)
+    {
+        bench_usage(argv[0]);
+        return -1;
+    }
+
+    /* the ring buffers are too large for the stack */
+    struct bench_context* ctxt = (struct bench_context*)mem_alloc_aligned(sizeof(struct bench_context), CACHE_LINE_SIZE);
+    if (!ctxt)
+    {
+        return -1;
+    }
+    memset(ctxt, 0, sizeof(struct bench_context));
+
+    int exit_code = 0;
+    bool first = true;
+
+    /* messages are stamped with the time stamp counter */
+    (void)timer_chrono_calibrate();
+
+    if (options.m_header || (BENCH_FORMAT_JSON == options.m_format))
+    {
+        bench_print_header(options.m_format);
+    }
+
+    for (int e = 0; e < options.m_nb_engines; ++e)
+    {
+        for (int m = 0; m < options.m_nb_modes; ++m)
+        {
+            for (int p = 0; p < options.m_nb_producers; ++p)
+            {
+                for (int c = 0; c < options.m_nb_consumers; ++c)
+                {
+                    ctxt->m_engine = (enum bench_engine)options.m_engines[e];
+                    ctxt->m_mode = (enum bench_mode)options.m_modes[m];
+                    ctxt->m_nb_producers = options.m_producers[p];
+                    ctxt->m_nb_consumers = options.m_consumers[c];
+                    ctxt->m_messages = options.m_messages;
+                    ctxt->m_work = options.m_work;
+
+                    if (!bench_is_supported(ctxt->m_engine, ctxt->m_mode, ctxt->m_nb_producers, ctxt->m_nb_consumers))
+                    {
+                        fprintf(stderr, "skip unsupported scenario %s/%s with %d producers and %d consumers\n",
+                            st_engine_names[ctxt->m_engine], st_mode_names[ctxt->m_mode], ctxt->m_nb_producers, ctxt->m_nb_consumers);
+                        continue;
+                    }
+
+                    for (int l = 0; l < options.m_nb_placements; ++l)
+                    {
+                        int cpus[BENCH_MAX_THREADS];
+                        ctxt->m_placement = (enum bench_placement)options.m_placements[l];
+
+                        if (!bench_placement_cpus(ctxt->m_placement, ctxt->m_nb_producers, ctxt->m_nb_consumers, cpus))
+                        {
+                            fprintf(stderr, "skip placement %s, not available on this machine\n", st_placement_names[ctxt->m_placement]);
+                            continue;
+                        }
+
+                        for (int run = 0; run < options.m_repeat; ++run)
+                        {
+                            struct bench_result result;
+
+                            const int ret = bench_run(ctxt, options.m_capacity, &result);
+
+                            if (BENCH_RUN_NOT_PINNED == ret)
+                            {
+                                fprintf(stderr, "skip placement %s, the threads could not be pinned\n", st_placement_names[ctxt->m_placement]);
+                                break;
+                            }
+                            if (ret < 0)
+                            {
+                                fprintf(stderr, "scenario %s/%s failed\n", st_engine_names[ctxt->m_engine], st_mode_names[ctxt->m_mode]);
+                                exit_code = -1;
+                                continue;
+                            }
+
+                            bench_print_result(&options, ctxt, run, &result, first);
+                            first = false;
+                        }
+                    }
+                }
+            }
+        }
+    }
+
+    if (BENCH_FORMAT_JSON == options.m_format)
+    {
+        printf("\n]\n");
+    }
+
+    mem_free_aligned(ctxt);
+
+    return exit_code;
+}
@@ -0,0 +1,636 @@
+//-----------------------------------------------------------------------------//
+// CRingBuffer MPMC - FIFO helper                                              //
+// (c) 2023 Laurent Lardinois https://be.linkedin.com/in/laurentlardinois      //
+//                                                                             //
+// https://github.com/type-one/CRingBuffer_MPSC                                //
+//                                                                             //
+// This software is provided 'as-is', without any express or implied           //
+// warranty.In no event will the authors be held liable for any damages        //
+// arising from the use of this software.                                      //
+//                                                                             //
+// Permission is granted to anyone to use this software for any purpose,       //
+// including commercial applications, and to alter itand redistribute it       //
+// freely, subject to the following restrictions :                             //
+//                                                                             //
+// 1. The origin of this software must not be misrepresented; you must not     //
+// claim that you wrote the original software.If you use this software         //
+// in a product, an acknowledgment in the product documentation would be       //
+// appreciated but is not required.                                            //
+// 2. Altered source versions must be plainly marked as such, and must not be  //
+// misrepresented as being the original software.                              //
+// 3. This notice may not be removed or altered from any source distribution.  //
+//-----------------------------------------------------------------------------//
+
+/* fork/join benchmark: every task of a binary tree spawns its two children until the leaves,
+   the tasks are either shared by all the workers through a single ring_buffer_mpmc or kept in a
+   work-stealing deque per worker (idle workers steal from a random victim) */
+
+#include "tools/atomic_helper.h"
+#include "tools/job_scheduler.h"
+#include "tools/mem_alloc.h"
+#include "tools/ring_buffer_mpmc.h"
+#include "tools/thread_helper.h"
+#include "tools/timer_chrono.h"
+#include "tools/work_stealing_deque.h"
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#if defined(_WIN32)
+#include <windows.h>
+#elif defined(__STDC_NO_THREADS__)
+#include <pthread.h>
+#include <sched.h>
+#else
+#include <threads.h>
+#endif
+
+#define FJ_MAX_LIST 16
+#define FJ_MAX_WORKERS 256
+#define FJ_MAX_DEPTH 30
+#define FJ_AUTO_CAPACITY_MAX (1ULL << 22) /* bound of the shared queue sized to the tree */
+#define FJ_INLINED_WARNING 0.10           /* share of inlined tasks above which the queue comparison is skewed */
+
+enum fj_queue
+{
+    FJ_QUEUE_SHARED,   /* one ring_buffer_mpmc for all the workers */
+    FJ_QUEUE_STEALING,  /* one work_stealing_deque per worker */
+    FJ_QUEUE_SCHEDULER, /* child jobs of a job_scheduler, waited on with job_scheduler_wait */
+    FJ_QUEUE_COUNT
+};
+
+static const char* const st_queue_names[FJ_QUEUE_COUNT] = { "shared", "stealing", "scheduler" };
+
+struct fj_options
+{
+    int m_queues[FJ_MAX_LIST];
+    int m_nb_queues;
+    int m_workers[FJ_MAX_LIST];
+    int m_nb_workers;
+    int m_depth;
+    int m_work;
+    int m_repeat;
+    unsigned long long m_capacity; /* 0: shared queues sized to the tree, deques of RING_BUFFER_SIZE */
+    bool m_csv;
+};
+
+struct fj_context;
+
+struct fj_worker
+{
+    RING_BUFFER_ALIGNED struct work_stealing_deque m_deque;
+    struct fj_context* m_ctxt;
+    int m_id;
+    unsigned int m_seed;
+    unsigned long long m_steals;
+    unsigned long long m_failed_steals;
+    unsigned long long m_inlined; /* children run in place because the queue was full */
+};
+
+struct fj_context
+{
+    enum fj_queue m_queue;
+    int m_nb_workers;
+    int m_work;
+    struct ring_buffer_mpmc m_shared;
+    struct job_scheduler m_scheduler;
+    struct fj_worker* m_workers;
+    RING_BUFFER_ALIGNED _atomic_llong m_remaining; /* tasks not yet executed */
+    _atomic_bool m_start;
+};
+
+struct fj_result
+{
+    unsigned long long m_capacity;
+    double m_elapsed_ms;
+    long long m_tasks;
+    unsigned long long m_steals;
+    unsigned long long m_failed_steals;
+    unsigned long long m_inlined;
+};
+
+static void fj_yield(void)
+{
+#if defined(_WIN32)
+    Sleep(0);
+#elif defined(__STDC_NO_THREADS__)
+    sched_yield();
+#else
+    thrd_yield();
+#endif
+}
+
+/* a task is its remaining depth + 1, so that it is never a NULL pointer */
+static void* fj_make_task(int depth)
+{
+    return (void*)(uintptr_t)(depth + 1);
+}
+
+static int fj_task_depth(void* task)
+{
+    return (int)((uintptr_t)task - 1U);
+}
+
+static unsigned int fj_random(struct fj_worker* worker)
+{
+    /* xorshift32 */
+    unsigned int x = worker->m_seed;
+    x ^= x << 13;
+    x ^= x >> 17;
+    x ^= x << 5;
+    worker->m_seed = x;
+    return x;
+}
+
+static bool fj_push(struct fj_worker* worker, void* task)
+{
+    struct fj_context* ctxt = worker->m_ctxt;
+
+    if (FJ_QUEUE_SHARED == ctxt->m_queue)
+    {
+        return ring_buffer_push_mp(&(ctxt->m_shared), task);
+    }
+
+    return work_stealing_deque_push(&(worker->m_deque), task);
+}
+
+static bool fj_next_task(struct fj_worker* worker, void** task)
+{
+    struct fj_context* ctxt = worker->m_ctxt;
+
+    if (FJ_QUEUE_SHARED == ctxt->m_queue)
+    {
+        return ring_buffer_pop_mc(&(ctxt->m_shared), task);
+    }
+
+    if (work_stealing_deque_pop(&(worker->m_deque), task))
+    {
+        return true;
+    }
+
+    /* own deque empty, try a few random victims */
+    for (int attempt = 1; attempt < ctxt->m_nb_workers; ++attempt)
+    {
+        struct fj_worker* victim = &(ctxt->m_workers[fj_random(worker) % (unsigned int)ctxt->m_nb_workers]);
+
+        if ((victim == worker) || work_stealing_deque_is_empty(&(victim->m_deque)))
+        {
+            continue;
+        }
+
+        if (work_stealing_deque_steal(&(victim->m_deque), task))
+        {
+            ++worker->m_steals;
+            return true;
+        }
+
+        ++worker->m_failed_steals;
+    }
+
+    return false;
+}
+
+static void fj_execute(struct fj_worker* worker, int depth)
+{
+    struct fj_context* ctxt = worker->m_ctxt;
+
+    /* simulate some processing */
+    for (volatile int i = 0; i < ctxt->m_work; ++i)
+    {
+    }
+
+    if (depth > 0)
+    {
+        for (int child = 0; child < 2; ++child)
+        {
+            if (!fj_push(worker, fj_make_task(depth - 1)))
+            {
+                ++worker->m_inlined;
+                fj_execute(worker, depth - 1);
+            }
+        }
+    }
+
+    (void)sync_atomic_add_64(ctxt->m_remaining, -1LL);
+}
+
+static void fj_worker_thread(void* arg)
+{
+    struct fj_worker* worker = (struct fj_worker*)arg;
+    struct fj_context* ctxt = worker->m_ctxt;
+
+    while (!sync_atomic_load_acquire(ctxt->m_start))
+    {
+        fj_yield();
+    }
+
+    while (sync_atomic_load(ctxt->m_remaining) > 0)
+    {
+        void* task = NULL;
+
+        if (!fj_next_task(worker, &task))
+        {
+            fj_yield();
+            continue;
+        }
+
+        fj_execute(worker, fj_task_depth(task));
+    }
+}
+
+/* a full shared queue makes the producer run the child in place, so unless asked otherwise the shared
+   queues hold the whole tree and the run compares push_mp/pop_mc against the deques; a deque only holds
+   the pending siblings along the path of its worker */
+static unsigned long long fj_capacity(const struct fj_options* options, enum fj_queue queue, long long tasks)
+{
+    if (options->m_capacity > 0ULL)
+    {
+        return options->m_capacity;
+    }
+
+    if (FJ_QUEUE_STEALING == queue)
+    {
+        return RING_BUFFER_SIZE;
+    }
+
+    unsigned long long capacity = 2ULL;
+    while ((capacity < (unsigned long long)tasks) && (capacity < FJ_AUTO_CAPACITY_MAX))
+    {
+        capacity <<= 1;
+    }
+
+    return capacity;
+}
+
+static void fj_job(struct job_scheduler* scheduler, void* task)
+{
+    struct fj_context* ctxt = (struct fj_context*)((char*)scheduler - offsetof(struct fj_context, m_scheduler));
+    const int depth = fj_task_depth(task);
+
+    /* simulate some processing */
+    for (volatile int i = 0; i < ctxt->m_work; ++i)
+    {
+    }
+
+    if (depth > 0)
+    {
+        /* children are accounted on the counter of this job, the scheduler runs them in place when full */
+        (void)job_scheduler_submit_child(scheduler, fj_job, fj_make_task(depth - 1));
+        (void)job_scheduler_submit_child(scheduler, fj_job, fj_make_task(depth - 1));
+    }
+
+    (void)sync_atomic_add_64(ctxt->m_remaining, -1LL);
+}
+
+/* the calling thread helps in job_scheduler_wait, so it stands for one of the workers */
+static int fj_run_scheduler(struct fj_context* ctxt, const struct fj_options* options, struct fj_result* result)
+{
+    const int nb_threads = (ctxt->m_nb_workers > 1) ? ctxt->m_nb_workers - 1 : 1;
+
+    if ((nb_threads > JOB_SCHEDULER_MAX_WORKERS) || (init_job_scheduler_ex(&(ctxt->m_scheduler), nb_threads, result->m_capacity) < 0))
+    {
+        return -1;
+    }
+
+    struct job_counter counter;
+    init_job_counter(&counter);
+    sync_atomic_store(ctxt->m_remaining, result->m_tasks);
+
+    struct timer_chrono timer;
+    (void)init_timer_chrono(&timer);
+    const double start_time = timer_chrono_current_time_ms(&timer);
+
+    (void)job_scheduler_submit(&(ctxt->m_scheduler), fj_job, fj_make_task(options->m_depth), &counter);
+    job_scheduler_wait(&(ctxt->m_scheduler), &counter);
+
+    result->m_elapsed_ms = timer_chrono_current_time_ms(&timer) - start_time;
+
+    (void)deinit_job_scheduler(&(ctxt->m_scheduler));
+
+    /* every task of the tree must have run once the counter is back to zero */
+    return (0LL == sync_atomic_load(ctxt->m_remaining)) ? 0 : -1;
+}
+
+static int fj_run(struct fj_context* ctxt, const struct fj_options* options, struct fj_result* result)
+{
+    struct thread_handle threads[FJ_MAX_WORKERS];
+    int nb_started = 0;
+    int nb_deques = 0;
+    int ret = 0;
+
+    memset(result, 0, sizeof(struct fj_result));
+    result->m_tasks = (1LL << (options->m_depth + 1)) - 1LL;
+    result->m_capacity = fj_capacity(options, ctxt->m_queue, result->m_tasks);
+
+    if (FJ_QUEUE_SCHEDULER == ctxt->m_queue)
+    {
+        return fj_run_scheduler(ctxt, options, result);
+    }
+
+    if (init_ring_buffer_mpmc_ex(&(ctxt->m_shared), result->m_capacity, NULL) < 0)
+    {
+        return -1;
+    }
+
+    for (; nb_deques < ctxt->m_nb_workers; ++nb_deques)
+    {
+        struct fj_worker* worker = &(ctxt->m_workers[nb_deques]);
+
+        if (init_work_stealing_deque_ex(&(worker->m_deque), result->m_capacity, NULL) < 0)
+        {
+            ret = -1;
+            goto release;
+        }
+
+        worker->m_ctxt = ctxt;
+        worker->m_id = nb_deques;
+        worker->m_seed = 2463534242U + 97U * (unsigned int)nb_deques;
+        worker->m_steals = 0ULL;
+        worker->m_failed_steals = 0ULL;
+        worker->m_inlined = 0ULL;
+    }
+
+    sync_atomic_store(ctxt->m_remaining, result->m_tasks);
+    sync_atomic_store(ctxt->m_start, false);
+
+    /* the root task, the other workers start by stealing */
+    (void)fj_push(&(ctxt->m_workers[0]), fj_make_task(options->m_depth));
+
+    for (int i = 0; i < ctxt->m_nb_workers; ++i)
+    {
+        if (start_thread(&threads[i], fj_worker_thread, &(ctxt->m_workers[i]), NULL) < 0)
+        {
+            ret = -1;
+            break;
+        }
+        ++nb_started;
+    }
+
+    if (nb_started < ctxt->m_nb_workers)
+    {
+        /* let the started threads drain out */
+        sync_atomic_store(ctxt->m_remaining, 0LL);
+    }
+
+    struct timer_chrono timer;
+    (void)init_timer_chrono(&timer);
+    const double start_time = timer_chrono_current_time_ms(&timer);
+    sync_atomic_store_release(ctxt->m_start, true);
+
+    for (int i = 0; i < nb_started; ++i)
+    {
+        (void)join_thread(&threads[i]);
+    }
+
+    result->m_elapsed_ms = timer_chrono_current_time_ms(&timer) - start_time;
+
+    for (int i = 0; i < ctxt->m_nb_workers; ++i)
+    {
+        result->m_steals += ctxt->m_workers[i].m_steals;
+        result->m_failed_steals += ctxt->m_workers[i].m_failed_steals;
+        result->m_inlined += ctxt->m_workers[i].m_inlined;
+    }
+
+release:
+    for (int i = 0; i < nb_deques; ++i)
+    {
+        (void)deinit_work_stealing_deque(&(ctxt->m_workers[i].m_deque));
+    }
+    (void)deinit_ring_buffer_mpmc(&(ctxt->m_shared));
+
+    return ret;
+}
+
+static void fj_print_header(const struct fj_options* options)
+{
+    if (options->m_csv)
+    {
+        printf("queue,workers,depth,work,capacity,run,tasks,elapsed_ms,tasks_per_s,steals,failed_steals,inlined\n");
+    }
+    else
+    {
+        printf("%-9s %7s %5s %6s %9s %10s %11s %13s %10s %13s %9s\n", "queue", "workers", "depth", "work", "capacity", "tasks",
+            "elapsed_ms", "tasks/s", "steals", "failed_steals", "inlined");
+    }
+}
+
+static void fj_print_result(const struct fj_options* options, const struct fj_context* ctxt, int run, const struct fj_result* result)
+{
+    const double tasks_per_s = (result->m_elapsed_ms > 0.0) ? (double)result->m_tasks * 1000.0 / result->m_elapsed_ms : 0.0;
+
+    if (options->m_csv)
+    {
+        printf("%s,%d,%d,%d,%llu,%d,%lld,%.3f,%.0f,%llu,%llu,%llu\n", st_queue_names[ctxt->m_queue], ctxt->m_nb_workers, options->m_depth,
+            options->m_work, result->m_capacity, run, result->m_tasks, result->m_elapsed_ms, tasks_per_s, result->m_steals, result->m_failed_steals,
+            result->m_inlined);
+    }
+    else
+    {
+        printf("%-9s %7d %5d %6d %9llu %10lld %11.3f %13.0f %10llu %13llu %9llu\n", st_queue_names[ctxt->m_queue], ctxt->m_nb_workers,
+            options->m_depth, options->m_work, result->m_capacity, result->m_tasks, result->m_elapsed_ms, tasks_per_s, result->m_steals,
+            result->m_failed_steals, result->m_inlined);
+    }
+}
+
+static void fj_usage(const char* program)
+{
+    fprintf(stderr,
+        "usage: %s [options]\n"
+        "  --queue LIST        shared,stealing,scheduler (default shared,stealing,scheduler)\n"
+        "  --workers LIST      number of workers (default 4)\n"
+        "  --depth N           depth of the task tree, 2^(N+1)-1 tasks (default 16)\n"
+        "  --work N            simulated work loop iterations per task (default 0)\n"
+        "  --capacity N        ring/deque capacity, power of two (default: shared queues sized to the tree\n"
+        "                      up to %llu, deques of %llu)\n"
+        "  --repeat N          runs per scenario (default 1)\n"
+        "  --format FMT        text or csv (default text)\n"
+        "LIST is a comma separated list, every combination is run\n",
+        program, FJ_AUTO_CAPACITY_MAX, (unsigned long long)RING_BUFFER_SIZE);
+}
+
+/* parse a comma separated list of names (if names is not NULL) or positive integers */
+static int fj_parse_list(const char* arg, const char* const* names, int nb_names, int* values)
+{
+    char buffer[256];
+    int count = 0;
+
+    strncpy(buffer, arg, sizeof(buffer) - 1);
+    buffer[sizeof(buffer) - 1] = '\0';
+
+    for (char* token = strtok(buffer, ","); token && (count < FJ_MAX_LIST); token = strtok(NULL, ","))
+    {
+        int value = -1;
+
+        if (names)
+        {
+            for (int i = 0; i < nb_names; ++i)
+            {
+                if (0 == strcmp(token, names[i]))
+                {
+                    value = i;
+                }
+            }
+        }
+        else
+        {
+            value = atoi(token);
+        }
+
+        if ((value < 0) || (!names && ((0 == value) || (value > FJ_MAX_WORKERS))))
+        {
+            fprintf(stderr, "invalid value '%s'\n", token);
+            return -1;
+        }
+        values[count++] = value;
+    }
+
+    return count;
+}
+
+static int fj_parse_options(int argc, char* argv[], struct fj_options* options)
+{
+    memset(options, 0, sizeof(struct fj_options));
+    options->m_queues[0] = FJ_QUEUE_SHARED;
+    options->m_queues[1] = FJ_QUEUE_STEALING;
+    options->m_queues[2] = FJ_QUEUE_SCHEDULER;
+    options->m_nb_queues = 3;
+    options->m_workers[0] = 4;
+    options->m_nb_workers = 1;
+    options->m_depth = 16;
+    options->m_work = 0;
+    options->m_repeat = 1;
+    options->m_capacity = 0ULL;
+    options->m_csv = false;
+
+    for (int i = 1; i < argc; ++i)
+    {
+        const char* option = argv[i];
+        const char* value = (i + 1 < argc) ? argv[i + 1] : NULL;
+
+        if ((0 == strcmp(option, "--help")) || (0 == strcmp(option, "-h")))
+        {
+            return -1;
+        }
+
+        if (!value)
+        {
+            fprintf(stderr, "missing value for %s\n", option);
+            return -1;
+        }
+        ++i;
+
+        if (0 == strcmp(option, "--queue"))
+        {
+            options->m_nb_queues = fj_parse_list(value, st_queue_names, FJ_QUEUE_COUNT, options->m_queues);
+        }
+        else if (0 == strcmp(option, "--workers"))
+        {
+            options->m_nb_workers = fj_parse_list(value, NULL, 0, options->m_workers);
+        }
+        else if (0 == strcmp(option, "--depth"))
+        {
+            options->m_depth = atoi(value);
+        }
+        else if (0 == strcmp(option, "--work"))
+        {
+            options->m_work = atoi(value);
+        }
+        else if (0 == strcmp(option, "--capacity"))
+        {
+            options->m_capacity = strtoull(value, NULL, 10);
+        }
+        else if (0 == strcmp(option, "--repeat"))
+        {
+            options->m_repeat = atoi(value);
+        }
+        else if (0 == strcmp(option, "--format"))
+        {
+            if ((0 != strcmp(value, "text")) && (0 != strcmp(value, "csv")))
+            {
+                fprintf(stderr, "invalid format '%s'\n", value);
+                return -1;
+            }
+            options->m_csv = (0 == strcmp(value, "csv"));
+        }
+        else
+        {
+            fprintf(stderr, "unknown option %s\n", option);
+            return -1;
+        }
+    }
+
+    if ((options->m_nb_queues <= 0) || (options->m_nb_workers <= 0) || (options->m_depth < 0) || (options->m_depth > FJ_MAX_DEPTH)
+        || (options->m_repeat <= 0) || (options->m_work < 0))
+    {
+        return -1;
+    }
+
+    return 0;
+}
+
+int main(int argc, char* argv[])
+{
+    struct fj_options options;
+
+    if (fj_parse_options(argc, argv, &options) < 0)
+    {
+        fj_usage(argv[0]);
+        return -1;
+    }
+
+    /* the workers are cache line aligned, too large for the stack */
+    struct fj_context* ctxt = (struct fj_context*)mem_alloc_aligned(sizeof(struct fj_context), CACHE_LINE_SIZE);
+    struct fj_worker* workers = (struct fj_worker*)mem_alloc_aligned(FJ_MAX_WORKERS * sizeof(struct fj_worker), CACHE_LINE_SIZE);
+    if (!ctxt || !workers)
+    {
+        mem_free_aligned(ctxt);
+        mem_free_aligned(workers);
+        return -1;
+    }
+    memset(ctxt, 0, sizeof(struct fj_context));
+    memset(workers, 0, FJ_MAX_WORKERS * sizeof(struct fj_worker));
+    ctxt->m_workers = workers;
+
+    int exit_code = 0;
+
+    fj_print_header(&options);
+
+    for (int q = 0; q < options.m_nb_queues; ++q)
+    {
+        for (int w = 0; w < options.m_nb_workers; ++w)
+        {
+            ctxt->m_queue = (enum fj_queue)options.m_queues[q];
+            ctxt->m_nb_workers = options.m_workers[w];
+            ctxt->m_work = options.m_work;
+
+            for (int run = 0; run < options.m_repeat; ++run)
+            {
+                struct fj_result result;
+
+                if (fj_run(ctxt, &options, &result) < 0)
+                {
+                    fprintf(stderr, "scenario %s with %d workers failed\n", st_queue_names[ctxt->m_queue], ctxt->m_nb_workers);
+                    exit_code = -1;
+                    continue;
+                }
+
+                fj_print_result(&options, ctxt, run, &result);
+
+                if ((double)result.m_inlined > FJ_INLINED_WARNING * (double)result.m_tasks)
+                {
+                    fprintf(stderr, "warning: %s ran %.0f%% of the tasks inline because its queue of %llu was full, raise --capacity\n",
+                        st_queue_names[ctxt->m_queue], 100.0 * (double)result.m_inlined / (double)result.m_tasks, result.m_capacity);
+                }
+            }
+        }
+    }
+
+    mem_free_aligned(workers);
+    mem_free_aligned(ctxt);
+
+    return exit_code;
+}
@@ -0,0 +1,504 @@
+//-----------------------------------------------------------------------------//
+// CRingBuffer MPMC - FIFO helper                                              //
+// (c) 2023 Laurent Lardinois https://be.linkedin.com/in/laurentlardinois      //
+//                                                                             //
+// https://github.com/type-one/CRingBuffer_MPSC                                //
+//                                                                             //
+// This software is provided 'as-is', without any express or implied           //
+// warranty.In no event will the authors be held liable for any damages        //
+// arising from the use of this software.                                      //
+//                                                                             //
+// Permission is granted to anyone to use this software for any purpose,       //
+// including commercial applications, and to alter itand redistribute it       //
+// freely, subject to the following restrictions :                             //
+//                                                                             //
+// 1. The origin of this software must not be misrepresented; you must not     //
+// claim that you wrote the original software.If you use this software         //
+// in a product, an acknowledgment in the product documentation would be       //
+// appreciated but is not required.                                            //
+// 2. Altered source versions must be plainly marked as such, and must not be  //
+// misrepresented as being the original software.                              //
+// 3. This notice may not be removed or altered from any source distribution.  //
+//-----------------------------------------------------------------------------//
+
+/* inter-process benchmark: a producer process streams numbered frames through a ring_buffer_shm to a
+   consumer process which checks their order and content; by default the program forks the consumer
+   (spawns itself on Windows), the two roles can also be started separately on the same region name */
+
+#include "tools/atomic_helper.h"
+#include "tools/ring_buffer_shm.h"
+#include "tools/timer_chrono.h"
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#if defined(_WIN32)
+#include <windows.h>
+#else
+#include <sched.h>
+#include <sys/types.h>
+#include <sys/wait.h>
+#include <unistd.h>
+#endif
+
+#if defined(_WIN32)
+#define SHM_DEFAULT_NAME "Local\\cringbuffer_shm"
+#else
+#define SHM_DEFAULT_NAME "/cringbuffer_shm"
+#endif
+
+#define SHM_MAX_NAME 128
+#define SHM_ATTACH_RETRIES 500 /* every 10 ms, a consumer started alone waits up to 5 s for the producer */
+#define SHM_PEER_CHECK_SPINS 1024 /* a waiting producer checks its consumer process every that many retries */
+
+enum shm_role
+{
+    SHM_ROLE_BOTH, /* create the region, start the consumer process and produce */
+    SHM_ROLE_PRODUCER,
+    SHM_ROLE_CONSUMER,
+    SHM_ROLE_COUNT
+};
+
+static const char* const st_role_names[SHM_ROLE_COUNT] = { "both", "producer", "consumer" };
+
+struct shm_options
+{
+    enum shm_role m_role;
+    char m_name[SHM_MAX_NAME];
+    long long m_messages;
+    unsigned long long m_capacity;
+    size_t m_block_size;
+};
+
+/* consumer process started by the producer, checked while the producer waits on it */
+struct shm_peer
+{
+#if defined(_WIN32)
+    HANDLE m_process;
+#else
+    pid_t m_pid;
+#endif
+    bool m_exited;
+    bool m_ok; /* exited with 0, valid once m_exited */
+};
+
+static void shm_yield(void)
+{
+#if defined(_WIN32)
+    Sleep(0);
+#else
+    sched_yield();
+#endif
+}
+
+static void shm_sleep_ms(unsigned int ms)
+{
+#if defined(_WIN32)
+    Sleep(ms);
+#else
+    usleep(ms * 1000U);
+#endif
+}
+
+/* collect the peer's exit status if it is gone (wait for it when block is true), false while it runs */
+static bool shm_peer_exited(struct shm_peer* peer, bool block)
+{
+    if (peer->m_exited)
+    {
+        return true;
+    }
+
+#if defined(_WIN32)
+    if (WAIT_OBJECT_0 != WaitForSingleObject(peer->m_process, block ? INFINITE : 0))
+    {
+        return false;
+    }
+
+    DWORD exit_code = 1;
+    (void)GetExitCodeProcess(peer->m_process, &exit_code);
+    peer->m_ok = (0 == exit_code);
+#else
+    int status = 0;
+
+    if (peer->m_pid != waitpid(peer->m_pid, &status, block ? 0 : WNOHANG))
+    {
+        return false;
+    }
+
+    peer->m_ok = WIFEXITED(status) && (0 == WEXITSTATUS(status));
+#endif
+
+    peer->m_exited = true;
+
+    return true;
+}
+
+/* frame: sequence number then a payload byte pattern derived from it */
+static void shm_fill_frame(unsigned char* block, size_t block_size, long long seq)
+{
+    memcpy(block, &seq, sizeof(seq));
+    memset(block + sizeof(seq), (int)(seq & 0xFF), block_size - sizeof(seq));
+}
+
+static bool shm_check_frame(const unsigned char* block, size_t length, size_t block_size, long long expected)
+{
+    long long seq = -1;
+
+    if (length != block_size)
+    {
+        return false;
+    }
+
+    memcpy(&seq, block, sizeof(seq));
+
+    return (seq == expected) && (block[sizeof(seq)] == (unsigned char)(expected & 0xFF))
+        && (block[block_size - 1U] == (unsigned char)(expected & 0xFF));
+}
+
+/* wait for the consumer to make room, false if the consumer process (when known) exited meanwhile:
+   it only exits once every frame is consumed, so nothing would ever make room again */
+static bool shm_wait_consumer(struct shm_peer* peer, unsigned int* spins, long long seq)
+{
+    if (peer && (0 == (++(*spins) % SHM_PEER_CHECK_SPINS)) && shm_peer_exited(peer, false))
+    {
+        fprintf(stderr, "producer: the consumer exited before frame %lld\n", seq);
+        return false;
+    }
+
+    shm_yield();
+
+    return true;
+}
+
+/* peer can be NULL (consumer started separately, not watched) */
+static int shm_produce(struct ring_buffer_shm* shm, long long messages, struct shm_peer* peer)
+{
+    const size_t block_size = (size_t)shm->m_header->m_block_size;
+    unsigned int spins = 0U;
+
+    for (long long seq = 0; seq < messages; ++seq)
+    {
+        unsigned char* block;
+
+        /* all the blocks in flight, wait for the consumer to give some back */
+        while (NULL == (block = (unsigned char*)ring_buffer_shm_alloc(shm)))
+        {
+            if (!shm_wait_consumer(peer, &spins, seq))
+            {
+                return -1;
+            }
+        }
+
+        shm_fill_frame(block, block_size, seq);
+
+        while (!ring_buffer_shm_push(shm, block, block_size))
+        {
+            if (!shm_wait_consumer(peer, &spins, seq))
+            {
+                ring_buffer_shm_free(shm, block);
+                return -1;
+            }
+        }
+    }
+
+    return 0;
+}
+
+static int shm_consume(struct ring_buffer_shm* shm, long long messages)
+{
+    const size_t block_size = (size_t)shm->m_header->m_block_size;
+    long long bad = 0;
+
+    for (long long seq = 0; seq < messages; ++seq)
+    {
+        void* block = NULL;
+        size_t length = 0U;
+
+        while (!ring_buffer_shm_pop(shm, &block, &length))
+        {
+            shm_yield();
+        }
+
+        if (!shm_check_frame((const unsigned char*)block, length, block_size, seq))
+        {
+            ++bad;
+        }
+
+        ring_buffer_shm_free(shm, block);
+    }
+
+    if (bad > 0)
+    {
+        fprintf(stderr, "consumer: %lld of %lld frames out of order or corrupted\n", bad, messages);
+        return -1;
+    }
+
+    return 0;
+}
+
+static int shm_run_consumer(const struct shm_options* options)
+{
+    struct ring_buffer_shm shm;
+    int retries = 0;
+
+    /* the producer may not have created the region yet */
+    while (attach_ring_buffer_shm_named(&shm, options->m_name) < 0)
+    {
+        if (++retries > SHM_ATTACH_RETRIES)
+        {
+            fprintf(stderr, "consumer: could not attach to %s\n", options->m_name);
+            return -1;
+        }
+        shm_sleep_ms(10U);
+    }
+
+    const int ret = shm_consume(&shm, options->m_messages);
+    (void)deinit_ring_buffer_shm(&shm);
+
+    if (SHM_ROLE_CONSUMER == options->m_role)
+    {
+        /* last user of a region created by a producer started alone */
+        (void)ring_buffer_shm_unlink(options->m_name);
+    }
+
+    return ret;
+}
+
+static int shm_run_producer(const struct shm_options* options)
+{
+    struct ring_buffer_shm shm;
+
+    if (init_ring_buffer_shm_named(&shm, options->m_name, options->m_capacity, options->m_block_size) < 0)
+    {
+        fprintf(stderr, "producer: could not create %s (already exists?)\n", options->m_name);
+        return -1;
+    }
+
+    struct timer_chrono timer;
+    (void)init_timer_chrono(&timer);
+    const double start_time = timer_chrono_current_time_ms(&timer);
+
+    const int ret = shm_produce(&shm, options->m_messages, NULL);
+
+    printf("producer: %lld frames of %zu bytes pushed in %.3f ms\n", options->m_messages, options->m_block_size,
+        timer_chrono_current_time_ms(&timer) - start_time);
+
+    (void)deinit_ring_buffer_shm(&shm);
+
+    return ret;
+}
+
+/* start the consumer as another process, attached to the same region by name */
+static int shm_run_both(const struct shm_options* options, const char* program)
+{
+    struct ring_buffer_shm shm;
+
+    if (init_ring_buffer_shm_named(&shm, options->m_name, options->m_capacity, options->m_block_size) < 0)
+    {
+        fprintf(stderr, "could not create %s\n", options->m_name);
+        return -1;
+    }
+
+    struct timer_chrono timer;
+    (void)init_timer_chrono(&timer);
+    const double start_time = timer_chrono_current_time_ms(&timer);
+    int ret = 0;
+    struct shm_peer peer;
+
+    memset(&peer, 0, sizeof(peer));
+
+#if defined(_WIN32)
+    char command[2 * MAX_PATH];
+    STARTUPINFOA startup;
+    PROCESS_INFORMATION process;
+
+    memset(&startup, 0, sizeof(startup));
+    startup.cb = sizeof(startup);
+    (void)snprintf(command, sizeof(command), "\"%s\" --role consumer --name %s --messages %lld", program, options->m_name, options->m_messages);
+
+    if (!CreateProcessA(NULL, command, NULL, NULL, FALSE, 0, NULL, NULL, &startup, &process))
+    {
+        (void)deinit_ring_buffer_shm(&shm);
+        return -1;
+    }
+
+    peer.m_process = process.hProcess;
+    ret = shm_produce(&shm, options->m_messages, &peer);
+
+    (void)shm_peer_exited(&peer, true);
+    CloseHandle(process.hThread);
+    CloseHandle(process.hProcess);
+#else
+    (void)program;
+
+    const pid_t pid = fork();
+
+    if (pid < 0)
+    {
+        (void)deinit_ring_buffer_shm(&shm);
+        (void)ring_buffer_shm_unlink(options->m_name);
+        return -1;
+    }
+
+    if (0 == pid)
+    {
+        /* child: drop the inherited mapping and attach by name like an unrelated process would */
+        (void)deinit_ring_buffer_shm(&shm);
+        _exit((shm_run_consumer(options) < 0) ? 1 : 0);
+    }
+
+    peer.m_pid = pid;
+    ret = shm_produce(&shm, options->m_messages, &peer);
+
+    (void)shm_peer_exited(&peer, true);
+#endif
+
+    const double elapsed_ms = timer_chrono_current_time_ms(&timer) - start_time;
+
+    printf("%lld frames of %zu bytes through %llu blocks, consumer %s\n", options->m_messages, options->m_block_size,
+        options->m_capacity, peer.m_ok ? "ok" : "failed");
+    if (ret >= 0)
+    {
+        printf("execution time is %.3f ms, throughput of %.0f frames/s\n", elapsed_ms,
+            (elapsed_ms > 0.0) ? (double)options->m_messages * 1000.0 / elapsed_ms : 0.0);
+    }
+
+    (void)deinit_ring_buffer_shm(&shm);
+    (void)ring_buffer_shm_unlink(options->m_name);
+
+    return ((ret < 0) || !peer.m_ok) ? -1 : 0;
+}
+
+static void shm_usage(const char* program)
+{
+    fprintf(stderr,
+        "usage: %s [options]\n"
+        "  --role ROLE         both, producer or consumer (default both: the consumer runs in a child process)\n"
+        "  --name NAME         shared memory region name (default %s, made unique per process for both)\n"
+        "  --messages N        frames to transfer (default 100000)\n"
+        "  --capacity N        blocks in the region, power of two (default 1024)\n"
+        "  --block N           block size in bytes (default 256)\n"
+        "start the producer before the consumer when the roles run as separate programs\n",
+        program, SHM_DEFAULT_NAME);
+}
+
+static int shm_parse_options(int argc, char* argv[], struct shm_options* options)
+{
+    bool named = false;
+
+    memset(options, 0, sizeof(struct shm_options));
+    options->m_role = SHM_ROLE_BOTH;
+    options->m_messages = 100000;
+    options->m_capacity = 1024ULL;
+    options->m_block_size = 256U;
+
+    for (int i = 1; i < argc; ++i)
+    {
+        const char* option = argv[i];
+        const char* value = (i + 1 < argc) ? argv[i + 1] : NULL;
+
+        if ((0 == strcmp(option, "--help")) || (0 == strcmp(option, "-h")))
+        {
+            return -1;
+        }
+
+        if (!value)
+        {
+            fprintf(stderr, "missing value for %s\n", option);
+            return -1;
+        }
+        ++i;
+
+        if (0 == strcmp(option, "--role"))
+        {
+            int role = -1;
+            for (int r = 0; r < SHM_ROLE_COUNT; ++r)
+            {
+                if (0 == strcmp(value, st_role_names[r]))
+                {
+                    role = r;
+                }
+            }
+            if (role < 0)
+            {
+                fprintf(stderr, "invalid role '%s'\n", value);
+                return -1;
+            }
+            options->m_role = (enum shm_role)role;
+        }
+        else if (0 == strcmp(option, "--name"))
+        {
+            (void)snprintf(options->m_name, sizeof(options->m_name), "%s", value);
+            named = true;
+        }
+        else if (0 == strcmp(option, "--messages"))
+        {
+            options->m_messages = atoll(value);
+        }
+        else if (0 == strcmp(option, "--capacity"))
+        {
+            options->m_capacity = strtoull(value, NULL, 10);
+        }
+        else if (0 == strcmp(option, "--block"))
+        {
+            options->m_block_size = (size_t)strtoull(value, NULL, 10);
+        }
+        else
+        {
+            fprintf(stderr, "unknown option %s\n", option);
+            return -1;
+        }
+    }
+
+    if (!named && (SHM_ROLE_BOTH == options->m_role))
+    {
+        /* a private region per run, a stale one left by a killed run does not get in the way */
+#if defined(_WIN32)
+        (void)snprintf(options->m_name, sizeof(options->m_name), "%s_%lu", SHM_DEFAULT_NAME, (unsigned long)GetCurrentProcessId());
+#else
+        (void)snprintf(options->m_name, sizeof(options->m_name), "%s_%lu", SHM_DEFAULT_NAME, (unsigned long)getpid());
+#endif
+    }
+    else if (!named)
+    {
+        (void)snprintf(options->m_name, sizeof(options->m_name), "%s", SHM_DEFAULT_NAME);
+    }
+
+    if ((options->m_messages <= 0) || (options->m_block_size < sizeof(long long)))
+    {
+        return -1;
+    }
+
+    return 0;
+}
+
+int main(int argc, char* argv[])
+{
+    struct shm_options options;
+
+    if (shm_parse_options(argc, argv, &options) < 0)
+    {
+        shm_usage(argv[0]);
+        return -1;
+    }
+
+    int ret = -1;
+
+    switch (options.m_role)
+    {
+        case SHM_ROLE_PRODUCER:
+            ret = shm_run_producer(&options);
+            break;
+        case SHM_ROLE_CONSUMER:
+            ret = shm_run_consumer(&options);
+            break;
+        default:
+            ret = shm_run_both(&options, argv[0]);
+            break;
+    }
+
+    return (ret < 0) ? 1 : 0;
+}
@@ -22,8 +22,16 @@
 //-----------------------------------------------------------------------------//
 
 #include "tools/atomic_helper.h"
+#include "tools/mem_alloc.h"
+#include "tools/mem_pool.h"
 #include "tools/ring_buffer_mpmc.h"
+#include "tools/ring_buffer_mpmc_inline.h"
+#include "tools/ring_buffer_mpmc_lf.h"
+#include "tools/ring_buffer_segmented.h"
+#include "tools/ring_buffer_sharded.h"
+#include "tools/ring_buffer_spsc.h"
 #include "tools/sync_object.h"
+#include "tools/thread_helper.h"
 #include "tools/timer_chrono.h"
 
 #include <stdio.h>
@@ -42,9 +50,39 @@
 /* avoid malloc/free in producer/consumer */
 #define NO_DYNAMIC_ALLOC 1
 
+/* with NO_DYNAMIC_ALLOC set to 0, messages taken from a preallocated block pool instead of strdup/free */
+#define MESSAGE_POOL 1
+#define MESSAGE_SIZE 256
+
+/* ring storage (mutex engine) and message pool on 2 MB pages, prefaulted at init */
+#define LARGE_PAGES 0
+#define LARGE_PAGES_FLAGS (MEM_ALLOC_HUGE_PAGES | MEM_ALLOC_PREFAULT)
+
 /* no printf output during computation, better to benchmark */
 #define NO_STDIO 0
 
+/* lock-free MPMC engine (per-slot sequence numbers) instead of the mutex pair, to A/B both implementations */
+#define LOCK_FREE_MPMC 0
+
+/* messages copied by value into the slots of the lock-free inline engine, no external storage */
+#define INLINE_PAYLOAD 0
+#define INLINE_MSG_SIZE 64
+
+/* unbounded queue made of linked segments, grows during bursts instead of skipping messages */
+#define UNBOUNDED_QUEUE 0
+
+/* one lock-free lane per producer, consumers start from their own lane and steal from the others */
+#define SHARDED_QUEUE 0
+
+/* blocking push/pop built into the mutex engine (spin then park) instead of the separate sync objects */
+#define BLOCKING_QUEUE 0
+
+/* dedicated SPSC engine with cached opposite index, only with SINGLE_PRODUCER and SINGLE_CONSUMER */
+#define SPSC_CACHED_INDEX 0
+
+/* pin each thread to its own CPU (producers on the first CPUs, consumers on the next ones) for steadier results */
+#define PIN_THREADS 0
+
 /* single producer, single consumer, running as fast as possible without blocking (lock-free) */
 //#define PRODUCER_NO_WAIT 1
 //#define CONSUMER_NO_WAIT 1
@@ -99,9 +137,131 @@
 
 #define NB_THREADS (NB_PRODUCERS + NB_CONSUMERS)
 
+#if SPSC_CACHED_INDEX
+#if !SINGLE_PRODUCER || !SINGLE_CONSUMER
+#error "SPSC_CACHED_INDEX requires SINGLE_PRODUCER and SINGLE_CONSUMER"
+#endif
+#if BLOCKING_QUEUE
+#error "BLOCKING_QUEUE is only supported by the mutex engine"
+#endif
+#define FIFO_TYPE struct ring_buffer_spsc
+#define FIFO_INIT(fifo) init_ring_buffer_spsc(fifo)
+#define FIFO_DEINIT(fifo) deinit_ring_buffer_spsc(fifo)
+#define FIFO_PUSH(fifo, elem) ring_buffer_spsc_push(fifo, elem)
+#define FIFO_POP(fifo, elem) ring_buffer_spsc_pop(fifo, elem)
+#elif INLINE_PAYLOAD
+#if BLOCKING_QUEUE
+#error "BLOCKING_QUEUE is only supported by the mutex engine"
+#endif
+#define FIFO_TYPE struct ring_buffer_mpmc_inline
+#define FIFO_INIT(fifo) init_ring_buffer_mpmc_inline(fifo, INLINE_MSG_SIZE)
+#define FIFO_DEINIT(fifo) deinit_ring_buffer_mpmc_inline(fifo)
+#define FIFO_PUSH(fifo, elem) ring_buffer_inline_push(fifo, elem)
+#define FIFO_POP(fifo, elem) ring_buffer_inline_pop(fifo, *(elem)) /* elem points to the consumer payload buffer */
+#elif UNBOUNDED_QUEUE
+#if BLOCKING_QUEUE
+#error "BLOCKING_QUEUE is only supported by the mutex engine"
+#endif
+#define FIFO_TYPE struct ring_buffer_segmented
+#define FIFO_INIT(fifo) init_ring_buffer_segmented(fifo)
+#define FIFO_DEINIT(fifo) deinit_ring_buffer_segmented(fifo)
+#if SINGLE_PRODUCER
+#define FIFO_PUSH(fifo, elem) ring_buffer_segmented_push_sp(fifo, elem)
+#else
+#define FIFO_PUSH(fifo, elem) ring_buffer_segmented_push_mp(fifo, elem)
+#endif
+#if SINGLE_CONSUMER
+#define FIFO_POP(fifo, elem) ring_buffer_segmented_pop_sc(fifo, elem)
+#else
+#define FIFO_POP(fifo, elem) ring_buffer_segmented_pop_mc(fifo, elem)
+#endif
+#elif SHARDED_QUEUE
+#if BLOCKING_QUEUE
+#error "BLOCKING_QUEUE is only supported by the mutex engine"
+#endif
+#define FIFO_TYPE struct ring_buffer_sharded
+#define FIFO_INIT(fifo) init_ring_buffer_sharded(fifo, NB_PRODUCERS)
+#define FIFO_DEINIT(fifo) deinit_ring_buffer_sharded(fifo)
+#define FIFO_PUSH(fifo, elem) ring_buffer_sharded_push(fifo, elem)
+#define FIFO_POP(fifo, elem) ring_buffer_sharded_pop(fifo, elem)
+#elif LOCK_FREE_MPMC
+#if BLOCKING_QUEUE
+#error "BLOCKING_QUEUE is only supported by the mutex engine"
+#endif
+#define FIFO_TYPE struct ring_buffer_mpmc_lf
+#define FIFO_INIT(fifo) init_ring_buffer_mpmc_lf(fifo)
+#define FIFO_DEINIT(fifo) deinit_ring_buffer_mpmc_lf(fifo)
+#define FIFO_PUSH(fifo, elem) ring_buffer_lf_push(fifo, elem)
+#define FIFO_POP(fifo, elem) ring_buffer_lf_pop(fifo, elem)
+#else
+#define FIFO_TYPE struct ring_buffer_mpmc
+#define FIFO_HAS_STATS 1
+#if LARGE_PAGES
+static void* st_fifo_storage = NULL;
+
+static int init_fifo_large_pages(struct ring_buffer_mpmc* fifo)
+{
+    const size_t size = ring_buffer_mpmc_storage_size(RING_BUFFER_SIZE);
+
+    st_fifo_storage = mem_alloc_pages(size, LARGE_PAGES_FLAGS, MEM_ALLOC_ANY_NODE);
+    if (!st_fifo_storage)
+    {
+        return -1;
+    }
+
+    if (init_ring_buffer_mpmc_ex(fifo, RING_BUFFER_SIZE, st_fifo_storage) < 0)
+    {
+        mem_free_pages(st_fifo_storage, size, LARGE_PAGES_FLAGS);
+        st_fifo_storage = NULL;
+        return -1;
+    }
+
+    return 0;
+}
+
+static int deinit_fifo_large_pages(struct ring_buffer_mpmc* fifo)
+{
+    const int ret = deinit_ring_buffer_mpmc(fifo);
+
+    mem_free_pages(st_fifo_storage, ring_buffer_mpmc_storage_size(RING_BUFFER_SIZE), LARGE_PAGES_FLAGS);
+    st_fifo_storage = NULL;
+
+    return ret;
+}
+
+#define FIFO_INIT(fifo) init_fifo_large_pages(fifo)
+#define FIFO_DEINIT(fifo) deinit_fifo_large_pages(fifo)
+#else
+#define FIFO_INIT(fifo) init_ring_buffer_mpmc(fifo)
+#define FIFO_DEINIT(fifo) deinit_ring_buffer_mpmc(fifo)
+#endif
+#if SINGLE_PRODUCER
+#define FIFO_PUSH(fifo, elem) ring_buffer_push_sp(fifo, elem)
+#define FIFO_PUSH_WAIT(fifo, elem, timeout_us) ring_buffer_push_wait_sp(fifo, elem, timeout_us)
+#else
+#define FIFO_PUSH(fifo, elem) ring_buffer_push_mp(fifo, elem)
+#define FIFO_PUSH_WAIT(fifo, elem, timeout_us) ring_buffer_push_wait_mp(fifo, elem, timeout_us)
+#endif
+#if SINGLE_CONSUMER
+#define FIFO_POP(fifo, elem) ring_buffer_pop_sc(fifo, elem)
+#define FIFO_POP_WAIT(fifo, elem, timeout_us) ring_buffer_pop_wait_sc(fifo, elem, timeout_us)
+#else
+#define FIFO_POP(fifo, elem) ring_buffer_pop_mc(fifo, elem)
+#define FIFO_POP_WAIT(fifo, elem, timeout_us) ring_buffer_pop_wait_mc(fifo, elem, timeout_us)
+#endif
+#endif
+
 #define NB_MSGS_PER_PRODUCER 1000
 #define NB_MSGS_TOTAL (NB_PRODUCERS * NB_MSGS_PER_PRODUCER)
 
+#define USE_MESSAGE_POOL (!NO_DYNAMIC_ALLOC && !INLINE_PAYLOAD && MESSAGE_POOL)
+
+#if USE_MESSAGE_POOL
+#define MSG_FREE(ctxt, msg) mem_pool_free(&((ctxt)->m_msg_pool), msg)
+#else
+#define MSG_FREE(ctxt, msg) free(msg)
+#endif
+
 #if NO_STDIO
 #define LOG_INFO(...)
 #define LOG_ERROR(...)
@@ -113,12 +273,15 @@
 struct thread_context
 {
     _atomic_bool m_stop_thread;
-    struct ring_buffer_mpmc m_fifo;
+    FIFO_TYPE m_fifo;
     struct sync_object m_write_sync;
     struct sync_object m_read_sync;
     struct sync_object m_start_sync;
     _atomic_long m_msg_count;
     _atomic_long m_msg_skipped;
+#if USE_MESSAGE_POOL
+    struct mem_pool m_msg_pool;
+#endif
 };
 
 static void dec_and_check_end(struct thread_context* ctxt)
@@ -134,17 +297,11 @@ static void dec_and_check_end(struct thread_context* ctxt)
     }
 }
 
-#if NO_DYNAMIC_ALLOC
-static char st_message[NB_PRODUCERS][NB_MSGS_PER_PRODUCER][256];
+#if NO_DYNAMIC_ALLOC && !INLINE_PAYLOAD
+static char st_message[NB_PRODUCERS][NB_MSGS_PER_PRODUCER][MESSAGE_SIZE];
 #endif
 
-#if defined(_WIN32)
-static DWORD WINAPI producer_thread(LPVOID arg)
-#elif defined(__STDC_NO_THREADS__)
-static void* producer_thread(void* arg)
-#else
-static int producer_thread(void* arg)
-#endif
+static void producer_thread(void* arg)
 {
     static int producer_id = 1;
     int my_id = producer_id++;
@@ -157,7 +314,7 @@ static int producer_thread(void* arg)
         sync_object_wait_for_signal(&(ctxt->m_start_sync));
     }
 
-    char message[256];
+    char message[MESSAGE_SIZE];
 
     int count = 0;
     while (ctxt && count++ < NB_MSGS_PER_PRODUCER)
@@ -170,42 +327,53 @@ static int producer_thread(void* arg)
 
         /* produce something */
         snprintf(message, sizeof(message), "job %d-%d from producer %d", count, my_id, my_id);
-#if NO_DYNAMIC_ALLOC
-        char* duplicata = &st_message[my_id - 1][count][0];
-        strncpy(duplicata, message, sizeof(st_message[my_id - 1][count]));
+#if INLINE_PAYLOAD
+        char* duplicata = message; /* copied into the slot by the push */
+#elif NO_DYNAMIC_ALLOC
+        char* duplicata = &st_message[my_id - 1][count - 1][0];
+        strncpy(duplicata, message, sizeof(st_message[my_id - 1][count - 1]));
+#elif USE_MESSAGE_POOL
+        char* duplicata = (char*)mem_pool_alloc(&(ctxt->m_msg_pool));
+        if (duplicata)
+        {
+            memcpy(duplicata, message, sizeof(message));
+        }
 #else
         char* duplicata = strdup(message);
 #endif
 
         if (!duplicata)
         {
-            LOG_ERROR("producer %d could not strdup for job %d-%d\n", my_id, count, my_id);
+            LOG_ERROR("producer %d could not allocate job %d-%d\n", my_id, count, my_id);
             sync_atomic_inc_32(ctxt->m_msg_skipped);
             dec_and_check_end(ctxt);
         }
         else
         {
-#if SINGLE_PRODUCER
-            if (!ring_buffer_push_sp(&(ctxt->m_fifo), duplicata))
+#if BLOCKING_QUEUE
+            /* wait for a free slot, with a 1s timeout */
+            if (!FIFO_PUSH_WAIT(&(ctxt->m_fifo), duplicata, 1000000))
 #else
-            if (!ring_buffer_push_mp(&(ctxt->m_fifo), duplicata))
+            if (!FIFO_PUSH(&(ctxt->m_fifo), duplicata))
 #endif
             {
                 LOG_INFO("producer %d: buffer full, skip job %d-%d\n", my_id, count, my_id);
-#if !NO_DYNAMIC_ALLOC
-                free(duplicata);
+#if !NO_DYNAMIC_ALLOC && !INLINE_PAYLOAD
+                MSG_FREE(ctxt, duplicata);
 #endif
                 sync_atomic_inc_32(ctxt->m_msg_skipped);
                 dec_and_check_end(ctxt);
             }
+#if !BLOCKING_QUEUE
             else
             {
                 sync_object_signal(&(ctxt->m_write_sync));
             }
+#endif
         }
 
         /* wait reader, with a 1s timeout */
-#if !PRODUCER_NO_WAIT
+#if !PRODUCER_NO_WAIT && !BLOCKING_QUEUE
         (void)sync_object_wait_for_signal_timed(&(ctxt->m_read_sync), 1000000);
 #endif
 
@@ -220,25 +388,17 @@ static int producer_thread(void* arg)
 #endif
     }
 
-#if defined(_WIN32)
-    return 0;
-#elif defined(__STDC_NO_THREADS__)
-    pthread_exit(0);
-    return NULL;
-#else
-    thrd_exit(0);
-    return 0;
+#if USE_MESSAGE_POOL
+    /* give the blocks cached by this thread back to the pool */
+    if (ctxt)
+    {
+        mem_pool_flush_thread_cache(&(ctxt->m_msg_pool));
+    }
 #endif
 }
 
 
-#if defined(_WIN32)
-static DWORD WINAPI consumer_thread(LPVOID arg)
-#elif defined(__STDC_NO_THREADS__)
-static void* consumer_thread(void* arg)
-#else
-static int consumer_thread(void* arg)
-#endif
+static void consumer_thread(void* arg)
 {
     static int consumer_id = 1;
     int my_id = consumer_id++;
@@ -258,17 +418,23 @@ static int consumer_thread(void* arg)
             break;
         }
 
-#if !CONSUMER_NO_WAIT
+#if !CONSUMER_NO_WAIT && !BLOCKING_QUEUE
         /* consume something, 1s timeout */
         (void)sync_object_wait_for_signal_timed(&(ctxt->m_write_sync), 1000000);
 #endif
 
+#if INLINE_PAYLOAD
+        char payload[INLINE_MSG_SIZE];
+        void* elem = payload;
+#else
         void* elem = NULL;
+#endif
 
-#if SINGLE_CONSUMER
-        if (!ring_buffer_pop_sc(&(ctxt->m_fifo), &elem))
+#if BLOCKING_QUEUE
+        /* short timeout to check the stop flag regularly */
+        if (!FIFO_POP_WAIT(&(ctxt->m_fifo), &elem, 10000))
 #else
-        if (!ring_buffer_pop_mc(&(ctxt->m_fifo), &elem))
+        if (!FIFO_POP(&(ctxt->m_fifo), &elem))
 #endif
         {
             LOG_INFO("consumer %d: buffer empty, skip turn\n", my_id);
@@ -276,14 +442,18 @@ static int consumer_thread(void* arg)
         else if (!elem)
         {
             LOG_ERROR("consumer %d: anomaly - retrieved ptr is null, skip turn\n", my_id);
+#if !BLOCKING_QUEUE
             sync_object_signal(&(ctxt->m_read_sync));
+#endif
         }
         else
         {
             LOG_INFO("consumer %d: received %s\n", my_id, (char*)elem);
 
+#if !BLOCKING_QUEUE
             /* job taken */
             sync_object_signal(&(ctxt->m_read_sync));
+#endif
 
 #if CONSUMER_SIMULATE_WORK_LOAD
             /* simulate some variable time processing */
@@ -292,22 +462,20 @@ static int consumer_thread(void* arg)
             }
 #endif
 
-#if !NO_DYNAMIC_ALLOC
-            free(elem);
+#if !NO_DYNAMIC_ALLOC && !INLINE_PAYLOAD
+            MSG_FREE(ctxt, elem);
 #endif
 
             dec_and_check_end(ctxt);
         }
     }
 
-#if defined(_WIN32)
-    return 0;
-#elif defined(__STDC_NO_THREADS__)
-    pthread_exit(0);
-    return NULL;
-#else
-    thrd_exit(0);
-    return 0;
+#if USE_MESSAGE_POOL
+    /* give the blocks cached by this thread back to the pool */
+    if (ctxt)
+    {
+        mem_pool_flush_thread_cache(&(ctxt->m_msg_pool));
+    }
 #endif
 }
 
@@ -328,21 +496,21 @@ int main(int argc, char* argv[])
 
     (void)init_timer_chrono(&timer);
 
-    if (init_ring_buffer_mpmc(&(ctxt.m_fifo)) < 0)
+    if (FIFO_INIT(&(ctxt.m_fifo)) < 0)
     {
         return -1;
     }
 
     if (init_sync_object(&(ctxt.m_write_sync), false) < 0)
     {
-        deinit_ring_buffer_mpmc(&(ctxt.m_fifo));
+        FIFO_DEINIT(&(ctxt.m_fifo));
         return -1;
     }
 
     if (init_sync_object(&(ctxt.m_read_sync), false) < 0)
     {
         deinit_sync_object(&(ctxt.m_write_sync));
-        deinit_ring_buffer_mpmc(&(ctxt.m_fifo));
+        FIFO_DEINIT(&(ctxt.m_fifo));
         return -1;
     }
 
@@ -350,78 +518,47 @@ int main(int argc, char* argv[])
     {
         deinit_sync_object(&(ctxt.m_read_sync));
         deinit_sync_object(&(ctxt.m_write_sync));
-        deinit_ring_buffer_mpmc(&(ctxt.m_fifo));
+        FIFO_DEINIT(&(ctxt.m_fifo));
         return -1;
     }
 
-#if defined(_WIN32)
-
-    DWORD thread_tid[NB_THREADS];
-    HANDLE thread_hnd[NB_THREADS];
-
-    memset(thread_tid, 0, sizeof(thread_tid));
-    memset(thread_hnd, 0, sizeof(thread_hnd));
-
-    for (int i = 0; i < NB_PRODUCERS; ++i)
-    {
-        thread_hnd[i] = CreateThread(0, 4096, producer_thread, &ctxt, 0, &thread_tid[i]);
-        if (NULL == thread_hnd[i])
-        {
-            goto exit_error;
-        }
-    }
-
-    for (int i = 0; i < NB_CONSUMERS; ++i)
-    {
-        thread_hnd[NB_PRODUCERS + i] = CreateThread(0, 4096, consumer_thread, &ctxt, 0, &thread_tid[NB_PRODUCERS + i]);
-        if (NULL == thread_hnd[i])
-        {
-            goto exit_error;
-        }
-    }
-
-#elif defined(__STDC_NO_THREADS__)
-
-    pthread_t thread_tid[NB_THREADS];
-    memset(thread_tid, 0, sizeof(pthread_t));
-
-    for (int i = 0; i < NB_PRODUCERS; ++i)
-    {
-        if (0 != pthread_create(&thread_tid[i], NULL, producer_thread, &ctxt))
-        {
-            goto exit_error;
-        }
-    }
-
-    for (int i = 0; i < NB_CONSUMERS; ++i)
+#if USE_MESSAGE_POOL
+    /* enough blocks for every message, allocated once before the threads start */
+#if LARGE_PAGES
+    if (init_mem_pool_ex(&(ctxt.m_msg_pool), MESSAGE_SIZE, 0U, NB_MSGS_TOTAL, LARGE_PAGES_FLAGS, MEM_ALLOC_ANY_NODE) < 0)
+#else
+    if (init_mem_pool(&(ctxt.m_msg_pool), MESSAGE_SIZE, 0U, NB_MSGS_TOTAL) < 0)
+#endif
     {
-        if (0 != pthread_create(&thread_tid[NB_PRODUCERS + i], NULL, consumer_thread, &ctxt))
-        {
-            goto exit_error;
-        }
+        deinit_sync_object(&(ctxt.m_start_sync));
+        deinit_sync_object(&(ctxt.m_read_sync));
+        deinit_sync_object(&(ctxt.m_write_sync));
+        FIFO_DEINIT(&(ctxt.m_fifo));
+        return -1;
     }
+#endif
 
-#else
-
-    thrd_t thread_tid[NB_THREADS];
-    memset(thread_tid, 0, sizeof(thrd_t));
+    struct thread_handle threads[NB_THREADS];
+    int nb_started = 0;
 
-    for (int i = 0; i < NB_PRODUCERS; ++i)
+    for (int i = 0; i < NB_THREADS; ++i)
     {
-        if (thrd_success != thrd_create(&thread_tid[i], producer_thread, &ctxt))
-        {
-            goto exit_error;
-        }
-    }
+        const struct thread_cpu_set* placement = NULL;
+
+#if PIN_THREADS
+        /* producers on the first CPUs, consumers on the next ones */
+        struct thread_cpu_set cpus;
+        thread_cpu_set_clear(&cpus);
+        thread_cpu_set_add(&cpus, i % thread_cpu_count());
+        placement = &cpus;
+#endif
 
-    for (int i = 0; i < NB_CONSUMERS; ++i)
-    {
-        if (thrd_success != thrd_create(&thread_tid[NB_PRODUCERS + i], consumer_thread, &ctxt))
+        if (start_thread(&threads[i], (i < NB_PRODUCERS) ? producer_thread : consumer_thread, &ctxt, placement) < 0)
         {
             goto exit_error;
         }
+        ++nb_started;
     }
-#endif
 
     /* this is the end */
     goto exit_main;
@@ -442,43 +579,48 @@ exit_main:
 
     /* wait threads */
 
-#if defined(_WIN32)
-
-    for (int i = 0; (i < NB_THREADS) && thread_hnd[i]; ++i)
-    {
-        WaitForSingleObject(thread_hnd[i], INFINITE);
-        CloseHandle(thread_hnd[i]);
-    }
-
-#elif defined(__STDC_NO_THREADS__)
-
-    for (int i = 0; (i < NB_THREADS) && thread_tid[i]; ++i)
-    {
-        void* ret;
-        pthread_join(thread_tid[i], &ret);
-    }
-
-#else
-
-    for (int i = 0; (i < NB_THREADS) && thread_tid[i]; ++i)
+    for (int i = 0; i < nb_started; ++i)
     {
-        int ret;
-        thrd_join(thread_tid[i], &ret);
+        (void)join_thread(&threads[i]);
     }
 
-#endif
-
     double end_time = timer_chrono_current_time_ms(&timer);
 
     long skip_counter = sync_atomic_load(ctxt.m_msg_skipped);
     printf("\n%ld messages processed, %ld messages skipped\n", NB_MSGS_TOTAL - skip_counter, skip_counter);
     printf("execution time is %lf ms\n", end_time - start_time);
     printf("average of %lf ms per message processed\n", (end_time - start_time) / (NB_MSGS_TOTAL - skip_counter));
+    printf("throughput of %.0lf messages/s\n", (NB_MSGS_TOTAL - skip_counter) * 1000.0 / (end_time - start_time));
+#if SPSC_CACHED_INDEX
+    /* ring_buffer_push_sp/pop_sc load both shared indexes on every call */
+    printf("shared index reloads: %llu by producer, %llu by consumer (%lf per message, at least 2 without cache)\n",
+        ctxt.m_fifo.m_read_idx_reloads, ctxt.m_fifo.m_write_idx_reloads,
+        (double)(ctxt.m_fifo.m_read_idx_reloads + ctxt.m_fifo.m_write_idx_reloads) / (NB_MSGS_TOTAL - skip_counter));
+#endif
+#if defined(FIFO_HAS_STATS) && RING_BUFFER_MPMC_STATS
+    struct ring_buffer_mpmc_stats stats;
+    ring_buffer_mpmc_stats_snapshot(&(ctxt.m_fifo), &stats);
+    for (int i = 0; i < RING_BUFFER_STAT_COUNT; ++i)
+    {
+        printf("%-20s %llu\n", ring_buffer_mpmc_stat_name((enum ring_buffer_mpmc_stat)i), stats.m_counters[i]);
+    }
+#endif
+#if RING_BUFFER_MPMC_LATENCY_HISTOGRAMS
+    ring_buffer_mpmc_latency_dump(stdout);
+#endif
+#if RING_BUFFER_MPMC_CACHE_ALIGNED
+    printf("ring layout: producer/consumer state isolated on %d bytes cache lines\n", CACHE_LINE_SIZE);
+#else
+    printf("ring layout: packed (producer/consumer state sharing cache lines)\n");
+#endif
 
     (void)deinit_sync_object(&(ctxt.m_start_sync));
     (void)deinit_sync_object(&(ctxt.m_read_sync));
     (void)deinit_sync_object(&(ctxt.m_write_sync));
-    (void)deinit_ring_buffer_mpmc(&(ctxt.m_fifo));
+    (void)FIFO_DEINIT(&(ctxt.m_fifo));
+#if USE_MESSAGE_POOL
+    (void)deinit_mem_pool(&(ctxt.m_msg_pool));
+#endif
 
     return exit_code;
 }
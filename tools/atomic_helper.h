@@ -55,8 +55,33 @@ extern "C"
 {
 #endif
 
+/* cache line size, detected per platform (cmake forces it with -DCACHE_LINE_SIZE on linux) */
+#if !defined(CACHE_LINE_SIZE)
+#if defined(__APPLE__) && (defined(__aarch64__) || defined(__arm64__))
+#define CACHE_LINE_SIZE 128
+#elif defined(__powerpc64__) || defined(__ppc64__) || defined(_M_PPC)
+#define CACHE_LINE_SIZE 128
+#else
+#define CACHE_LINE_SIZE 64
+#endif
+#endif
+
+#if defined(_MSC_VER)
+#define CACHE_LINE_ALIGNED __declspec(align(CACHE_LINE_SIZE))
+#else
+#define CACHE_LINE_ALIGNED __attribute__((aligned(CACHE_LINE_SIZE)))
+#endif
+
+/* thread local storage class */
+#if defined(_MSC_VER)
+#define THREAD_LOCAL __declspec(thread)
+#else
+#define THREAD_LOCAL __thread
+#endif
+
 #if !defined(__STDC_NO_ATOMICS__)
 #define _atomic_bool atomic_bool
+#define _atomic_int atomic_int
 #define _atomic_ulong atomic_ulong
 #define _atomic_ullong atomic_ullong
 #define _atomic_long atomic_long
@@ -64,6 +89,7 @@ extern "C"
 #define _atomic_uintptr atomic_uintptr_t
 #else
 #define _atomic_bool volatile bool
+#define _atomic_int volatile int
 #define _atomic_ulong volatile unsigned long
 #define _atomic_ullong volatile unsigned long long
 #define _atomic_long volatile long
@@ -79,10 +105,14 @@ extern "C"
 #define sync_atomic_inc_64(ref) atomic_fetch_add(&(ref), 1)
 #define sync_atomic_dec_32(ref) atomic_fetch_sub(&(ref), 1)
 #define sync_atomic_dec_64(ref) atomic_fetch_sub(&(ref), 1)
+#define sync_atomic_add_64(ref, val) atomic_fetch_add(&(ref), val)
+#define sync_atomic_or_64(ref, val) atomic_fetch_or(&(ref), val)
+#define sync_atomic_and_64(ref, val) atomic_fetch_and(&(ref), val)
 #define sync_atomic_load(ref) atomic_load(&(ref))
 #define sync_atomic_store(ref, val) atomic_store(&ref, val)
 #define sync_atomic_exchange_32(ref, val) atomic_exchange(&ref, val)
 #define sync_atomic_exchange_64(ref, val) atomic_exchange(&ref, val)
+#define sync_atomic_cas_64(ref, expected, desired) atomic_compare_exchange_strong(&(ref), &(expected), desired)
 #elif defined(_WIN32)
 #define sync_read_acquire() _ReadBarrier()
 #define sync_write_release() _WriteBarrier()
@@ -91,10 +121,23 @@ extern "C"
 #define sync_atomic_inc_64(ref) InterlockedIncrementAcquire64(&(ref))
 #define sync_atomic_dec_32(ref) InterlockedDecrementAcquire(&(ref))
 #define sync_atomic_dec_64(ref) InterlockedDecrementAcquire64(&(ref))
+#define sync_atomic_add_64(ref, val) InterlockedExchangeAdd64(&(ref), val)
+#define sync_atomic_or_64(ref, val) InterlockedOr64(&(ref), val)
+#define sync_atomic_and_64(ref, val) InterlockedAnd64(&(ref), val)
 #define sync_atomic_load(ref) (ref)
 #define sync_atomic_store(ref, val) (ref = val)
 #define sync_atomic_exchange_32(ref, val) InterlockedExchangeAcquire(&ref, val)
 #define sync_atomic_exchange_64(ref, val) InterlockedExchangeAcquire64(&ref, val)
+#define sync_atomic_cas_64(ref, expected, desired) sync_win32_cas_64(&(ref), &(expected), desired)
+
+    /* compare and swap, on failure 'expected' is updated with the current value (C11 semantic) */
+    static __inline bool sync_win32_cas_64(volatile long long* ref, long long* expected, long long desired)
+    {
+        const long long previous = InterlockedCompareExchange64(ref, desired, *expected);
+        const bool success = (previous == *expected);
+        *expected = previous;
+        return success;
+    }
 #else
 // fallback: assuming GCC/Clang
 #define sync_read_acquire() __sync_synchronize()
@@ -104,6 +147,9 @@ extern "C"
 #define sync_atomic_inc_64(ref) __sync_fetch_and_add(&(ref), 1)
 #define sync_atomic_dec_32(ref) __sync_fetch_and_sub(&(ref), 1)
 #define sync_atomic_dec_64(ref) __sync_fetch_and_sub(&(ref), 1)
+#define sync_atomic_add_64(ref, val) __sync_fetch_and_add(&(ref), val)
+#define sync_atomic_or_64(ref, val) __sync_fetch_and_or(&(ref), val)
+#define sync_atomic_and_64(ref, val) __sync_fetch_and_and(&(ref), val)
 #define sync_atomic_load(ref) (ref)
 #define sync_atomic_store(ref, val) (ref = val)
 #if defined(__clang__)
@@ -113,6 +159,88 @@ extern "C"
 #define sync_atomic_exchange_32(ref, val) __sync_lock_test_and_set(&ref, val)
 #define sync_atomic_exchange_64(ref, val) __sync_lock_test_and_set(&ref, val)
 #endif
+#define sync_atomic_cas_64(ref, expected, desired) sync_gcc_cas_64(&(ref), &(expected), desired)
+
+    /* compare and swap, on failure 'expected' is updated with the current value (C11 semantic) */
+    static inline bool sync_gcc_cas_64(volatile long long* ref, long long* expected, long long desired)
+    {
+        const long long previous = __sync_val_compare_and_swap(ref, *expected, desired);
+        const bool success = (previous == *expected);
+        *expected = previous;
+        return success;
+    }
+#endif
+
+/* spin-wait hint to the cpu (pause on x86, yield on arm) */
+#if defined(_WIN32)
+#define sync_cpu_relax() YieldProcessor()
+#elif defined(__i386__) || defined(__x86_64__)
+#define sync_cpu_relax() __builtin_ia32_pause()
+#elif defined(__aarch64__) || defined(__arm__)
+#define sync_cpu_relax() __asm__ __volatile__("yield")
+#else
+#define sync_cpu_relax() sync_read_write()
+#endif
+
+/* explicitly ordered operations, to use the weakest correct ordering on hot paths
+   (the unordered macros above are sequentially consistent) */
+#if !defined(__STDC_NO_ATOMICS__)
+#define sync_fence_acquire() atomic_thread_fence(memory_order_acquire)
+#define sync_fence_release() atomic_thread_fence(memory_order_release)
+#define sync_fence_acq_rel() atomic_thread_fence(memory_order_acq_rel)
+#define sync_fence_seq_cst() atomic_thread_fence(memory_order_seq_cst)
+#define sync_atomic_load_relaxed(ref) atomic_load_explicit(&(ref), memory_order_relaxed)
+#define sync_atomic_load_acquire(ref) atomic_load_explicit(&(ref), memory_order_acquire)
+#define sync_atomic_store_relaxed(ref, val) atomic_store_explicit(&(ref), val, memory_order_relaxed)
+#define sync_atomic_store_release(ref, val) atomic_store_explicit(&(ref), val, memory_order_release)
+#define sync_atomic_add_64_relaxed(ref, val) atomic_fetch_add_explicit(&(ref), val, memory_order_relaxed)
+#define sync_atomic_add_64_release(ref, val) atomic_fetch_add_explicit(&(ref), val, memory_order_release)
+#define sync_atomic_add_64_acq_rel(ref, val) atomic_fetch_add_explicit(&(ref), val, memory_order_acq_rel)
+#define sync_atomic_exchange_64_acq_rel(ref, val) atomic_exchange_explicit(&(ref), val, memory_order_acq_rel)
+#define sync_atomic_cas_64_relaxed(ref, expected, desired)                                                                                 \
+    atomic_compare_exchange_strong_explicit(&(ref), &(expected), desired, memory_order_relaxed, memory_order_relaxed)
+#define sync_atomic_cas_64_acq_rel(ref, expected, desired)                                                                                 \
+    atomic_compare_exchange_strong_explicit(&(ref), &(expected), desired, memory_order_acq_rel, memory_order_acquire)
+#elif defined(_WIN32)
+/* volatile accesses have acquire/release semantic with /volatile:ms (default on x86/x64, forced by cmake) */
+#if defined(_M_ARM) || defined(_M_ARM64)
+#define sync_fence_acquire() MemoryBarrier()
+#define sync_fence_release() MemoryBarrier()
+#define sync_fence_acq_rel() MemoryBarrier()
+#else
+#define sync_fence_acquire() _ReadWriteBarrier()
+#define sync_fence_release() _ReadWriteBarrier()
+#define sync_fence_acq_rel() _ReadWriteBarrier()
+#endif
+#define sync_fence_seq_cst() MemoryBarrier()
+#define sync_atomic_load_relaxed(ref) (ref)
+#define sync_atomic_load_acquire(ref) (ref)
+#define sync_atomic_store_relaxed(ref, val) (ref = val)
+#define sync_atomic_store_release(ref, val) (ref = val)
+#define sync_atomic_add_64_relaxed(ref, val) InterlockedExchangeAddNoFence64(&(ref), val)
+#define sync_atomic_add_64_release(ref, val) InterlockedExchangeAddRelease64(&(ref), val)
+#define sync_atomic_add_64_acq_rel(ref, val) InterlockedExchangeAdd64(&(ref), val)
+#define sync_atomic_exchange_64_acq_rel(ref, val) InterlockedExchange64(&(ref), val)
+#define sync_atomic_cas_64_relaxed(ref, expected, desired) sync_win32_cas_64(&(ref), &(expected), desired)
+#define sync_atomic_cas_64_acq_rel(ref, expected, desired) sync_win32_cas_64(&(ref), &(expected), desired)
+#else
+// fallback: assuming GCC/Clang __atomic builtins
+#define sync_fence_acquire() __atomic_thread_fence(__ATOMIC_ACQUIRE)
+#define sync_fence_release() __atomic_thread_fence(__ATOMIC_RELEASE)
+#define sync_fence_acq_rel() __atomic_thread_fence(__ATOMIC_ACQ_REL)
+#define sync_fence_seq_cst() __atomic_thread_fence(__ATOMIC_SEQ_CST)
+#define sync_atomic_load_relaxed(ref) __atomic_load_n(&(ref), __ATOMIC_RELAXED)
+#define sync_atomic_load_acquire(ref) __atomic_load_n(&(ref), __ATOMIC_ACQUIRE)
+#define sync_atomic_store_relaxed(ref, val) __atomic_store_n(&(ref), val, __ATOMIC_RELAXED)
+#define sync_atomic_store_release(ref, val) __atomic_store_n(&(ref), val, __ATOMIC_RELEASE)
+#define sync_atomic_add_64_relaxed(ref, val) __atomic_fetch_add(&(ref), val, __ATOMIC_RELAXED)
+#define sync_atomic_add_64_release(ref, val) __atomic_fetch_add(&(ref), val, __ATOMIC_RELEASE)
+#define sync_atomic_add_64_acq_rel(ref, val) __atomic_fetch_add(&(ref), val, __ATOMIC_ACQ_REL)
+#define sync_atomic_exchange_64_acq_rel(ref, val) __atomic_exchange_n(&(ref), val, __ATOMIC_ACQ_REL)
+#define sync_atomic_cas_64_relaxed(ref, expected, desired)                                                                                 \
+    __atomic_compare_exchange_n(&(ref), &(expected), desired, false, __ATOMIC_RELAXED, __ATOMIC_RELAXED)
+#define sync_atomic_cas_64_acq_rel(ref, expected, desired)                                                                                 \
+    __atomic_compare_exchange_n(&(ref), &(expected), desired, false, __ATOMIC_ACQ_REL, __ATOMIC_ACQUIRE)
 #endif
 
 #if defined(__cplusplus)
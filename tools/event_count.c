@@ -0,0 +1,285 @@
+//-----------------------------------------------------------------------------//
+// CRingBuffer MPMC - FIFO helper                                              //
+// (c) 2023 Laurent Lardinois https://be.linkedin.com/in/laurentlardinois      //
+//                                                                             //
+// https://github.com/type-one/CRingBuffer_MPSC                                //
+//                                                                             //
+// This software is provided 'as-is', without any express or implied           //
+// warranty.In no event will the authors be held liable for any damages        //
+// arising from the use of this software.                                      //
+//                                                                             //
+// Permission is granted to anyone to use this software for any purpose,       //
+// including commercial applications, and to alter itand redistribute it       //
+// freely, subject to the following restrictions :                             //
+//                                                                             //
+// 1. The origin of this software must not be misrepresented; you must not     //
+// claim that you wrote the original software.If you use this software         //
+// in a product, an acknowledgment in the product documentation would be       //
+// appreciated but is not required.                                            //
+// 2. Altered source versions must be plainly marked as such, and must not be  //
+// misrepresented as being the original software.                              //
+// 3. This notice may not be removed or altered from any source distribution.  //
+//-----------------------------------------------------------------------------//
+
+#include "atomic_helper.h"
+
+#define EVENT_COUNT_IMPLEM
+#include "event_count.h"
+
+#include <errno.h>
+#include <limits.h>
+#include <stdbool.h>
+#include <string.h>
+
+#if defined(_WIN32)
+#include <windows.h>
+#elif defined(__linux__)
+#include <linux/futex.h>
+#include <sys/syscall.h>
+#include <time.h>
+#include <unistd.h>
+#elif defined(__STDC_NO_THREADS__)
+#include <pthread.h>
+#include <time.h>
+#else
+#include <threads.h>
+#include <time.h>
+#endif
+
+
+#if defined(_WIN32)
+#define event_count_inc_epoch(ec) InterlockedIncrement((volatile LONG*)&((ec)->m_epoch))
+#else
+#define event_count_inc_epoch(ec) sync_atomic_inc_32((ec)->m_epoch)
+#endif
+
+#if !defined(_WIN32) && !defined(__linux__)
+static void event_count_deadline(struct timespec* deadline, clockid_t clock_id, unsigned long timeout_us)
+{
+    clock_gettime(clock_id, deadline);
+    deadline->tv_sec += (time_t)(timeout_us / 1000000UL);
+    deadline->tv_nsec += (long)(timeout_us % 1000000UL) * 1000L;
+    if (deadline->tv_nsec >= 1000000000L)
+    {
+        deadline->tv_sec += 1;
+        deadline->tv_nsec -= 1000000000L;
+    }
+}
+#endif
+
+int init_event_count(struct event_count* ec)
+{
+    if (!ec)
+    {
+        return -1;
+    }
+
+    memset(ec, 0, sizeof(struct event_count));
+    sync_atomic_store(ec->m_epoch, 0);
+    sync_atomic_store(ec->m_waiters, 0L);
+
+#if defined(_WIN32) || defined(__linux__)
+
+    return 0;
+
+#elif defined(__STDC_NO_THREADS__)
+    if (0 != pthread_mutex_init(&(ec->m_mutex), NULL))
+    {
+        return -1;
+    }
+
+    if (0 != pthread_condattr_init(&(ec->m_cond_attr)))
+    {
+        goto destroy_mutex;
+    }
+
+    if ((0 != pthread_condattr_setclock(&(ec->m_cond_attr), CLOCK_MONOTONIC)) || (0 != pthread_cond_init(&(ec->m_cond), &(ec->m_cond_attr))))
+    {
+        pthread_condattr_destroy(&(ec->m_cond_attr));
+        goto destroy_mutex;
+    }
+
+    return 0;
+
+destroy_mutex:
+    pthread_mutex_destroy(&(ec->m_mutex));
+
+    return -1;
+
+#else
+    if (thrd_success != mtx_init(&(ec->m_mutex), mtx_plain))
+    {
+        return -1;
+    }
+
+    if (thrd_success != cnd_init(&(ec->m_cond)))
+    {
+        mtx_destroy(&(ec->m_mutex));
+        return -1;
+    }
+
+    return 0;
+
+#endif
+}
+
+int deinit_event_count(struct event_count* ec)
+{
+    if (!ec)
+    {
+        return -1;
+    }
+
+    event_count_wake(ec, true);
+
+#if defined(_WIN32) || defined(__linux__)
+#elif defined(__STDC_NO_THREADS__)
+    pthread_cond_destroy(&(ec->m_cond));
+    pthread_condattr_destroy(&(ec->m_cond_attr));
+    pthread_mutex_destroy(&(ec->m_mutex));
+#else
+    cnd_destroy(&(ec->m_cond));
+    mtx_destroy(&(ec->m_mutex));
+#endif
+
+    return 0;
+}
+
+int event_count_prepare_wait(struct event_count* ec)
+{
+    /* register first, so that a notifier publishing after our condition check sees us */
+    sync_atomic_inc_32(ec->m_waiters);
+    return sync_atomic_load(ec->m_epoch);
+}
+
+void event_count_cancel_wait(struct event_count* ec)
+{
+    sync_atomic_dec_32(ec->m_waiters);
+}
+
+bool event_count_wait(struct event_count* ec, int key, unsigned long timeout_us)
+{
+    bool notified = true;
+
+#if defined(_WIN32)
+
+    const DWORD timeout_ms = (EVENT_COUNT_INFINITE == timeout_us) ? INFINITE : (DWORD)((timeout_us + 999UL) / 1000UL);
+    if (sync_atomic_load(ec->m_epoch) == key)
+    {
+        if (!WaitOnAddress((volatile VOID*)&(ec->m_epoch), &key, sizeof(key), timeout_ms))
+        {
+            notified = (ERROR_TIMEOUT != GetLastError());
+        }
+    }
+
+#elif defined(__linux__)
+
+    struct timespec timeout;
+    timeout.tv_sec = (time_t)(timeout_us / 1000000UL);
+    timeout.tv_nsec = (long)(timeout_us % 1000000UL) * 1000L;
+
+    /* returns immediately (EAGAIN) if the epoch already moved */
+    if (0 != syscall(SYS_futex, (int*)&(ec->m_epoch), FUTEX_WAIT_PRIVATE, key, (EVENT_COUNT_INFINITE == timeout_us) ? NULL : &timeout, NULL, 0))
+    {
+        notified = (ETIMEDOUT != errno);
+    }
+
+#elif defined(__STDC_NO_THREADS__)
+
+    struct timespec deadline;
+    event_count_deadline(&deadline, CLOCK_MONOTONIC, timeout_us);
+
+    pthread_mutex_lock(&(ec->m_mutex));
+    while (sync_atomic_load(ec->m_epoch) == key) /* loop to detect spurious wakes */
+    {
+        const int ret = (EVENT_COUNT_INFINITE == timeout_us) ? pthread_cond_wait(&(ec->m_cond), &(ec->m_mutex))
+                                                             : pthread_cond_timedwait(&(ec->m_cond), &(ec->m_mutex), &deadline);
+        if (0 != ret)
+        {
+            notified = (sync_atomic_load(ec->m_epoch) != key);
+            break; // timeout (returned ETIMEDOUT) or other error
+        }
+    }
+    pthread_mutex_unlock(&(ec->m_mutex));
+
+#else
+
+    struct timespec deadline;
+    event_count_deadline(&deadline, CLOCK_REALTIME, timeout_us); /* cnd_timedwait uses TIME_UTC */
+
+    mtx_lock(&(ec->m_mutex));
+    while (sync_atomic_load(ec->m_epoch) == key) /* loop to detect spurious wakes */
+    {
+        const int ret = (EVENT_COUNT_INFINITE == timeout_us) ? cnd_wait(&(ec->m_cond), &(ec->m_mutex))
+                                                             : cnd_timedwait(&(ec->m_cond), &(ec->m_mutex), &deadline);
+        if (thrd_success != ret)
+        {
+            notified = (sync_atomic_load(ec->m_epoch) != key);
+            break; // timeout or other error
+        }
+    }
+    mtx_unlock(&(ec->m_mutex));
+
+#endif
+
+    sync_atomic_dec_32(ec->m_waiters);
+
+    return notified;
+}
+
+void event_count_wake(struct event_count* ec, bool all)
+{
+    if (!ec)
+    {
+        return;
+    }
+
+#if defined(_WIN32)
+
+    event_count_inc_epoch(ec);
+    if (all)
+    {
+        WakeByAddressAll((PVOID) & (ec->m_epoch));
+    }
+    else
+    {
+        WakeByAddressSingle((PVOID) & (ec->m_epoch));
+    }
+
+#elif defined(__linux__)
+
+    event_count_inc_epoch(ec);
+    syscall(SYS_futex, (int*)&(ec->m_epoch), FUTEX_WAKE_PRIVATE, all ? INT_MAX : 1, NULL, NULL, 0);
+
+#elif defined(__STDC_NO_THREADS__)
+
+    pthread_mutex_lock(&(ec->m_mutex));
+    event_count_inc_epoch(ec);
+    pthread_mutex_unlock(&(ec->m_mutex));
+
+    if (all)
+    {
+        pthread_cond_broadcast(&(ec->m_cond));
+    }
+    else
+    {
+        pthread_cond_signal(&(ec->m_cond));
+    }
+
+#else
+
+    mtx_lock(&(ec->m_mutex));
+    event_count_inc_epoch(ec);
+    mtx_unlock(&(ec->m_mutex));
+
+    if (all)
+    {
+        cnd_broadcast(&(ec->m_cond));
+    }
+    else
+    {
+        cnd_signal(&(ec->m_cond));
+    }
+
+#endif
+}
@@ -0,0 +1,117 @@
+//-----------------------------------------------------------------------------//
+// CRingBuffer MPMC - FIFO helper                                              //
+// (c) 2023 Laurent Lardinois https://be.linkedin.com/in/laurentlardinois      //
+//                                                                             //
+// https://github.com/type-one/CRingBuffer_MPSC                                //
+//                                                                             //
+// This software is provided 'as-is', without any express or implied           //
+// warranty.In no event will the authors be held liable for any damages        //
+// arising from the use of this software.                                      //
+//                                                                             //
+// Permission is granted to anyone to use this software for any purpose,       //
+// including commercial applications, and to alter itand redistribute it       //
+// freely, subject to the following restrictions :                             //
+//                                                                             //
+// 1. The origin of this software must not be misrepresented; you must not     //
+// claim that you wrote the original software.If you use this software         //
+// in a product, an acknowledgment in the product documentation would be       //
+// appreciated but is not required.                                            //
+// 2. Altered source versions must be plainly marked as such, and must not be  //
+// misrepresented as being the original software.                              //
+// 3. This notice may not be removed or altered from any source distribution.  //
+//-----------------------------------------------------------------------------//
+
+#pragma once
+
+#if !defined(__EVENT_COUNT_H__)
+#define __EVENT_COUNT_H__
+
+#include "atomic_helper.h"
+
+#include <stdbool.h>
+
+#if defined(_WIN32)
+#include <windows.h>
+#elif defined(__linux__)
+#include <unistd.h>
+#elif defined(__STDC_NO_THREADS__)
+#include <pthread.h>
+#else
+#include <threads.h>
+#endif
+
+#if defined(__cplusplus)
+extern "C"
+{
+#endif
+
+    /* eventcount: lets a thread park until a condition it polls becomes true, notifiers only pay a
+       load of the waiter count when nobody is parked (no syscall, no mutex on the fast path).
+       parking uses futex on linux, WaitOnAddress on win32 and a mutex/condition pair elsewhere.
+
+       waiter:   key = event_count_prepare_wait(ec);
+                 if (condition) { event_count_cancel_wait(ec); } else { event_count_wait(ec, key, timeout_us); }
+       notifier: make condition true with a sequentially consistent operation, then event_count_notify_xxx(ec) */
+
+#define EVENT_COUNT_INFINITE (~0UL)
+
+    struct event_count
+    {
+        _atomic_int m_epoch; /* futex word */
+        _atomic_long m_waiters;
+
+#if defined(_WIN32) || defined(__linux__)
+#elif defined(__STDC_NO_THREADS__)
+    pthread_mutex_t m_mutex;
+    pthread_cond_t m_cond;
+    pthread_condattr_t m_cond_attr;
+#else
+    mtx_t m_mutex;
+    cnd_t m_cond;
+#endif
+    };
+
+#if defined(EVENT_COUNT_IMPLEM)
+#define EXTERN_EVENT_COUNT
+#else
+#define EXTERN_EVENT_COUNT extern
+#endif
+
+    EXTERN_EVENT_COUNT int init_event_count(struct event_count* ec);
+    EXTERN_EVENT_COUNT int deinit_event_count(struct event_count* ec);
+
+    EXTERN_EVENT_COUNT int event_count_prepare_wait(struct event_count* ec);
+    EXTERN_EVENT_COUNT void event_count_cancel_wait(struct event_count* ec);
+    /* park while no notification happened since prepare_wait, return false on timeout */
+    EXTERN_EVENT_COUNT bool event_count_wait(struct event_count* ec, int key, unsigned long timeout_us);
+
+    EXTERN_EVENT_COUNT void event_count_wake(struct event_count* ec, bool all);
+
+    /* fast path inlined: nothing to do when nobody is parked */
+    static inline void event_count_notify_one(struct event_count* ec)
+    {
+#if defined(__STDC_NO_ATOMICS__)
+        sync_fence_seq_cst(); /* volatile stores of the condition could pass the waiter count load */
+#endif
+        if (sync_atomic_load(ec->m_waiters) > 0)
+        {
+            event_count_wake(ec, false);
+        }
+    }
+
+    static inline void event_count_notify_all(struct event_count* ec)
+    {
+#if defined(__STDC_NO_ATOMICS__)
+        sync_fence_seq_cst();
+#endif
+        if (sync_atomic_load(ec->m_waiters) > 0)
+        {
+            event_count_wake(ec, true);
+        }
+    }
+
+#if defined(__cplusplus)
+};
+#endif
+
+#endif //  __EVENT_COUNT_H__
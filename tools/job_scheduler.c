@@ -0,0 +1,266 @@
+//-----------------------------------------------------------------------------//
+// CRingBuffer MPMC - FIFO helper                                              //
+// (c) 2023 Laurent Lardinois https://be.linkedin.com/in/laurentlardinois      //
+//                                                                             //
+// https://github.com/type-one/CRingBuffer_MPSC                                //
+//                                                                             //
+// This software is provided 'as-is', without any express or implied           //
+// warranty.In no event will the authors be held liable for any damages        //
+// arising from the use of this software.                                      //
+//                                                                             //
+// Permission is granted to anyone to use this software for any purpose,       //
+// including commercial applications, and to alter itand redistribute it       //
+// freely, subject to the following restrictions :                             //
+//                                                                             //
+// 1. The origin of this software must not be misrepresented; you must not     //
+// claim that you wrote the original software.If you use this software         //
+// in a product, an acknowledgment in the product documentation would be       //
+// appreciated but is not required.                                            //
+// 2. Altered source versions must be plainly marked as such, and must not be  //
+// misrepresented as being the original software.                              //
+// 3. This notice may not be removed or altered from any source distribution.  //
+//-----------------------------------------------------------------------------//
+
+#include "atomic_helper.h"
+#define JOB_SCHEDULER_IMPLEM
+#include "job_scheduler.h"
+#include "ring_buffer_mpmc_inline.h"
+#include "sync_object.h"
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#if defined(_WIN32)
+#include <windows.h>
+#elif defined(__STDC_NO_THREADS__)
+#include <pthread.h>
+#include <sched.h>
+#else
+#include <threads.h>
+#endif
+
+/* queued by value in the inline ring */
+struct job
+{
+    job_func m_func;
+    void* m_arg;
+    struct job_counter* m_counter;
+};
+
+/* counter of the job running on the calling thread, inherited by its children */
+static THREAD_LOCAL struct job_counter* st_current_counter;
+
+
+static void job_scheduler_yield(void)
+{
+#if defined(_WIN32)
+    Sleep(0);
+#elif defined(__STDC_NO_THREADS__)
+    sched_yield();
+#else
+    thrd_yield();
+#endif
+}
+
+static void job_scheduler_run(struct job_scheduler* scheduler, const struct job* job)
+{
+    struct job_counter* parent_counter = st_current_counter;
+
+    st_current_counter = job->m_counter;
+    job->m_func(scheduler, job->m_arg);
+    st_current_counter = parent_counter;
+
+    if (job->m_counter)
+    {
+        sync_atomic_dec_32(job->m_counter->m_pending);
+    }
+}
+
+static bool job_scheduler_run_one(struct job_scheduler* scheduler)
+{
+    struct job job;
+
+    if (!ring_buffer_inline_pop(&(scheduler->m_jobs), &job))
+    {
+        return false;
+    }
+
+    job_scheduler_run(scheduler, &job);
+
+    return true;
+}
+
+static void job_scheduler_worker(void* arg)
+{
+    struct job_scheduler* scheduler = (struct job_scheduler*)arg;
+
+    for (;;)
+    {
+        if (job_scheduler_run_one(scheduler))
+        {
+            continue;
+        }
+
+        /* queue drained after a stop request */
+        if (sync_atomic_load_acquire(scheduler->m_stop))
+        {
+            break;
+        }
+
+        bool found = false;
+        for (int spin = 0; (spin < JOB_SCHEDULER_SPINS) && !found; ++spin)
+        {
+            sync_cpu_relax();
+            found = job_scheduler_run_one(scheduler);
+        }
+
+        if (found)
+        {
+            continue;
+        }
+
+        /* announce the park then check again, a submitter either sees m_idle or its job is found here */
+        sync_atomic_inc_32(scheduler->m_idle);
+        sync_fence_seq_cst();
+
+        if (!job_scheduler_run_one(scheduler) && !sync_atomic_load_acquire(scheduler->m_stop))
+        {
+            (void)sync_object_wait_for_signal_timed(&(scheduler->m_wake), JOB_SCHEDULER_PARK_TIMEOUT_US);
+        }
+
+        sync_atomic_dec_32(scheduler->m_idle);
+    }
+}
+
+static void job_scheduler_join(struct job_scheduler* scheduler, int nb_threads)
+{
+    sync_atomic_store_release(scheduler->m_stop, true);
+    (void)sync_object_broadcast(&(scheduler->m_wake));
+
+    for (int i = 0; i < nb_threads; ++i)
+    {
+        (void)join_thread(&(scheduler->m_threads[i]));
+    }
+}
+
+void init_job_counter(struct job_counter* counter)
+{
+    if (counter)
+    {
+        sync_atomic_store(counter->m_pending, 0L);
+    }
+}
+
+int init_job_scheduler(struct job_scheduler* scheduler, int nb_workers)
+{
+    return init_job_scheduler_ex(scheduler, nb_workers, RING_BUFFER_SIZE);
+}
+
+int init_job_scheduler_ex(struct job_scheduler* scheduler, int nb_workers, unsigned long long capacity)
+{
+    if (!scheduler || (nb_workers <= 0) || (nb_workers > JOB_SCHEDULER_MAX_WORKERS))
+    {
+        return -1;
+    }
+
+    if (init_ring_buffer_mpmc_inline_ex(&(scheduler->m_jobs), capacity, sizeof(struct job), NULL) < 0)
+    {
+        return -1;
+    }
+
+    if (init_sync_object(&(scheduler->m_wake), false) < 0)
+    {
+        (void)deinit_ring_buffer_mpmc_inline(&(scheduler->m_jobs));
+        return -1;
+    }
+
+    scheduler->m_nb_workers = 0;
+    sync_atomic_store(scheduler->m_idle, 0);
+    sync_atomic_store(scheduler->m_stop, false);
+    sync_write_release();
+
+    for (int i = 0; i < nb_workers; ++i)
+    {
+        if (start_thread(&(scheduler->m_threads[i]), job_scheduler_worker, scheduler, NULL) < 0)
+        {
+            job_scheduler_join(scheduler, i);
+            (void)deinit_sync_object(&(scheduler->m_wake));
+            (void)deinit_ring_buffer_mpmc_inline(&(scheduler->m_jobs));
+            return -1;
+        }
+
+        ++scheduler->m_nb_workers;
+    }
+
+    return 0;
+}
+
+int deinit_job_scheduler(struct job_scheduler* scheduler)
+{
+    if (!scheduler)
+    {
+        return -1;
+    }
+
+    job_scheduler_join(scheduler, scheduler->m_nb_workers);
+    scheduler->m_nb_workers = 0;
+
+    (void)deinit_sync_object(&(scheduler->m_wake));
+    (void)deinit_ring_buffer_mpmc_inline(&(scheduler->m_jobs));
+
+    return 0;
+}
+
+bool job_scheduler_submit(struct job_scheduler* scheduler, job_func func, void* arg, struct job_counter* counter)
+{
+    if (!scheduler || !func)
+    {
+        return false;
+    }
+
+    const struct job job = { func, arg, counter };
+
+    if (counter)
+    {
+        sync_atomic_inc_32(counter->m_pending);
+    }
+
+    if (!ring_buffer_inline_push(&(scheduler->m_jobs), &job))
+    {
+        /* queue full, the caller runs the job rather than waiting for a worker */
+        job_scheduler_run(scheduler, &job);
+        return true;
+    }
+
+    /* wake a parked worker, no syscall while all the workers are busy or spinning */
+    sync_fence_seq_cst();
+    if (sync_atomic_load(scheduler->m_idle) > 0)
+    {
+        (void)sync_object_signal(&(scheduler->m_wake));
+    }
+
+    return true;
+}
+
+bool job_scheduler_submit_child(struct job_scheduler* scheduler, job_func func, void* arg)
+{
+    return job_scheduler_submit(scheduler, func, arg, st_current_counter);
+}
+
+void job_scheduler_wait(struct job_scheduler* scheduler, struct job_counter* counter)
+{
+    if (!scheduler || !counter)
+    {
+        return;
+    }
+
+    while (sync_atomic_load(counter->m_pending) > 0)
+    {
+        /* help instead of blocking, a job waiting for its children cannot starve the workers */
+        if (!job_scheduler_run_one(scheduler))
+        {
+            job_scheduler_yield();
+        }
+    }
+}
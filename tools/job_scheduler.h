@@ -0,0 +1,106 @@
+//-----------------------------------------------------------------------------//
+// CRingBuffer MPMC - FIFO helper                                              //
+// (c) 2023 Laurent Lardinois https://be.linkedin.com/in/laurentlardinois      //
+//                                                                             //
+// https://github.com/type-one/CRingBuffer_MPSC                                //
+//                                                                             //
+// This software is provided 'as-is', without any express or implied           //
+// warranty.In no event will the authors be held liable for any damages        //
+// arising from the use of this software.                                      //
+//                                                                             //
+// Permission is granted to anyone to use this software for any purpose,       //
+// including commercial applications, and to alter itand redistribute it       //
+// freely, subject to the following restrictions :                             //
+//                                                                             //
+// 1. The origin of this software must not be misrepresented; you must not     //
+// claim that you wrote the original software.If you use this software         //
+// in a product, an acknowledgment in the product documentation would be       //
+// appreciated but is not required.                                            //
+// 2. Altered source versions must be plainly marked as such, and must not be  //
+// misrepresented as being the original software.                              //
+// 3. This notice may not be removed or altered from any source distribution.  //
+//-----------------------------------------------------------------------------//
+
+#pragma once
+
+#if !defined(__JOB_SCHEDULER_H__)
+#define __JOB_SCHEDULER_H__
+
+#include "atomic_helper.h"
+#include "ring_buffer_mpmc_inline.h"
+#include "sync_object.h"
+#include "thread_helper.h"
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#if defined(JOB_SCHEDULER_IMPLEM)
+#define EXTERN_JOB_SCHEDULER
+#else
+#define EXTERN_JOB_SCHEDULER extern
+#endif
+
+#if defined(__cplusplus)
+extern "C"
+{
+#endif
+
+    /* fixed pool of worker threads running jobs (function pointer + argument) taken from a shared
+       ring_buffer_mpmc_inline, jobs are copied by value so that submitting does not allocate,
+       idle workers retry JOB_SCHEDULER_SPINS times then park on a sync_object, woken by the
+       submitters only when a worker is parked */
+
+#define JOB_SCHEDULER_MAX_WORKERS 64
+#define JOB_SCHEDULER_SPINS 256         /* retries (with a cpu relax hint) before an idle worker parks */
+#define JOB_SCHEDULER_PARK_TIMEOUT_US 10000UL /* a parked worker also wakes up on its own after this delay */
+
+    struct job_scheduler;
+
+    typedef void (*job_func)(struct job_scheduler* scheduler, void* arg);
+
+    /* number of submitted jobs not yet completed, child jobs included */
+    struct job_counter
+    {
+        _atomic_long m_pending;
+    };
+
+    struct job_scheduler
+    {
+        struct ring_buffer_mpmc_inline m_jobs;
+        struct sync_object m_wake;
+        int m_nb_workers;
+
+        RING_BUFFER_ALIGNED _atomic_int m_idle; /* workers parked or about to park */
+        _atomic_bool m_stop;
+
+        struct thread_handle m_threads[JOB_SCHEDULER_MAX_WORKERS];
+    };
+
+    EXTERN_JOB_SCHEDULER void init_job_counter(struct job_counter* counter);
+
+    /* nb_workers threads (up to JOB_SCHEDULER_MAX_WORKERS), queue of RING_BUFFER_SIZE jobs */
+    EXTERN_JOB_SCHEDULER int init_job_scheduler(struct job_scheduler* scheduler, int nb_workers);
+
+    /* capacity must be a power of two */
+    EXTERN_JOB_SCHEDULER int init_job_scheduler_ex(struct job_scheduler* scheduler, int nb_workers, unsigned long long capacity);
+
+    /* runs the jobs still queued then joins the workers */
+    EXTERN_JOB_SCHEDULER int deinit_job_scheduler(struct job_scheduler* scheduler);
+
+    /* counter can be NULL, the job is run by the calling thread when the queue is full */
+    EXTERN_JOB_SCHEDULER bool job_scheduler_submit(struct job_scheduler* scheduler, job_func func, void* arg, struct job_counter* counter);
+
+    /* from inside a job, the child is accounted on the counter of the running job, so that waiting
+       on a counter covers the whole tree of jobs */
+    EXTERN_JOB_SCHEDULER bool job_scheduler_submit_child(struct job_scheduler* scheduler, job_func func, void* arg);
+
+    /* the calling thread runs queued jobs until the counter drops to zero, can be called from a job
+       (a job waiting for its own children submits them on a counter of its own, not as children) */
+    EXTERN_JOB_SCHEDULER void job_scheduler_wait(struct job_scheduler* scheduler, struct job_counter* counter);
+
+#if defined(__cplusplus)
+};
+#endif
+
+#endif /*  __JOB_SCHEDULER_H__ */
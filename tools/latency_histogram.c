@@ -0,0 +1,153 @@
+//-----------------------------------------------------------------------------//
+// CRingBuffer MPMC - FIFO helper                                              //
+// (c) 2023 Laurent Lardinois https://be.linkedin.com/in/laurentlardinois      //
+//                                                                             //
+// https://github.com/type-one/CRingBuffer_MPSC                                //
+//                                                                             //
+// This software is provided 'as-is', without any express or implied           //
+// warranty.In no event will the authors be held liable for any damages        //
+// arising from the use of this software.                                      //
+//                                                                             //
+// Permission is granted to anyone to use this software for any purpose,       //
+// including commercial applications, and to alter itand redistribute it       //
+// freely, subject to the following restrictions :                             //
+//                                                                             //
+// 1. The origin of this software must not be misrepresented; you must not     //
+// claim that you wrote the original software.If you use this software         //
+// in a product, an acknowledgment in the product documentation would be       //
+// appreciated but is not required.                                            //
+// 2. Altered source versions must be plainly marked as such, and must not be  //
+// misrepresented as being the original software.                              //
+// 3. This notice may not be removed or altered from any source distribution.  //
+//-----------------------------------------------------------------------------//
+
+#define LATENCY_HISTOGRAM_IMPLEM
+#include "latency_histogram.h"
+
+#include <stdint.h>
+#include <string.h>
+
+
+static unsigned int latency_histogram_msb(uint64_t value)
+{
+    unsigned int msb = 0U;
+    while (value >>= 1U)
+    {
+        ++msb;
+    }
+    return msb;
+}
+
+static unsigned int latency_histogram_bucket(uint64_t duration_ns)
+{
+    if (duration_ns < LATENCY_HISTOGRAM_SUB_COUNT)
+    {
+        return (unsigned int)duration_ns;
+    }
+
+    unsigned int msb = latency_histogram_msb(duration_ns);
+    if (msb >= LATENCY_HISTOGRAM_MAX_BITS)
+    {
+        return LATENCY_HISTOGRAM_BUCKETS - 1U;
+    }
+
+    /* leading sub bits below the most significant one select the linear bucket */
+    const unsigned int shift = msb - LATENCY_HISTOGRAM_SUB_BITS;
+    const unsigned int sub = (unsigned int)(duration_ns >> shift) & (LATENCY_HISTOGRAM_SUB_COUNT - 1U);
+
+    return (shift + 1U) * LATENCY_HISTOGRAM_SUB_COUNT + sub;
+}
+
+static uint64_t latency_histogram_bucket_upper_bound(unsigned int bucket)
+{
+    if (bucket < LATENCY_HISTOGRAM_SUB_COUNT)
+    {
+        return bucket;
+    }
+
+    const unsigned int shift = bucket / LATENCY_HISTOGRAM_SUB_COUNT - 1U;
+    const uint64_t sub = bucket % LATENCY_HISTOGRAM_SUB_COUNT;
+
+    return (((uint64_t)LATENCY_HISTOGRAM_SUB_COUNT + sub + 1U) << shift) - 1U;
+}
+
+void latency_histogram_reset(struct latency_histogram* histogram)
+{
+    if (histogram)
+    {
+        memset(histogram, 0, sizeof(struct latency_histogram));
+    }
+}
+
+void latency_histogram_record(struct latency_histogram* histogram, uint64_t duration_ns)
+{
+    ++(histogram->m_counts[latency_histogram_bucket(duration_ns)]);
+    ++(histogram->m_total);
+
+    if (duration_ns > histogram->m_max_ns)
+    {
+        histogram->m_max_ns = duration_ns;
+    }
+}
+
+void latency_histogram_merge(struct latency_histogram* dst, const struct latency_histogram* src)
+{
+    if (!dst || !src)
+    {
+        return;
+    }
+
+    for (unsigned int i = 0U; i < LATENCY_HISTOGRAM_BUCKETS; ++i)
+    {
+        dst->m_counts[i] += src->m_counts[i];
+    }
+
+    dst->m_total += src->m_total;
+
+    if (src->m_max_ns > dst->m_max_ns)
+    {
+        dst->m_max_ns = src->m_max_ns;
+    }
+}
+
+uint64_t latency_histogram_percentile(const struct latency_histogram* histogram, double percentile)
+{
+    if (!histogram || (0U == histogram->m_total))
+    {
+        return 0U;
+    }
+
+    /* rank of the requested sample, 1 based */
+    uint64_t rank = (uint64_t)((percentile / 100.0) * (double)histogram->m_total + 0.5);
+    if (rank < 1U)
+    {
+        rank = 1U;
+    }
+
+    uint64_t count = 0U;
+    for (unsigned int i = 0U; i < LATENCY_HISTOGRAM_BUCKETS; ++i)
+    {
+        count += histogram->m_counts[i];
+        if (count >= rank)
+        {
+            const uint64_t upper_bound = latency_histogram_bucket_upper_bound(i);
+            return (upper_bound < histogram->m_max_ns) ? upper_bound : histogram->m_max_ns;
+        }
+    }
+
+    return histogram->m_max_ns;
+}
+
+void latency_histogram_summary(const struct latency_histogram* histogram, struct latency_summary* summary)
+{
+    if (!histogram || !summary)
+    {
+        return;
+    }
+
+    summary->m_count = histogram->m_total;
+    summary->m_p50_ns = latency_histogram_percentile(histogram, 50.0);
+    summary->m_p99_ns = latency_histogram_percentile(histogram, 99.0);
+    summary->m_p999_ns = latency_histogram_percentile(histogram, 99.9);
+    summary->m_max_ns = histogram->m_max_ns;
+}
@@ -0,0 +1,79 @@
+//-----------------------------------------------------------------------------//
+// CRingBuffer MPMC - FIFO helper                                              //
+// (c) 2023 Laurent Lardinois https://be.linkedin.com/in/laurentlardinois      //
+//                                                                             //
+// https://github.com/type-one/CRingBuffer_MPSC                                //
+//                                                                             //
+// This software is provided 'as-is', without any express or implied           //
+// warranty.In no event will the authors be held liable for any damages        //
+// arising from the use of this software.                                      //
+//                                                                             //
+// Permission is granted to anyone to use this software for any purpose,       //
+// including commercial applications, and to alter itand redistribute it       //
+// freely, subject to the following restrictions :                             //
+//                                                                             //
+// 1. The origin of this software must not be misrepresented; you must not     //
+// claim that you wrote the original software.If you use this software         //
+// in a product, an acknowledgment in the product documentation would be       //
+// appreciated but is not required.                                            //
+// 2. Altered source versions must be plainly marked as such, and must not be  //
+// misrepresented as being the original software.                              //
+// 3. This notice may not be removed or altered from any source distribution.  //
+//-----------------------------------------------------------------------------//
+
+#pragma once
+
+#if !defined(__LATENCY_HISTOGRAM_H__)
+#define __LATENCY_HISTOGRAM_H__
+
+#include <stdint.h>
+
+#if defined(LATENCY_HISTOGRAM_IMPLEM)
+#define EXTERN_LATENCY_HISTOGRAM
+#else
+#define EXTERN_LATENCY_HISTOGRAM extern
+#endif
+
+#if defined(__cplusplus)
+extern "C"
+{
+#endif
+
+/* log-linear (HDR style) histogram of durations in ns: values below 2^LATENCY_HISTOGRAM_SUB_BITS
+   have their own bucket, above each power of two range is split in 2^LATENCY_HISTOGRAM_SUB_BITS
+   linear buckets (relative error below 1/2^LATENCY_HISTOGRAM_SUB_BITS) */
+#define LATENCY_HISTOGRAM_SUB_BITS 4U
+#define LATENCY_HISTOGRAM_SUB_COUNT (1U << LATENCY_HISTOGRAM_SUB_BITS)
+#define LATENCY_HISTOGRAM_MAX_BITS 48U /* up to ~78 hours, longer durations are clamped */
+#define LATENCY_HISTOGRAM_BUCKETS ((LATENCY_HISTOGRAM_MAX_BITS - LATENCY_HISTOGRAM_SUB_BITS + 1U) * LATENCY_HISTOGRAM_SUB_COUNT)
+
+    /* not synchronized, one writer (owner thread) at a time, readers get approximate values */
+    struct latency_histogram
+    {
+        uint64_t m_counts[LATENCY_HISTOGRAM_BUCKETS];
+        uint64_t m_total;
+        uint64_t m_max_ns;
+    };
+
+    struct latency_summary
+    {
+        uint64_t m_count;
+        uint64_t m_p50_ns;
+        uint64_t m_p99_ns;
+        uint64_t m_p999_ns;
+        uint64_t m_max_ns;
+    };
+
+    EXTERN_LATENCY_HISTOGRAM void latency_histogram_reset(struct latency_histogram* histogram);
+    EXTERN_LATENCY_HISTOGRAM void latency_histogram_record(struct latency_histogram* histogram, uint64_t duration_ns);
+    EXTERN_LATENCY_HISTOGRAM void latency_histogram_merge(struct latency_histogram* dst, const struct latency_histogram* src);
+
+    /* percentile in [0, 100], returns the upper bound of the matching bucket (0 if empty) */
+    EXTERN_LATENCY_HISTOGRAM uint64_t latency_histogram_percentile(const struct latency_histogram* histogram, double percentile);
+    EXTERN_LATENCY_HISTOGRAM void latency_histogram_summary(const struct latency_histogram* histogram, struct latency_summary* summary);
+
+#if defined(__cplusplus)
+};
+#endif
+
+#endif /*  __LATENCY_HISTOGRAM_H__ */
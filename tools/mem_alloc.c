@@ -0,0 +1,235 @@
+//-----------------------------------------------------------------------------//
+// CRingBuffer MPMC - FIFO helper                                              //
+// (c) 2023 Laurent Lardinois https://be.linkedin.com/in/laurentlardinois      //
+//                                                                             //
+// https://github.com/type-one/CRingBuffer_MPSC                                //
+//                                                                             //
+// This software is provided 'as-is', without any express or implied           //
+// warranty.In no event will the authors be held liable for any damages        //
+// arising from the use of this software.                                      //
+//                                                                             //
+// Permission is granted to anyone to use this software for any purpose,       //
+// including commercial applications, and to alter itand redistribute it       //
+// freely, subject to the following restrictions :                             //
+//                                                                             //
+// 1. The origin of this software must not be misrepresented; you must not     //
+// claim that you wrote the original software.If you use this software         //
+// in a product, an acknowledgment in the product documentation would be       //
+// appreciated but is not required.                                            //
+// 2. Altered source versions must be plainly marked as such, and must not be  //
+// misrepresented as being the original software.                              //
+// 3. This notice may not be removed or altered from any source distribution.  //
+//-----------------------------------------------------------------------------//
+
+#define MEM_ALLOC_IMPLEM
+#include "mem_alloc.h"
+
+#include <stddef.h>
+#include <stdint.h>
+#include <stdlib.h>
+
+#if defined(_WIN32)
+#include <malloc.h>
+#include <windows.h>
+#else
+#include <sys/mman.h>
+#include <unistd.h>
+#if defined(__linux__)
+#include <errno.h>
+#include <sys/syscall.h>
+#endif
+#endif
+
+void* mem_alloc_aligned(size_t size, size_t alignment)
+{
+    if ((0U == size) || (0U == alignment) || (0U != (alignment & (alignment - 1U))))
+    {
+        return NULL;
+    }
+
+    /* posix_memalign requires at least the alignment of a pointer */
+    if (alignment < sizeof(void*))
+    {
+        alignment = sizeof(void*);
+    }
+
+#if defined(_WIN32)
+    return _aligned_malloc(size, alignment);
+#else
+    void* ptr = NULL;
+    if (0 != posix_memalign(&ptr, alignment, size))
+    {
+        return NULL;
+    }
+    return ptr;
+#endif
+}
+
+void mem_free_aligned(void* ptr)
+{
+#if defined(_WIN32)
+    _aligned_free(ptr);
+#else
+    free(ptr);
+#endif
+}
+
+/* the mapping length, rounded so that huge pages can back it */
+static size_t mem_alloc_pages_length(size_t size, int flags)
+{
+    const size_t granularity = (0 != (flags & MEM_ALLOC_HUGE_PAGES)) ? (size_t)MEM_ALLOC_HUGE_PAGE_SIZE : (size_t)4096U;
+
+    return (size + granularity - 1U) & ~(granularity - 1U);
+}
+
+static void mem_alloc_prefault(void* ptr, size_t length)
+{
+    volatile unsigned char* pages = (volatile unsigned char*)ptr;
+
+    /* a write (not a read) so the page is really allocated, not mapped to the shared zero page */
+    for (size_t i = 0U; i < length; i += 4096U)
+    {
+        pages[i] = 0U;
+    }
+}
+
+#if defined(_WIN32)
+
+void* mem_alloc_pages(size_t size, int flags, int numa_node)
+{
+    if (0U == size)
+    {
+        return NULL;
+    }
+
+    const size_t length = mem_alloc_pages_length(size, flags);
+    const DWORD node = (numa_node >= 0) ? (DWORD)numa_node : NUMA_NO_PREFERRED_NODE;
+    void* ptr = NULL;
+
+    /* large pages need SeLockMemoryPrivilege, fall back to regular pages without it */
+    if ((0 != (flags & MEM_ALLOC_HUGE_PAGES)) && (0U != GetLargePageMinimum()))
+    {
+        const SIZE_T large = (length + GetLargePageMinimum() - 1U) & ~(GetLargePageMinimum() - 1U);
+        ptr = VirtualAllocExNuma(GetCurrentProcess(), NULL, large, MEM_RESERVE | MEM_COMMIT | MEM_LARGE_PAGES, PAGE_READWRITE, node);
+    }
+
+    if (!ptr)
+    {
+        ptr = VirtualAllocExNuma(GetCurrentProcess(), NULL, length, MEM_RESERVE | MEM_COMMIT, PAGE_READWRITE, node);
+    }
+
+    if (ptr && (0 != (flags & MEM_ALLOC_PREFAULT)))
+    {
+        mem_alloc_prefault(ptr, length);
+    }
+
+    return ptr;
+}
+
+void mem_free_pages(void* ptr, size_t size, int flags)
+{
+    (void)size;
+    (void)flags;
+
+    if (ptr)
+    {
+        VirtualFree(ptr, 0, MEM_RELEASE);
+    }
+}
+
+#else
+
+void* mem_alloc_pages(size_t size, int flags, int numa_node)
+{
+    if (0U == size)
+    {
+        return NULL;
+    }
+
+    const size_t length = mem_alloc_pages_length(size, flags);
+    void* ptr = MAP_FAILED;
+
+#if defined(MAP_HUGETLB)
+    /* explicit huge pages, only if some were reserved (vm.nr_hugepages) */
+    if (0 != (flags & MEM_ALLOC_HUGE_PAGES))
+    {
+        ptr = mmap(NULL, length, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS | MAP_HUGETLB, -1, 0);
+    }
+#endif
+
+    if (MAP_FAILED == ptr)
+    {
+        if (0 != (flags & MEM_ALLOC_HUGE_PAGES))
+        {
+            /* over-allocate to trim the mapping on a huge page boundary, for the transparent huge pages */
+            const size_t huge = (size_t)MEM_ALLOC_HUGE_PAGE_SIZE;
+            unsigned char* raw = (unsigned char*)mmap(NULL, length + huge, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+
+            if (MAP_FAILED == (void*)raw)
+            {
+                return NULL;
+            }
+
+            unsigned char* aligned = (unsigned char*)(((uintptr_t)raw + huge - 1U) & ~((uintptr_t)huge - 1U));
+            if (aligned > raw)
+            {
+                munmap(raw, (size_t)(aligned - raw));
+            }
+            munmap(aligned + length, (size_t)((raw + length + huge) - (aligned + length)));
+            ptr = aligned;
+
+#if defined(MADV_HUGEPAGE)
+            (void)madvise(ptr, length, MADV_HUGEPAGE);
+#endif
+        }
+        else
+        {
+            ptr = mmap(NULL, length, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+
+            if (MAP_FAILED == ptr)
+            {
+                return NULL;
+            }
+        }
+    }
+
+#if defined(__linux__) && defined(SYS_mbind)
+    /* bind before the first touch, the pages are placed when faulted (MPOL_BIND, no libnuma dependency) */
+    if (numa_node >= 0)
+    {
+        const unsigned long nodemask = (numa_node < (int)(8U * sizeof(unsigned long))) ? (1UL << numa_node) : 0UL;
+
+        /* the kernel reads maxnode - 1 bits of the mask, one more than the bits of nodemask */
+        const long ret = (0UL != nodemask)
+            ? syscall(SYS_mbind, ptr, length, 2 /* MPOL_BIND */, &nodemask, 8U * sizeof(unsigned long) + 1U, 0U)
+            : -1L;
+
+        /* a kernel without NUMA support only has node 0 */
+        if ((0L != ret) && ((ENOSYS != errno) || (0 != numa_node)))
+        {
+            mem_free_pages(ptr, size, flags);
+            return NULL;
+        }
+    }
+#else
+    (void)numa_node;
+#endif
+
+    if (0 != (flags & MEM_ALLOC_PREFAULT))
+    {
+        mem_alloc_prefault(ptr, length);
+    }
+
+    return ptr;
+}
+
+void mem_free_pages(void* ptr, size_t size, int flags)
+{
+    if (ptr && (0U != size))
+    {
+        /* same rounding as at allocation */
+        munmap(ptr, mem_alloc_pages_length(size, flags));
+    }
+}
+
+#endif
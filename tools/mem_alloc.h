@@ -0,0 +1,62 @@
+//-----------------------------------------------------------------------------//
+// CRingBuffer MPMC - FIFO helper                                              //
+// (c) 2023 Laurent Lardinois https://be.linkedin.com/in/laurentlardinois      //
+//                                                                             //
+// https://github.com/type-one/CRingBuffer_MPSC                                //
+//                                                                             //
+// This software is provided 'as-is', without any express or implied           //
+// warranty.In no event will the authors be held liable for any damages        //
+// arising from the use of this software.                                      //
+//                                                                             //
+// Permission is granted to anyone to use this software for any purpose,       //
+// including commercial applications, and to alter itand redistribute it       //
+// freely, subject to the following restrictions :                             //
+//                                                                             //
+// 1. The origin of this software must not be misrepresented; you must not     //
+// claim that you wrote the original software.If you use this software         //
+// in a product, an acknowledgment in the product documentation would be       //
+// appreciated but is not required.                                            //
+// 2. Altered source versions must be plainly marked as such, and must not be  //
+// misrepresented as being the original software.                              //
+// 3. This notice may not be removed or altered from any source distribution.  //
+//-----------------------------------------------------------------------------//
+
+#pragma once
+
+#if !defined(__MEM_ALLOC_H__)
+#define __MEM_ALLOC_H__
+
+#include <stddef.h>
+
+#if defined(MEM_ALLOC_IMPLEM)
+#define EXTERN_MEM_ALLOC
+#else
+#define EXTERN_MEM_ALLOC extern
+#endif
+
+#if defined(__cplusplus)
+extern "C"
+{
+#endif
+
+    /* alignment must be a power of two, memory must be released with mem_free_aligned */
+    EXTERN_MEM_ALLOC void* mem_alloc_aligned(size_t size, size_t alignment);
+    EXTERN_MEM_ALLOC void mem_free_aligned(void* ptr);
+
+    /* page backed storage for large rings and payload arenas */
+#define MEM_ALLOC_HUGE_PAGES 0x1 /* 2 MB pages when available: explicit huge pages, else transparent ones, else regular pages */
+#define MEM_ALLOC_PREFAULT 0x2   /* touch every page at allocation, so the first accesses do not take page faults */
+#define MEM_ALLOC_ANY_NODE (-1)
+#define MEM_ALLOC_HUGE_PAGE_SIZE (2U * 1024U * 1024U)
+
+    /* page aligned zeroed memory, numa_node binds the pages to a NUMA node (MEM_ALLOC_ANY_NODE for the
+       default policy, NULL if the node does not exist or the binding failed; ignored where the OS has no
+       NUMA placement), must be released with mem_free_pages and the same size and flags */
+    EXTERN_MEM_ALLOC void* mem_alloc_pages(size_t size, int flags, int numa_node);
+    EXTERN_MEM_ALLOC void mem_free_pages(void* ptr, size_t size, int flags);
+
+#if defined(__cplusplus)
+};
+#endif
+
+#endif /*  __MEM_ALLOC_H__ */
@@ -0,0 +1,274 @@
+//-----------------------------------------------------------------------------//
+// CRingBuffer MPMC - FIFO helper                                              //
+// (c) 2023 Laurent Lardinois https://be.linkedin.com/in/laurentlardinois      //
+//                                                                             //
+// https://github.com/type-one/CRingBuffer_MPSC                                //
+//                                                                             //
+// This software is provided 'as-is', without any express or implied           //
+// warranty.In no event will the authors be held liable for any damages        //
+// arising from the use of this software.                                      //
+//                                                                             //
+// Permission is granted to anyone to use this software for any purpose,       //
+// including commercial applications, and to alter itand redistribute it       //
+// freely, subject to the following restrictions :                             //
+//                                                                             //
+// 1. The origin of this software must not be misrepresented; you must not     //
+// claim that you wrote the original software.If you use this software         //
+// in a product, an acknowledgment in the product documentation would be       //
+// appreciated but is not required.                                            //
+// 2. Altered source versions must be plainly marked as such, and must not be  //
+// misrepresented as being the original software.                              //
+// 3. This notice may not be removed or altered from any source distribution.  //
+//-----------------------------------------------------------------------------//
+
+#include "atomic_helper.h"
+#define MEM_POOL_IMPLEM
+#include "mem_pool.h"
+#include "mem_alloc.h"
+#include "ring_buffer_mpmc.h"
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+struct mem_pool_cache
+{
+    struct mem_pool* m_pool; /* NULL: entry unused */
+    long long m_pool_id;
+    size_t m_count;
+    void* m_blocks[MEM_POOL_MAGAZINE_SIZE];
+};
+
+static _atomic_llong st_next_pool_id;
+static THREAD_LOCAL struct mem_pool_cache st_thread_caches[MEM_POOL_THREAD_CACHES];
+
+
+/* magazine of the calling thread for this pool, a free entry is taken on first use,
+   NULL if the thread already caches blocks for MEM_POOL_THREAD_CACHES other pools */
+static struct mem_pool_cache* mem_pool_thread_cache(struct mem_pool* pool)
+{
+    struct mem_pool_cache* unused = NULL;
+
+    for (size_t i = 0U; i < MEM_POOL_THREAD_CACHES; ++i)
+    {
+        struct mem_pool_cache* cache = &st_thread_caches[i];
+
+        if (cache->m_pool == pool)
+        {
+            if (cache->m_pool_id == pool->m_id)
+            {
+                return cache;
+            }
+
+            /* left over from a deinitialized pool at the same address, its blocks are gone */
+            cache->m_pool = NULL;
+        }
+
+        if (!unused && !cache->m_pool)
+        {
+            unused = cache;
+        }
+    }
+
+    if (unused)
+    {
+        unused->m_pool = pool;
+        unused->m_pool_id = pool->m_id;
+        unused->m_count = 0U;
+    }
+
+    return unused;
+}
+
+static void mem_pool_free_storage(struct mem_pool* pool)
+{
+    if (pool->m_pages)
+    {
+        mem_free_pages((void*)(pool->m_storage), pool->m_nb_blocks * pool->m_block_size, pool->m_page_flags);
+    }
+    else
+    {
+        mem_free_aligned((void*)(pool->m_storage));
+    }
+    pool->m_storage = NULL;
+}
+
+int init_mem_pool(struct mem_pool* pool, size_t block_size, size_t alignment, size_t nb_blocks)
+{
+    return init_mem_pool_ex(pool, block_size, alignment, nb_blocks, 0, MEM_ALLOC_ANY_NODE);
+}
+
+int init_mem_pool_ex(struct mem_pool* pool, size_t block_size, size_t alignment, size_t nb_blocks, int page_flags, int numa_node)
+{
+    if (!pool || (0U == block_size) || (0U == nb_blocks))
+    {
+        return -1;
+    }
+
+    if (0U == alignment)
+    {
+        alignment = sizeof(void*);
+    }
+
+    if (0U != (alignment & (alignment - 1U)))
+    {
+        return -1;
+    }
+
+    if (alignment < sizeof(void*))
+    {
+        alignment = sizeof(void*);
+    }
+
+    pool->m_alignment = alignment;
+    pool->m_block_size = (block_size + alignment - 1U) & ~(alignment - 1U);
+    pool->m_nb_blocks = nb_blocks;
+    pool->m_id = sync_atomic_inc_64(st_next_pool_id) + 1;
+
+    if (nb_blocks > SIZE_MAX / pool->m_block_size)
+    {
+        return -1;
+    }
+
+    /* the mutex ring holds up to capacity - 1 elements, every block must fit */
+    unsigned long long capacity = 2ULL;
+    while (capacity <= (unsigned long long)nb_blocks)
+    {
+        capacity <<= 1U;
+    }
+
+    /* pages are aligned for any block alignment below the page size */
+    pool->m_pages = (0 != page_flags) || (numa_node >= 0);
+    pool->m_page_flags = page_flags;
+    pool->m_storage = (unsigned char*)(pool->m_pages ? mem_alloc_pages(nb_blocks * pool->m_block_size, page_flags, numa_node)
+                                                     : mem_alloc_aligned(nb_blocks * pool->m_block_size, alignment));
+    if (!pool->m_storage)
+    {
+        return -1;
+    }
+
+    if (init_ring_buffer_mpmc_ex(&(pool->m_free), capacity, NULL) < 0)
+    {
+        mem_pool_free_storage(pool);
+        return -1;
+    }
+
+    for (size_t i = 0U; i < nb_blocks; ++i)
+    {
+        (void)ring_buffer_push_sp(&(pool->m_free), (void*)(pool->m_storage + i * pool->m_block_size));
+    }
+
+    return 0;
+}
+
+int deinit_mem_pool(struct mem_pool* pool)
+{
+    if (!pool)
+    {
+        return -1;
+    }
+
+    /* forget the calling thread magazine, the other threads drop theirs on next use of this address */
+    for (size_t i = 0U; i < MEM_POOL_THREAD_CACHES; ++i)
+    {
+        if (st_thread_caches[i].m_pool == pool)
+        {
+            st_thread_caches[i].m_pool = NULL;
+        }
+    }
+
+    (void)deinit_ring_buffer_mpmc(&(pool->m_free));
+
+    mem_pool_free_storage(pool);
+
+    return 0;
+}
+
+void* mem_pool_alloc(struct mem_pool* pool)
+{
+    if (!pool)
+    {
+        return NULL;
+    }
+
+    struct mem_pool_cache* cache = mem_pool_thread_cache(pool);
+    void* block = NULL;
+
+    if (!cache)
+    {
+        return ring_buffer_pop_mc(&(pool->m_free), &block) ? block : NULL;
+    }
+
+    if (0U == cache->m_count)
+    {
+        /* refill half of the magazine, the other half absorbs the next frees */
+        cache->m_count = ring_buffer_pop_n_mc(&(pool->m_free), cache->m_blocks, MEM_POOL_MAGAZINE_SIZE / 2U);
+        if (0U == cache->m_count)
+        {
+            return NULL;
+        }
+    }
+
+    return cache->m_blocks[--cache->m_count];
+}
+
+void mem_pool_free(struct mem_pool* pool, void* block)
+{
+    if (!pool || !block)
+    {
+        return;
+    }
+
+    struct mem_pool_cache* cache = mem_pool_thread_cache(pool);
+
+    if (cache && (MEM_POOL_MAGAZINE_SIZE == cache->m_count))
+    {
+        /* magazine full, give its upper half back to the ring */
+        const size_t half = MEM_POOL_MAGAZINE_SIZE / 2U;
+        cache->m_count -= ring_buffer_push_n_mp(&(pool->m_free), &(cache->m_blocks[MEM_POOL_MAGAZINE_SIZE - half]), half);
+    }
+
+    if (cache && (cache->m_count < MEM_POOL_MAGAZINE_SIZE))
+    {
+        cache->m_blocks[cache->m_count++] = block;
+        return;
+    }
+
+    /* the ring is sized for every block, this push cannot fail */
+    (void)ring_buffer_push_mp(&(pool->m_free), block);
+}
+
+void mem_pool_flush_thread_cache(struct mem_pool* pool)
+{
+    if (!pool)
+    {
+        return;
+    }
+
+    for (size_t i = 0U; i < MEM_POOL_THREAD_CACHES; ++i)
+    {
+        struct mem_pool_cache* cache = &st_thread_caches[i];
+
+        if (cache->m_pool != pool)
+        {
+            continue;
+        }
+
+        if (cache->m_pool_id == pool->m_id)
+        {
+            size_t pushed = 0U;
+            while (pushed < cache->m_count)
+            {
+                const size_t count = ring_buffer_push_n_mp(&(pool->m_free), &(cache->m_blocks[pushed]), cache->m_count - pushed);
+                if (0U == count)
+                {
+                    break;
+                }
+                pushed += count;
+            }
+        }
+
+        cache->m_pool = NULL;
+        cache->m_count = 0U;
+    }
+}
@@ -0,0 +1,93 @@
+//-----------------------------------------------------------------------------//
+// CRingBuffer MPMC - FIFO helper                                              //
+// (c) 2023 Laurent Lardinois https://be.linkedin.com/in/laurentlardinois      //
+//                                                                             //
+// https://github.com/type-one/CRingBuffer_MPSC                                //
+//                                                                             //
+// This software is provided 'as-is', without any express or implied           //
+// warranty.In no event will the authors be held liable for any damages        //
+// arising from the use of this software.                                      //
+//                                                                             //
+// Permission is granted to anyone to use this software for any purpose,       //
+// including commercial applications, and to alter itand redistribute it       //
+// freely, subject to the following restrictions :                             //
+//                                                                             //
+// 1. The origin of this software must not be misrepresented; you must not     //
+// claim that you wrote the original software.If you use this software         //
+// in a product, an acknowledgment in the product documentation would be       //
+// appreciated but is not required.                                            //
+// 2. Altered source versions must be plainly marked as such, and must not be  //
+// misrepresented as being the original software.                              //
+// 3. This notice may not be removed or altered from any source distribution.  //
+//-----------------------------------------------------------------------------//
+
+#pragma once
+
+#if !defined(__MEM_POOL_H__)
+#define __MEM_POOL_H__
+
+#include "atomic_helper.h"
+#include "ring_buffer_mpmc.h"
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#if defined(MEM_POOL_IMPLEM)
+#define EXTERN_MEM_POOL
+#else
+#define EXTERN_MEM_POOL extern
+#endif
+
+#if defined(__cplusplus)
+extern "C"
+{
+#endif
+
+    /* fixed-size block pool: all the blocks are carved at init from a single aligned allocation and
+       the free ones are kept in a ring_buffer_mpmc of block pointers, each thread keeps a small
+       magazine of free blocks per pool in front of the ring, refilled and drained by batches, so most
+       alloc/free calls never touch the shared ring */
+
+#define MEM_POOL_MAGAZINE_SIZE 32U /* free blocks cached per thread and per pool */
+#define MEM_POOL_THREAD_CACHES 4U  /* pools a thread can cache blocks for, the others go to the ring */
+
+    struct mem_pool
+    {
+        /* read-only after init */
+        unsigned char* m_storage;
+        size_t m_block_size; /* rounded up to the alignment */
+        size_t m_alignment;
+        size_t m_nb_blocks;
+        long long m_id; /* unique per init, tells the thread caches of a reused pool address apart */
+        bool m_pages;     /* storage from mem_alloc_pages instead of the heap */
+        int m_page_flags;
+
+        /* free blocks not cached by a thread */
+        struct ring_buffer_mpmc m_free;
+    };
+
+    /* nb_blocks blocks of block_size bytes, alignment must be a power of two (0: pointer alignment) */
+    EXTERN_MEM_POOL int init_mem_pool(struct mem_pool* pool, size_t block_size, size_t alignment, size_t nb_blocks);
+
+    /* same with the blocks carved from mem_alloc_pages (page_flags from mem_alloc.h, numa_node or MEM_ALLOC_ANY_NODE)
+       for large arenas, 0 and MEM_ALLOC_ANY_NODE use the heap as init_mem_pool */
+    EXTERN_MEM_POOL int init_mem_pool_ex(
+        struct mem_pool* pool, size_t block_size, size_t alignment, size_t nb_blocks, int page_flags, int numa_node);
+
+    /* all the blocks must have been freed, the blocks cached by other threads are dropped with the storage */
+    EXTERN_MEM_POOL int deinit_mem_pool(struct mem_pool* pool);
+
+    /* return NULL when every block is in use (or cached by other threads) */
+    EXTERN_MEM_POOL void* mem_pool_alloc(struct mem_pool* pool);
+    EXTERN_MEM_POOL void mem_pool_free(struct mem_pool* pool, void* block);
+
+    /* give the blocks cached by the calling thread back to the ring, to call before a thread exits
+       (or when another thread may run out of blocks) */
+    EXTERN_MEM_POOL void mem_pool_flush_thread_cache(struct mem_pool* pool);
+
+#if defined(__cplusplus)
+};
+#endif
+
+#endif /*  __MEM_POOL_H__ */
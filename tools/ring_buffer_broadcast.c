@@ -0,0 +1,330 @@
+//-----------------------------------------------------------------------------//
+// CRingBuffer MPMC - FIFO helper                                              //
+// (c) 2023 Laurent Lardinois https://be.linkedin.com/in/laurentlardinois      //
+//                                                                             //
+// https://github.com/type-one/CRingBuffer_MPSC                                //
+//                                                                             //
+// This software is provided 'as-is', without any express or implied           //
+// warranty.In no event will the authors be held liable for any damages        //
+// arising from the use of this software.                                      //
+//                                                                             //
+// Permission is granted to anyone to use this software for any purpose,       //
+// including commercial applications, and to alter itand redistribute it       //
+// freely, subject to the following restrictions :                             //
+//                                                                             //
+// 1. The origin of this software must not be misrepresented; you must not     //
+// claim that you wrote the original software.If you use this software         //
+// in a product, an acknowledgment in the product documentation would be       //
+// appreciated but is not required.                                            //
+// 2. Altered source versions must be plainly marked as such, and must not be  //
+// misrepresented as being the original software.                              //
+// 3. This notice may not be removed or altered from any source distribution.  //
+//-----------------------------------------------------------------------------//
+
+#include "atomic_helper.h"
+#define RING_BUFFER_BROADCAST_IMPLEM
+#include "ring_buffer_broadcast.h"
+#include "mem_alloc.h"
+
+#include <limits.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <string.h>
+
+#if defined(_WIN32)
+#include <windows.h>
+#elif defined(__STDC_NO_THREADS__)
+#include <pthread.h>
+#else
+#include <threads.h>
+#endif
+
+
+/* slowest attached consumer, write_idx if none is attached */
+static long long ring_buffer_broadcast_gating(struct ring_buffer_broadcast* fifo, long long write_idx)
+{
+    long long gating = write_idx;
+
+    for (int i = 0; i < fifo->m_nb_consumers; ++i)
+    {
+        if (sync_atomic_load_acquire(fifo->m_cursors[i].m_attached))
+        {
+            const long long read_idx = sync_atomic_load_acquire(fifo->m_cursors[i].m_read_idx);
+            if (read_idx < gating)
+            {
+                gating = read_idx;
+            }
+        }
+    }
+
+    return gating;
+}
+
+/* last slot released to this consumer: the producer cursor, or the slowest upstream consumer */
+static long long ring_buffer_broadcast_barrier(struct ring_buffer_broadcast* fifo, const struct ring_buffer_broadcast_cursor* cursor)
+{
+    if (0U == cursor->m_upstreams)
+    {
+        return sync_atomic_load_acquire(fifo->m_write_idx);
+    }
+
+    long long barrier = LLONG_MAX;
+
+    for (int i = 0; i < fifo->m_nb_consumers; ++i)
+    {
+        if (0U != (cursor->m_upstreams & (1U << i)))
+        {
+            const long long read_idx = sync_atomic_load_acquire(fifo->m_cursors[i].m_read_idx);
+            if (read_idx < barrier)
+            {
+                barrier = read_idx;
+            }
+        }
+    }
+
+    return barrier;
+}
+
+size_t ring_buffer_broadcast_storage_size(unsigned long long capacity)
+{
+    return (size_t)capacity * sizeof(_atomic_uintptr);
+}
+
+int init_ring_buffer_broadcast(struct ring_buffer_broadcast* fifo, int nb_consumers)
+{
+    return init_ring_buffer_broadcast_ex(fifo, nb_consumers, RING_BUFFER_SIZE, NULL);
+}
+
+int init_ring_buffer_broadcast_ex(struct ring_buffer_broadcast* fifo, int nb_consumers, unsigned long long capacity, void* storage)
+{
+    if (!fifo || (nb_consumers <= 0) || (nb_consumers > RING_BUFFER_BROADCAST_MAX_CONSUMERS))
+    {
+        return -1;
+    }
+
+    /* power of two only, mask computed per instance */
+    if ((capacity < 2ULL) || (0ULL != (capacity & (capacity - 1ULL))))
+    {
+        return -1;
+    }
+
+    fifo->m_owns_buffer = (NULL == storage);
+    fifo->m_buffer = (_atomic_uintptr*)(fifo->m_owns_buffer
+            ? mem_alloc_aligned(ring_buffer_broadcast_storage_size(capacity), RING_BUFFER_STORAGE_ALIGNMENT)
+            : storage);
+
+    if (!fifo->m_buffer)
+    {
+        return -1;
+    }
+
+    fifo->m_size = (long long)capacity;
+    fifo->m_mask = (long long)(capacity - 1ULL);
+    fifo->m_nb_consumers = nb_consumers;
+    fifo->m_gating_cache = 0LL;
+
+    memset((void*)(fifo->m_buffer), 0, ring_buffer_broadcast_storage_size(capacity));
+    sync_atomic_store(fifo->m_write_idx, 0LL);
+    for (int i = 0; i < RING_BUFFER_BROADCAST_MAX_CONSUMERS; ++i)
+    {
+        sync_atomic_store(fifo->m_cursors[i].m_read_idx, 0LL);
+        sync_atomic_store(fifo->m_cursors[i].m_attached, (i < nb_consumers));
+        fifo->m_cursors[i].m_upstreams = 0U;
+        fifo->m_cursors[i].m_available = 0LL;
+        fifo->m_cursors[i].m_peeked = false;
+    }
+    sync_write_release();
+
+#if defined(_WIN32)
+    InitializeCriticalSection(&(fifo->m_write_mutex));
+#elif defined(__STDC_NO_THREADS__)
+    if (0 != pthread_mutex_init(&(fifo->m_write_mutex), NULL))
+    {
+        goto free_buffer;
+    }
+#else
+    if (thrd_success != mtx_init(&(fifo->m_write_mutex), mtx_plain))
+    {
+        goto free_buffer;
+    }
+#endif
+
+    return 0;
+
+#if !defined(_WIN32)
+free_buffer:
+    if (fifo->m_owns_buffer)
+    {
+        mem_free_aligned((void*)(fifo->m_buffer));
+    }
+    fifo->m_buffer = NULL;
+
+    return -1;
+#endif
+}
+
+int deinit_ring_buffer_broadcast(struct ring_buffer_broadcast* fifo)
+{
+    if (!fifo)
+    {
+        return -1;
+    }
+
+#if defined(_WIN32)
+    DeleteCriticalSection(&(fifo->m_write_mutex));
+#elif defined(__STDC_NO_THREADS__)
+    pthread_mutex_destroy(&(fifo->m_write_mutex));
+#else
+    mtx_destroy(&(fifo->m_write_mutex));
+#endif
+
+    if (fifo->m_owns_buffer)
+    {
+        mem_free_aligned((void*)(fifo->m_buffer));
+    }
+    fifo->m_buffer = NULL;
+
+    return 0;
+}
+
+bool ring_buffer_broadcast_push_sp(struct ring_buffer_broadcast* fifo, void* elem)
+{
+    if (!fifo || !elem)
+    {
+        return false;
+    }
+
+    /* own index, only written by the producer */
+    const long long write_idx = sync_atomic_load_relaxed(fifo->m_write_idx);
+
+    /* looks full ? refresh the slowest consumer cursor */
+    if ((write_idx - fifo->m_gating_cache) >= fifo->m_size)
+    {
+        fifo->m_gating_cache = ring_buffer_broadcast_gating(fifo, write_idx);
+
+        if ((write_idx - fifo->m_gating_cache) >= fifo->m_size)
+        {
+            return false;
+        }
+    }
+
+    sync_atomic_store_relaxed(fifo->m_buffer[write_idx & fifo->m_mask], (uintptr_t)elem);
+
+    /* publish to every consumer */
+    sync_atomic_store_release(fifo->m_write_idx, write_idx + 1);
+
+    return true;
+}
+
+bool ring_buffer_broadcast_push_mp(struct ring_buffer_broadcast* fifo, void* elem)
+{
+    bool ret;
+
+    if (!fifo || !elem)
+    {
+        return false;
+    }
+
+#if defined(_WIN32)
+    EnterCriticalSection(&(fifo->m_write_mutex));
+#elif defined(__STDC_NO_THREADS__)
+    pthread_mutex_lock(&(fifo->m_write_mutex));
+#else
+    mtx_lock(&(fifo->m_write_mutex));
+#endif
+
+    ret = ring_buffer_broadcast_push_sp(fifo, elem);
+
+#if defined(_WIN32)
+    LeaveCriticalSection(&(fifo->m_write_mutex));
+#elif defined(__STDC_NO_THREADS__)
+    pthread_mutex_unlock(&(fifo->m_write_mutex));
+#else
+    mtx_unlock(&(fifo->m_write_mutex));
+#endif
+
+    return ret;
+}
+
+int ring_buffer_broadcast_depends_on(struct ring_buffer_broadcast* fifo, int consumer, int upstream)
+{
+    if (!fifo || (consumer < 0) || (consumer >= fifo->m_nb_consumers) || (upstream < 0) || (upstream >= consumer))
+    {
+        return -1;
+    }
+
+    fifo->m_cursors[consumer].m_upstreams |= (1U << upstream);
+
+    return 0;
+}
+
+bool ring_buffer_broadcast_peek(struct ring_buffer_broadcast* fifo, int consumer, void** elem)
+{
+    if (!fifo || !elem || (consumer < 0) || (consumer >= fifo->m_nb_consumers))
+    {
+        return false;
+    }
+
+    struct ring_buffer_broadcast_cursor* cursor = &(fifo->m_cursors[consumer]);
+
+    /* own cursor, only written by this consumer */
+    const long long read_idx = sync_atomic_load_relaxed(cursor->m_read_idx);
+
+    /* is empty ? refresh the barrier before giving up */
+    if (read_idx >= cursor->m_available)
+    {
+        cursor->m_available = ring_buffer_broadcast_barrier(fifo, cursor);
+
+        if (read_idx >= cursor->m_available)
+        {
+            return false;
+        }
+    }
+
+    *elem = (void*)sync_atomic_load_relaxed(fifo->m_buffer[read_idx & fifo->m_mask]);
+    cursor->m_peeked = true;
+
+    return true;
+}
+
+void ring_buffer_broadcast_release(struct ring_buffer_broadcast* fifo, int consumer)
+{
+    if (!fifo || (consumer < 0) || (consumer >= fifo->m_nb_consumers))
+    {
+        return;
+    }
+
+    struct ring_buffer_broadcast_cursor* cursor = &(fifo->m_cursors[consumer]);
+
+    /* nothing peeked, moving the cursor would skip past m_write_idx and let the producers overwrite unread slots */
+    if (!cursor->m_peeked)
+    {
+        return;
+    }
+    cursor->m_peeked = false;
+
+    /* release the slot, the downstream stages and the producers wait for it */
+    sync_atomic_store_release(cursor->m_read_idx, sync_atomic_load_relaxed(cursor->m_read_idx) + 1);
+}
+
+bool ring_buffer_broadcast_pop(struct ring_buffer_broadcast* fifo, int consumer, void** elem)
+{
+    if (!ring_buffer_broadcast_peek(fifo, consumer, elem))
+    {
+        return false;
+    }
+
+    ring_buffer_broadcast_release(fifo, consumer);
+
+    return true;
+}
+
+void ring_buffer_broadcast_detach(struct ring_buffer_broadcast* fifo, int consumer)
+{
+    if (!fifo || (consumer < 0) || (consumer >= fifo->m_nb_consumers))
+    {
+        return;
+    }
+
+    sync_atomic_store_release(fifo->m_cursors[consumer].m_attached, false);
+}
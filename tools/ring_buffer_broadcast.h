@@ -0,0 +1,134 @@
+//-----------------------------------------------------------------------------//
+// CRingBuffer MPMC - FIFO helper                                              //
+// (c) 2023 Laurent Lardinois https://be.linkedin.com/in/laurentlardinois      //
+//                                                                             //
+// https://github.com/type-one/CRingBuffer_MPSC                                //
+//                                                                             //
+// This software is provided 'as-is', without any express or implied           //
+// warranty.In no event will the authors be held liable for any damages        //
+// arising from the use of this software.                                      //
+//                                                                             //
+// Permission is granted to anyone to use this software for any purpose,       //
+// including commercial applications, and to alter itand redistribute it       //
+// freely, subject to the following restrictions :                             //
+//                                                                             //
+// 1. The origin of this software must not be misrepresented; you must not     //
+// claim that you wrote the original software.If you use this software         //
+// in a product, an acknowledgment in the product documentation would be       //
+// appreciated but is not required.                                            //
+// 2. Altered source versions must be plainly marked as such, and must not be  //
+// misrepresented as being the original software.                              //
+// 3. This notice may not be removed or altered from any source distribution.  //
+//-----------------------------------------------------------------------------//
+
+#pragma once
+
+#if !defined(__RING_BUFFER_BROADCAST_H__)
+#define __RING_BUFFER_BROADCAST_H__
+
+#include "atomic_helper.h"
+#include "ring_buffer_mpmc.h"
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#if defined(_WIN32)
+#include <windows.h>
+#elif defined(__STDC_NO_THREADS__)
+#include <pthread.h>
+#else
+#include <threads.h>
+#endif
+
+#if defined(RING_BUFFER_BROADCAST_IMPLEM)
+#define EXTERN_RING_BUFFER_BROADCAST
+#else
+#define EXTERN_RING_BUFFER_BROADCAST extern
+#endif
+
+#if defined(__cplusplus)
+extern "C"
+{
+#endif
+
+    /* broadcast ring (Disruptor style): every element is written once and read by every consumer,
+       each consumer has its own read cursor and the producers are gated by the slowest attached
+       consumer; the consumers are numbered 0 to nb_consumers - 1 at init (each one used by a single
+       thread) and a consumer can detach to stop gating the producers;
+       a consumer can also depend on other consumers (pipeline stages sharing the ring): it only sees
+       a slot once all its upstream consumers have released it */
+
+#define RING_BUFFER_BROADCAST_MAX_CONSUMERS 16
+
+    struct ring_buffer_broadcast_cursor
+    {
+        RING_BUFFER_ALIGNED _atomic_llong m_read_idx;
+        _atomic_bool m_attached;
+        uint32_t m_upstreams;   /* consumers to wait for, the producer if none */
+        long long m_available;  /* last barrier seen by this consumer */
+        bool m_peeked;          /* the slot at m_read_idx was handed out by peek and not released yet */
+    };
+
+    struct ring_buffer_broadcast
+    {
+        /* read-only after init */
+        _atomic_uintptr* m_buffer;
+        long long m_size; /* power of two, the ring holds up to m_size elements */
+        long long m_mask;
+        int m_nb_consumers;
+        bool m_owns_buffer;
+
+        /* producer side */
+        RING_BUFFER_ALIGNED _atomic_llong m_write_idx;
+        long long m_gating_cache; /* slowest consumer cursor seen by the producer */
+#if defined(_WIN32)
+        CRITICAL_SECTION m_write_mutex;
+#elif defined(__STDC_NO_THREADS__)
+    pthread_mutex_t m_write_mutex;
+#else
+    mtx_t m_write_mutex;
+#endif
+
+        /* consumers side */
+        struct ring_buffer_broadcast_cursor m_cursors[RING_BUFFER_BROADCAST_MAX_CONSUMERS];
+    };
+
+    /* nb_consumers consumers (up to RING_BUFFER_BROADCAST_MAX_CONSUMERS), RING_BUFFER_SIZE entries,
+       storage allocated on the heap */
+    EXTERN_RING_BUFFER_BROADCAST int init_ring_buffer_broadcast(struct ring_buffer_broadcast* fifo, int nb_consumers);
+
+    /* capacity must be a power of two, storage can be NULL (allocated on the heap and released by deinit)
+       or point to ring_buffer_broadcast_storage_size(capacity) bytes owned by the caller */
+    EXTERN_RING_BUFFER_BROADCAST int init_ring_buffer_broadcast_ex(
+        struct ring_buffer_broadcast* fifo, int nb_consumers, unsigned long long capacity, void* storage);
+    EXTERN_RING_BUFFER_BROADCAST size_t ring_buffer_broadcast_storage_size(unsigned long long capacity);
+    EXTERN_RING_BUFFER_BROADCAST int deinit_ring_buffer_broadcast(struct ring_buffer_broadcast* fifo);
+
+    /* false if the slowest attached consumer has not read the slot to overwrite yet */
+    EXTERN_RING_BUFFER_BROADCAST bool ring_buffer_broadcast_push_sp(struct ring_buffer_broadcast* fifo, void* elem);
+    EXTERN_RING_BUFFER_BROADCAST bool ring_buffer_broadcast_push_mp(struct ring_buffer_broadcast* fifo, void* elem);
+
+    /* consumer only sees the slots released by upstream (which must have a lower number, so the stages
+       can not form a cycle), can be called several times to wait for several consumers,
+       to be set up before any push */
+    EXTERN_RING_BUFFER_BROADCAST int ring_buffer_broadcast_depends_on(struct ring_buffer_broadcast* fifo, int consumer, int upstream);
+
+    /* next element for this consumer, false if it has read everything (or its upstreams did not release it yet) */
+    EXTERN_RING_BUFFER_BROADCAST bool ring_buffer_broadcast_pop(struct ring_buffer_broadcast* fifo, int consumer, void** elem);
+
+    /* pipeline stage: peek gives the next element without releasing it, so the stage can work on it in place,
+       release then hands it to the downstream stages (or back to the producers), a release without a
+       successful peek before it is ignored */
+    EXTERN_RING_BUFFER_BROADCAST bool ring_buffer_broadcast_peek(struct ring_buffer_broadcast* fifo, int consumer, void** elem);
+    EXTERN_RING_BUFFER_BROADCAST void ring_buffer_broadcast_release(struct ring_buffer_broadcast* fifo, int consumer);
+
+    /* the consumer stops gating the producers and must not pop anymore (no re-attach),
+       nobody should depend on it */
+    EXTERN_RING_BUFFER_BROADCAST void ring_buffer_broadcast_detach(struct ring_buffer_broadcast* fifo, int consumer);
+
+#if defined(__cplusplus)
+};
+#endif
+
+#endif /*  __RING_BUFFER_BROADCAST_H__ */
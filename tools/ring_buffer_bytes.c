@@ -0,0 +1,377 @@
+//-----------------------------------------------------------------------------//
+// CRingBuffer MPMC - FIFO helper                                              //
+// (c) 2023 Laurent Lardinois https://be.linkedin.com/in/laurentlardinois      //
+//                                                                             //
+// https://github.com/type-one/CRingBuffer_MPSC                                //
+//                                                                             //
+// This software is provided 'as-is', without any express or implied           //
+// warranty.In no event will the authors be held liable for any damages        //
+// arising from the use of this software.                                      //
+//                                                                             //
+// Permission is granted to anyone to use this software for any purpose,       //
+// including commercial applications, and to alter itand redistribute it       //
+// freely, subject to the following restrictions :                             //
+//                                                                             //
+// 1. The origin of this software must not be misrepresented; you must not     //
+// claim that you wrote the original software.If you use this software         //
+// in a product, an acknowledgment in the product documentation would be       //
+// appreciated but is not required.                                            //
+// 2. Altered source versions must be plainly marked as such, and must not be  //
+// misrepresented as being the original software.                              //
+// 3. This notice may not be removed or altered from any source distribution.  //
+//-----------------------------------------------------------------------------//
+
+#include "atomic_helper.h"
+#define RING_BUFFER_BYTES_IMPLEM
+#include "ring_buffer_bytes.h"
+#include "mem_alloc.h"
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <string.h>
+
+#if defined(_WIN32)
+#include <windows.h>
+#elif defined(__STDC_NO_THREADS__)
+#include <pthread.h>
+#else
+#include <threads.h>
+#endif
+
+#define RING_BUFFER_BYTES_PADDING UINT32_MAX
+
+
+static void ring_buffer_bytes_lock_writers(struct ring_buffer_bytes* fifo)
+{
+#if defined(_WIN32)
+    EnterCriticalSection(&(fifo->m_write_mutex));
+#elif defined(__STDC_NO_THREADS__)
+    pthread_mutex_lock(&(fifo->m_write_mutex));
+#else
+    mtx_lock(&(fifo->m_write_mutex));
+#endif
+}
+
+static void ring_buffer_bytes_unlock_writers(struct ring_buffer_bytes* fifo)
+{
+#if defined(_WIN32)
+    LeaveCriticalSection(&(fifo->m_write_mutex));
+#elif defined(__STDC_NO_THREADS__)
+    pthread_mutex_unlock(&(fifo->m_write_mutex));
+#else
+    mtx_unlock(&(fifo->m_write_mutex));
+#endif
+}
+
+static void ring_buffer_bytes_lock_readers(struct ring_buffer_bytes* fifo)
+{
+#if defined(_WIN32)
+    EnterCriticalSection(&(fifo->m_read_mutex));
+#elif defined(__STDC_NO_THREADS__)
+    pthread_mutex_lock(&(fifo->m_read_mutex));
+#else
+    mtx_lock(&(fifo->m_read_mutex));
+#endif
+}
+
+static void ring_buffer_bytes_unlock_readers(struct ring_buffer_bytes* fifo)
+{
+#if defined(_WIN32)
+    LeaveCriticalSection(&(fifo->m_read_mutex));
+#elif defined(__STDC_NO_THREADS__)
+    pthread_mutex_unlock(&(fifo->m_read_mutex));
+#else
+    mtx_unlock(&(fifo->m_read_mutex));
+#endif
+}
+
+/* header + payload, rounded up to keep the next header aligned */
+static long long ring_buffer_bytes_record_size(size_t len)
+{
+    const size_t size = sizeof(struct ring_buffer_bytes_header) + len;
+    return (long long)((size + RING_BUFFER_BYTES_ALIGNMENT - 1U) & ~((size_t)RING_BUFFER_BYTES_ALIGNMENT - 1U));
+}
+
+static struct ring_buffer_bytes_header* ring_buffer_bytes_header_at(struct ring_buffer_bytes* fifo, long long idx)
+{
+    return (struct ring_buffer_bytes_header*)(fifo->m_buffer + (idx & fifo->m_mask));
+}
+
+int init_ring_buffer_bytes(struct ring_buffer_bytes* fifo)
+{
+    return init_ring_buffer_bytes_ex(fifo, RING_BUFFER_BYTES_DEFAULT_SIZE, NULL);
+}
+
+int init_ring_buffer_bytes_ex(struct ring_buffer_bytes* fifo, unsigned long long capacity, void* storage)
+{
+    if (!fifo)
+    {
+        return -1;
+    }
+
+    /* power of two only, room for at least two headers */
+    if ((capacity < 2ULL * sizeof(struct ring_buffer_bytes_header)) || (0ULL != (capacity & (capacity - 1ULL))))
+    {
+        return -1;
+    }
+
+    fifo->m_owns_buffer = (NULL == storage);
+    fifo->m_buffer = (unsigned char*)(fifo->m_owns_buffer ? mem_alloc_aligned((size_t)capacity, RING_BUFFER_STORAGE_ALIGNMENT) : storage);
+
+    if (!fifo->m_buffer)
+    {
+        return -1;
+    }
+
+    fifo->m_size = (long long)capacity;
+    fifo->m_mask = (long long)(capacity - 1ULL);
+    fifo->m_reserve_idx = -1LL;
+    fifo->m_reserve_len = 0U;
+    fifo->m_peek_size = 0LL;
+
+    sync_atomic_store(fifo->m_read_idx, 0LL);
+    sync_atomic_store(fifo->m_write_idx, 0LL);
+    sync_write_release();
+
+#if defined(_WIN32)
+    InitializeCriticalSection(&(fifo->m_read_mutex));
+    InitializeCriticalSection(&(fifo->m_write_mutex));
+#elif defined(__STDC_NO_THREADS__)
+    if (0 != pthread_mutex_init(&(fifo->m_read_mutex), NULL))
+    {
+        goto free_buffer;
+    }
+
+    if (0 != pthread_mutex_init(&(fifo->m_write_mutex), NULL))
+    {
+        pthread_mutex_destroy(&(fifo->m_read_mutex));
+        goto free_buffer;
+    }
+#else
+    if (thrd_success != mtx_init(&(fifo->m_read_mutex), mtx_plain))
+    {
+        goto free_buffer;
+    }
+
+    if (thrd_success != mtx_init(&(fifo->m_write_mutex), mtx_plain))
+    {
+        mtx_destroy(&(fifo->m_read_mutex));
+        goto free_buffer;
+    }
+#endif
+
+    return 0;
+
+#if !defined(_WIN32)
+free_buffer:
+    if (fifo->m_owns_buffer)
+    {
+        mem_free_aligned((void*)(fifo->m_buffer));
+    }
+    fifo->m_buffer = NULL;
+
+    return -1;
+#endif
+}
+
+int deinit_ring_buffer_bytes(struct ring_buffer_bytes* fifo)
+{
+    if (!fifo)
+    {
+        return -1;
+    }
+
+#if defined(_WIN32)
+    DeleteCriticalSection(&(fifo->m_read_mutex));
+    DeleteCriticalSection(&(fifo->m_write_mutex));
+#elif defined(__STDC_NO_THREADS__)
+    pthread_mutex_destroy(&(fifo->m_read_mutex));
+    pthread_mutex_destroy(&(fifo->m_write_mutex));
+#else
+    mtx_destroy(&(fifo->m_read_mutex));
+    mtx_destroy(&(fifo->m_write_mutex));
+#endif
+
+    if (fifo->m_owns_buffer)
+    {
+        mem_free_aligned((void*)(fifo->m_buffer));
+    }
+    fifo->m_buffer = NULL;
+
+    return 0;
+}
+
+void* ring_buffer_bytes_reserve_sp(struct ring_buffer_bytes* fifo, size_t len)
+{
+    if (!fifo || (len >= (size_t)RING_BUFFER_BYTES_PADDING))
+    {
+        return NULL;
+    }
+
+    /* up to half the buffer, the padding (smaller than the record) and the record always fit in an empty ring */
+    const long long record_size = ring_buffer_bytes_record_size(len);
+    if (record_size > (fifo->m_size / 2))
+    {
+        return NULL;
+    }
+
+    const long long write_idx = sync_atomic_load_relaxed(fifo->m_write_idx);
+    const long long read_idx = sync_atomic_load_acquire(fifo->m_read_idx);
+
+    /* record must be contiguous, skip the end of the buffer if it does not fit before wrapping */
+    const long long to_end = fifo->m_size - (write_idx & fifo->m_mask);
+    const long long padding = (record_size > to_end) ? to_end : 0LL;
+
+    /* is full ? */
+    if ((padding + record_size) > (fifo->m_size - (write_idx - read_idx)))
+    {
+        return NULL;
+    }
+
+    if (padding > 0LL)
+    {
+        /* not visible to the consumer before the commit */
+        ring_buffer_bytes_header_at(fifo, write_idx)->m_length = RING_BUFFER_BYTES_PADDING;
+    }
+
+    fifo->m_reserve_idx = write_idx + padding;
+    fifo->m_reserve_len = len;
+
+    return (void*)(ring_buffer_bytes_header_at(fifo, fifo->m_reserve_idx) + 1);
+}
+
+bool ring_buffer_bytes_commit_sp(struct ring_buffer_bytes* fifo, size_t len)
+{
+    if (!fifo || (fifo->m_reserve_idx < 0LL))
+    {
+        return false;
+    }
+
+    const long long reserve_idx = fifo->m_reserve_idx;
+    fifo->m_reserve_idx = -1LL;
+
+    if (len > fifo->m_reserve_len)
+    {
+        return false;
+    }
+
+    ring_buffer_bytes_header_at(fifo, reserve_idx)->m_length = (uint32_t)len;
+
+    /* publish header and payload (and the padding record if any) to the consumer */
+    sync_atomic_store_release(fifo->m_write_idx, reserve_idx + ring_buffer_bytes_record_size(len));
+
+    return true;
+}
+
+size_t ring_buffer_bytes_max_record(const struct ring_buffer_bytes* fifo)
+{
+    if (!fifo)
+    {
+        return 0U;
+    }
+
+    /* record_size() rounds the payload up to the alignment and adds the header */
+    return (size_t)(fifo->m_size / 2) - sizeof(struct ring_buffer_bytes_header);
+}
+
+const void* ring_buffer_bytes_peek_sc(struct ring_buffer_bytes* fifo, size_t* len)
+{
+    if (!fifo || !len)
+    {
+        return NULL;
+    }
+
+    long long read_idx = sync_atomic_load_relaxed(fifo->m_read_idx);
+    const long long write_idx = sync_atomic_load_acquire(fifo->m_write_idx);
+
+    /* is empty ? */
+    if (read_idx == write_idx)
+    {
+        return NULL;
+    }
+
+    long long padding = 0LL;
+    struct ring_buffer_bytes_header* header = ring_buffer_bytes_header_at(fifo, read_idx);
+
+    if (RING_BUFFER_BYTES_PADDING == header->m_length)
+    {
+        /* a padding record is always followed by a committed record at the start of the buffer */
+        padding = fifo->m_size - (read_idx & fifo->m_mask);
+        header = ring_buffer_bytes_header_at(fifo, read_idx + padding);
+    }
+
+    fifo->m_peek_size = padding + ring_buffer_bytes_record_size(header->m_length);
+    *len = header->m_length;
+
+    return (const void*)(header + 1);
+}
+
+void ring_buffer_bytes_release_sc(struct ring_buffer_bytes* fifo)
+{
+    if (!fifo || (0LL == fifo->m_peek_size))
+    {
+        return;
+    }
+
+    /* give the bytes back to the producer */
+    sync_atomic_store_release(fifo->m_read_idx, sync_atomic_load_relaxed(fifo->m_read_idx) + fifo->m_peek_size);
+    fifo->m_peek_size = 0LL;
+}
+
+void* ring_buffer_bytes_reserve_mp(struct ring_buffer_bytes* fifo, size_t len)
+{
+    if (!fifo)
+    {
+        return NULL;
+    }
+
+    ring_buffer_bytes_lock_writers(fifo);
+    void* ret = ring_buffer_bytes_reserve_sp(fifo, len);
+    if (!ret)
+    {
+        ring_buffer_bytes_unlock_writers(fifo);
+    }
+
+    return ret;
+}
+
+bool ring_buffer_bytes_commit_mp(struct ring_buffer_bytes* fifo, size_t len)
+{
+    if (!fifo)
+    {
+        return false;
+    }
+
+    bool ret = ring_buffer_bytes_commit_sp(fifo, len);
+    ring_buffer_bytes_unlock_writers(fifo);
+
+    return ret;
+}
+
+const void* ring_buffer_bytes_peek_mc(struct ring_buffer_bytes* fifo, size_t* len)
+{
+    if (!fifo || !len)
+    {
+        return NULL;
+    }
+
+    ring_buffer_bytes_lock_readers(fifo);
+    const void* ret = ring_buffer_bytes_peek_sc(fifo, len);
+    if (!ret)
+    {
+        ring_buffer_bytes_unlock_readers(fifo);
+    }
+
+    return ret;
+}
+
+void ring_buffer_bytes_release_mc(struct ring_buffer_bytes* fifo)
+{
+    if (!fifo)
+    {
+        return;
+    }
+
+    ring_buffer_bytes_release_sc(fifo);
+    ring_buffer_bytes_unlock_readers(fifo);
+}
@@ -0,0 +1,135 @@
+//-----------------------------------------------------------------------------//
+// CRingBuffer MPMC - FIFO helper                                              //
+// (c) 2023 Laurent Lardinois https://be.linkedin.com/in/laurentlardinois      //
+//                                                                             //
+// https://github.com/type-one/CRingBuffer_MPSC                                //
+//                                                                             //
+// This software is provided 'as-is', without any express or implied           //
+// warranty.In no event will the authors be held liable for any damages        //
+// arising from the use of this software.                                      //
+//                                                                             //
+// Permission is granted to anyone to use this software for any purpose,       //
+// including commercial applications, and to alter itand redistribute it       //
+// freely, subject to the following restrictions :                             //
+//                                                                             //
+// 1. The origin of this software must not be misrepresented; you must not     //
+// claim that you wrote the original software.If you use this software         //
+// in a product, an acknowledgment in the product documentation would be       //
+// appreciated but is not required.                                            //
+// 2. Altered source versions must be plainly marked as such, and must not be  //
+// misrepresented as being the original software.                              //
+// 3. This notice may not be removed or altered from any source distribution.  //
+//-----------------------------------------------------------------------------//
+
+#pragma once
+
+#if !defined(__RING_BUFFER_BYTES_H__)
+#define __RING_BUFFER_BYTES_H__
+
+#include "atomic_helper.h"
+#include "ring_buffer_mpmc.h"
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#if defined(_WIN32)
+#include <windows.h>
+#elif defined(__STDC_NO_THREADS__)
+#include <pthread.h>
+#else
+#include <threads.h>
+#endif
+
+#if defined(RING_BUFFER_BYTES_IMPLEM)
+#define EXTERN_RING_BUFFER_BYTES
+#else
+#define EXTERN_RING_BUFFER_BYTES extern
+#endif
+
+#if defined(__cplusplus)
+extern "C"
+{
+#endif
+
+    /* byte ring for variable-length records, written and read in place (no copy, no allocation):
+       producer: p = reserve(len), write up to len bytes at p, commit(actual_len)
+       consumer: p = peek(&len), read len bytes at p, release()
+       every record is contiguous, a padding record fills the end of the buffer when the next
+       record does not fit before wrapping around */
+
+#define RING_BUFFER_BYTES_DEFAULT_SIZE (RING_BUFFER_SIZE * 64ULL)
+#define RING_BUFFER_BYTES_ALIGNMENT 8U /* records header and payload alignment */
+
+    struct ring_buffer_bytes_header
+    {
+        uint32_t m_length; /* payload length, UINT32_MAX for a padding record */
+        uint32_t m_reserved;
+    };
+
+    struct ring_buffer_bytes
+    {
+        /* read-only after init */
+        unsigned char* m_buffer;
+        long long m_size; /* power of two, in bytes */
+        long long m_mask;
+        bool m_owns_buffer;
+
+        /* producer side */
+        RING_BUFFER_ALIGNED _atomic_llong m_write_idx;
+        long long m_reserve_idx; /* header position of the pending record, -1 if none */
+        size_t m_reserve_len;
+#if defined(_WIN32)
+        CRITICAL_SECTION m_write_mutex;
+#elif defined(__STDC_NO_THREADS__)
+    pthread_mutex_t m_write_mutex;
+#else
+    mtx_t m_write_mutex;
+#endif
+
+        /* consumer side */
+        RING_BUFFER_ALIGNED _atomic_llong m_read_idx;
+        long long m_peek_size; /* bytes to release, padding included */
+#if defined(_WIN32)
+        CRITICAL_SECTION m_read_mutex;
+#elif defined(__STDC_NO_THREADS__)
+    pthread_mutex_t m_read_mutex;
+#else
+    mtx_t m_read_mutex;
+#endif
+    };
+
+    /* default capacity of RING_BUFFER_BYTES_DEFAULT_SIZE bytes, storage allocated on the heap */
+    EXTERN_RING_BUFFER_BYTES int init_ring_buffer_bytes(struct ring_buffer_bytes* fifo);
+
+    /* capacity in bytes must be a power of two (at least 16), storage can be NULL (allocated on the heap
+       and released by deinit) or point to capacity bytes owned by the caller, aligned on RING_BUFFER_BYTES_ALIGNMENT */
+    EXTERN_RING_BUFFER_BYTES int init_ring_buffer_bytes_ex(struct ring_buffer_bytes* fifo, unsigned long long capacity, void* storage);
+    EXTERN_RING_BUFFER_BYTES int deinit_ring_buffer_bytes(struct ring_buffer_bytes* fifo);
+
+    /* return NULL if full, or if the record (len plus its header) is larger than half of the capacity:
+       a larger record may need more than the free space left once the end of the buffer is padded,
+       even with an empty ring, so it is rejected up front instead of failing on every retry;
+       commit publishes len <= reserved len bytes (a failed commit drops the reservation) */
+    EXTERN_RING_BUFFER_BYTES void* ring_buffer_bytes_reserve_sp(struct ring_buffer_bytes* fifo, size_t len);
+    EXTERN_RING_BUFFER_BYTES bool ring_buffer_bytes_commit_sp(struct ring_buffer_bytes* fifo, size_t len);
+
+    /* largest len reserve accepts */
+    EXTERN_RING_BUFFER_BYTES size_t ring_buffer_bytes_max_record(const struct ring_buffer_bytes* fifo);
+
+    /* return NULL if empty, release must follow a successful peek */
+    EXTERN_RING_BUFFER_BYTES const void* ring_buffer_bytes_peek_sc(struct ring_buffer_bytes* fifo, size_t* len);
+    EXTERN_RING_BUFFER_BYTES void ring_buffer_bytes_release_sc(struct ring_buffer_bytes* fifo);
+
+    /* multiple producers/consumers, the writers (readers) mutex is held from a successful reserve (peek)
+       until the matching commit (release) */
+    EXTERN_RING_BUFFER_BYTES void* ring_buffer_bytes_reserve_mp(struct ring_buffer_bytes* fifo, size_t len);
+    EXTERN_RING_BUFFER_BYTES bool ring_buffer_bytes_commit_mp(struct ring_buffer_bytes* fifo, size_t len);
+    EXTERN_RING_BUFFER_BYTES const void* ring_buffer_bytes_peek_mc(struct ring_buffer_bytes* fifo, size_t* len);
+    EXTERN_RING_BUFFER_BYTES void ring_buffer_bytes_release_mc(struct ring_buffer_bytes* fifo);
+
+#if defined(__cplusplus)
+};
+#endif
+
+#endif /*  __RING_BUFFER_BYTES_H__ */
@@ -24,10 +24,14 @@
 #include "atomic_helper.h"
 #define RING_BUFFER_MPMC_IMPLEM
 #include "ring_buffer_mpmc.h"
+#include "event_count.h"
+#include "mem_alloc.h"
+#include "timer_chrono.h"
 
 #include <stdbool.h>
 #include <stdint.h>
 #include <stdio.h>
+#include <stdlib.h>
 #include <string.h>
 
 #if defined(_WIN32)
@@ -38,203 +42,1049 @@
 #include <threads.h>
 #endif
 
+static const char* const st_stat_names[RING_BUFFER_STAT_COUNT] = { "push_ok", "push_full", "pop_ok", "pop_empty", "write_spins",
+    "read_spins", "write_lock_waits", "write_lock_wait_ns", "read_lock_waits", "read_lock_wait_ns", "push_parks", "pop_parks" };
+
+#if RING_BUFFER_MPMC_STATS
+
+struct ring_buffer_stats_cache
+{
+    struct ring_buffer_mpmc* m_fifo; /* NULL: entry unused */
+    long long m_fifo_id;
+    struct ring_buffer_mpmc_stats_block* m_block;
+};
+
+static _atomic_llong st_next_stats_id;
+static THREAD_LOCAL struct ring_buffer_stats_cache st_thread_stats_caches[RING_BUFFER_STATS_THREAD_CACHES];
+static THREAD_LOCAL unsigned int st_thread_stats_next;
+static THREAD_LOCAL char st_thread_stats_owner; /* its address identifies the thread */
+
+/* block of the calling thread on this queue, taken from the queue's list or allocated and linked
+   on first use, NULL if the allocation failed (the event is not counted) */
+static struct ring_buffer_mpmc_stats_block* ring_buffer_stats_block_lookup(struct ring_buffer_mpmc* fifo)
+{
+    struct ring_buffer_mpmc_stats_block* block = NULL;
+
+    for (block = (struct ring_buffer_mpmc_stats_block*)(intptr_t)sync_atomic_load_acquire(fifo->m_stats_blocks); block;
+         block = block->m_next)
+    {
+        /* a block left by an exited thread whose thread local storage was reused is taken over */
+        if (block->m_owner == (const void*)&st_thread_stats_owner)
+        {
+            return block;
+        }
+    }
+
+    block = (struct ring_buffer_mpmc_stats_block*)mem_alloc_aligned(sizeof(struct ring_buffer_mpmc_stats_block), RING_BUFFER_STORAGE_ALIGNMENT);
+
+    if (!block)
+    {
+        return NULL;
+    }
+
+    for (int stat = 0; stat < RING_BUFFER_STAT_COUNT; ++stat)
+    {
+        sync_atomic_store_relaxed(block->m_counters[stat], 0LL);
+    }
+    block->m_owner = (const void*)&st_thread_stats_owner;
+
+    long long head;
+    do
+    {
+        head = sync_atomic_load(fifo->m_stats_blocks);
+        block->m_next = (struct ring_buffer_mpmc_stats_block*)(intptr_t)head;
+    } while (!sync_atomic_cas_64(fifo->m_stats_blocks, head, (long long)(intptr_t)block));
+
+    return block;
+}
+
+static struct ring_buffer_mpmc_stats_block* ring_buffer_stats_block(struct ring_buffer_mpmc* fifo)
+{
+    for (unsigned int i = 0U; i < RING_BUFFER_STATS_THREAD_CACHES; ++i)
+    {
+        struct ring_buffer_stats_cache* cache = &st_thread_stats_caches[i];
+
+        if ((cache->m_fifo == fifo) && (cache->m_fifo_id == fifo->m_stats_id))
+        {
+            return cache->m_block;
+        }
+    }
+
+    struct ring_buffer_mpmc_stats_block* block = ring_buffer_stats_block_lookup(fifo);
+
+    if (block)
+    {
+        /* round robin replacement, an evicted block stays in its queue's list */
+        struct ring_buffer_stats_cache* cache = &st_thread_stats_caches[st_thread_stats_next++ % RING_BUFFER_STATS_THREAD_CACHES];
+        cache->m_fifo = fifo;
+        cache->m_fifo_id = fifo->m_stats_id;
+        cache->m_block = block;
+    }
+
+    return block;
+}
+
+/* the owner is the only writer, a relaxed load and store is enough (no read-modify-write) */
+static void ring_buffer_stat_add(struct ring_buffer_mpmc* fifo, enum ring_buffer_mpmc_stat stat, long long val)
+{
+    struct ring_buffer_mpmc_stats_block* block = ring_buffer_stats_block(fifo);
+
+    if (block)
+    {
+        sync_atomic_store_relaxed(block->m_counters[stat], sync_atomic_load_relaxed(block->m_counters[stat]) + val);
+    }
+}
+
+#define RING_BUFFER_STAT_ADD(fifo, stat, val) ring_buffer_stat_add((fifo), (stat), (long long)(val))
+
+#else
+
+#define RING_BUFFER_STAT_ADD(fifo, stat, val) ((void)(stat), (void)(val))
+
+#endif
+
+static void ring_buffer_lock_writers(struct ring_buffer_mpmc* fifo)
+{
+#if RING_BUFFER_MPMC_STATS
+    /* only time the contended case */
+#if defined(_WIN32)
+    if (TryEnterCriticalSection(&(fifo->m_write_mutex)))
+#elif defined(__STDC_NO_THREADS__)
+    if (0 == pthread_mutex_trylock(&(fifo->m_write_mutex)))
+#else
+    if (thrd_success == mtx_trylock(&(fifo->m_write_mutex)))
+#endif
+    {
+        return;
+    }
+
+    const uint64_t start_ns = timer_chrono_now_ns();
+#endif
+
+#if defined(_WIN32)
+    EnterCriticalSection(&(fifo->m_write_mutex));
+#elif defined(__STDC_NO_THREADS__)
+    pthread_mutex_lock(&(fifo->m_write_mutex));
+#else
+    mtx_lock(&(fifo->m_write_mutex));
+#endif
+
+#if RING_BUFFER_MPMC_STATS
+    RING_BUFFER_STAT_ADD(fifo, RING_BUFFER_STAT_WRITE_LOCK_WAITS, 1);
+    RING_BUFFER_STAT_ADD(fifo, RING_BUFFER_STAT_WRITE_LOCK_WAIT_NS, timer_chrono_now_ns() - start_ns);
+#endif
+}
+
+static void ring_buffer_unlock_writers(struct ring_buffer_mpmc* fifo)
+{
+#if defined(_WIN32)
+    LeaveCriticalSection(&(fifo->m_write_mutex));
+#elif defined(__STDC_NO_THREADS__)
+    pthread_mutex_unlock(&(fifo->m_write_mutex));
+#else
+    mtx_unlock(&(fifo->m_write_mutex));
+#endif
+}
+
+static void ring_buffer_lock_readers(struct ring_buffer_mpmc* fifo)
+{
+#if RING_BUFFER_MPMC_STATS
+    /* only time the contended case */
+#if defined(_WIN32)
+    if (TryEnterCriticalSection(&(fifo->m_read_mutex)))
+#elif defined(__STDC_NO_THREADS__)
+    if (0 == pthread_mutex_trylock(&(fifo->m_read_mutex)))
+#else
+    if (thrd_success == mtx_trylock(&(fifo->m_read_mutex)))
+#endif
+    {
+        return;
+    }
+
+    const uint64_t start_ns = timer_chrono_now_ns();
+#endif
+
+#if defined(_WIN32)
+    EnterCriticalSection(&(fifo->m_read_mutex));
+#elif defined(__STDC_NO_THREADS__)
+    pthread_mutex_lock(&(fifo->m_read_mutex));
+#else
+    mtx_lock(&(fifo->m_read_mutex));
+#endif
+
+#if RING_BUFFER_MPMC_STATS
+    RING_BUFFER_STAT_ADD(fifo, RING_BUFFER_STAT_READ_LOCK_WAITS, 1);
+    RING_BUFFER_STAT_ADD(fifo, RING_BUFFER_STAT_READ_LOCK_WAIT_NS, timer_chrono_now_ns() - start_ns);
+#endif
+}
+
+static void ring_buffer_unlock_readers(struct ring_buffer_mpmc* fifo)
+{
+#if defined(_WIN32)
+    LeaveCriticalSection(&(fifo->m_read_mutex));
+#elif defined(__STDC_NO_THREADS__)
+    pthread_mutex_unlock(&(fifo->m_read_mutex));
+#else
+    mtx_unlock(&(fifo->m_read_mutex));
+#endif
+}
+
+static void* ring_buffer_take_slot(struct ring_buffer_mpmc* fifo, long long read_idx)
+{
+#if INTPTR_MAX == INT64_MAX
+    /* 64 bit arch */
+    return (void*)sync_atomic_exchange_64(fifo->m_buffer[read_idx & fifo->m_mask], 0ULL);
+#elif INTPTR_MAX == INT32_MAX
+    /* 32 bit arch */
+    return (void*)sync_atomic_exchange_32(fifo->m_buffer[read_idx & fifo->m_mask], 0UL);
+#else
+    /* unsupported */
+    return NULL;
+#endif
+}
+
+#if RING_BUFFER_MPMC_LATENCY_HISTOGRAMS
+
+static const char* const st_op_names[RING_BUFFER_OP_COUNT] = { "push_sp", "push_mp", "pop_sc", "pop_mc", "push_n_sp", "push_n_mp",
+    "pop_n_sc", "pop_n_mc", "push_wait_sp", "push_wait_mp", "pop_wait_sc", "pop_wait_mc" };
+
+struct ring_buffer_latency_set
+{
+    struct latency_histogram m_ops[RING_BUFFER_OP_COUNT];
+    struct ring_buffer_latency_set* m_next;
+};
+
+/* head of the list of per thread sets (pointer stored as an integer for the cas), never released */
+static _atomic_llong st_latency_sets;
+static THREAD_LOCAL struct ring_buffer_latency_set* st_thread_latency_set;
+
+static struct ring_buffer_latency_set* ring_buffer_latency_set(void)
+{
+    if (!st_thread_latency_set)
+    {
+        struct ring_buffer_latency_set* set = (struct ring_buffer_latency_set*)calloc(1, sizeof(struct ring_buffer_latency_set));
+        if (!set)
+        {
+            return NULL;
+        }
+
+        long long head = sync_atomic_load(st_latency_sets);
+        do
+        {
+            set->m_next = (struct ring_buffer_latency_set*)(intptr_t)head;
+        } while (!sync_atomic_cas_64(st_latency_sets, head, (long long)(intptr_t)set));
+
+        st_thread_latency_set = set;
+    }
+
+    return st_thread_latency_set;
+}
+
+/* time stamp counter ticks, converted once the operation is done */
+static void ring_buffer_latency_record(enum ring_buffer_mpmc_op op, uint64_t start_ticks)
+{
+    const uint64_t end_ticks = timer_chrono_ticks_ordered();
+    struct ring_buffer_latency_set* set = ring_buffer_latency_set();
+
+    if (set && (end_ticks >= start_ticks))
+    {
+        latency_histogram_record(&(set->m_ops[op]), timer_chrono_ticks_to_ns(end_ticks - start_ticks));
+    }
+}
+
+#define RING_BUFFER_LATENCY_BEGIN() const uint64_t latency_start_ticks = timer_chrono_ticks()
+#define RING_BUFFER_LATENCY_END(op) ring_buffer_latency_record(op, latency_start_ticks)
+
+const char* ring_buffer_mpmc_op_name(enum ring_buffer_mpmc_op op)
+{
+    return ((op >= 0) && (op < RING_BUFFER_OP_COUNT)) ? st_op_names[op] : "unknown";
+}
+
+void ring_buffer_mpmc_latency_snapshot(enum ring_buffer_mpmc_op op, struct latency_histogram* merged)
+{
+    latency_histogram_reset(merged);
+
+    if (!merged || (op < 0) || (op >= RING_BUFFER_OP_COUNT))
+    {
+        return;
+    }
+
+    sync_read_acquire();
+    for (struct ring_buffer_latency_set* set = (struct ring_buffer_latency_set*)(intptr_t)sync_atomic_load(st_latency_sets); set;
+         set = set->m_next)
+    {
+        latency_histogram_merge(merged, &(set->m_ops[op]));
+    }
+}
+
+void ring_buffer_mpmc_latency_reset(void)
+{
+    /* not synchronized with the owner threads, samples recorded meanwhile may be lost */
+    sync_read_acquire();
+    for (struct ring_buffer_latency_set* set = (struct ring_buffer_latency_set*)(intptr_t)sync_atomic_load(st_latency_sets); set;
+         set = set->m_next)
+    {
+        for (int op = 0; op < RING_BUFFER_OP_COUNT; ++op)
+        {
+            latency_histogram_reset(&(set->m_ops[op]));
+        }
+    }
+}
+
+void ring_buffer_mpmc_latency_dump(FILE* out)
+{
+    if (!out)
+    {
+        return;
+    }
+
+    /* too large for the stack of small threads */
+    struct latency_histogram* merged = (struct latency_histogram*)malloc(sizeof(struct latency_histogram));
+    if (!merged)
+    {
+        return;
+    }
+
+    fprintf(out, "%-14s %12s %10s %10s %10s %12s\n", "latency (ns)", "calls", "p50", "p99", "p99.9", "max");
+
+    for (int op = 0; op < RING_BUFFER_OP_COUNT; ++op)
+    {
+        struct latency_summary summary;
+
+        ring_buffer_mpmc_latency_snapshot((enum ring_buffer_mpmc_op)op, merged);
+        latency_histogram_summary(merged, &summary);
+
+        if (summary.m_count > 0U)
+        {
+            fprintf(out, "%-14s %12llu %10llu %10llu %10llu %12llu\n", st_op_names[op], (unsigned long long)summary.m_count,
+                (unsigned long long)summary.m_p50_ns, (unsigned long long)summary.m_p99_ns, (unsigned long long)summary.m_p999_ns,
+                (unsigned long long)summary.m_max_ns);
+        }
+    }
+
+    free(merged);
+}
+
+#else
+
+#define RING_BUFFER_LATENCY_BEGIN()
+#define RING_BUFFER_LATENCY_END(op)
+
+#endif
+
+void ring_buffer_mpmc_stats_snapshot(struct ring_buffer_mpmc* fifo, struct ring_buffer_mpmc_stats* stats)
+{
+    if (!stats)
+    {
+        return;
+    }
+
+    memset(stats, 0, sizeof(struct ring_buffer_mpmc_stats));
+
+#if RING_BUFFER_MPMC_STATS
+    if (!fifo)
+    {
+        return;
+    }
+
+    for (struct ring_buffer_mpmc_stats_block* block = (struct ring_buffer_mpmc_stats_block*)(intptr_t)sync_atomic_load_acquire(fifo->m_stats_blocks);
+         block; block = block->m_next)
+    {
+        for (int stat = 0; stat < RING_BUFFER_STAT_COUNT; ++stat)
+        {
+            stats->m_counters[stat] += (unsigned long long)sync_atomic_load_relaxed(block->m_counters[stat]);
+        }
+    }
+#else
+    (void)fifo;
+#endif
+}
+
+void ring_buffer_mpmc_stats_reset(struct ring_buffer_mpmc* fifo)
+{
+#if RING_BUFFER_MPMC_STATS
+    if (!fifo)
+    {
+        return;
+    }
+
+    for (struct ring_buffer_mpmc_stats_block* block = (struct ring_buffer_mpmc_stats_block*)(intptr_t)sync_atomic_load_acquire(fifo->m_stats_blocks);
+         block; block = block->m_next)
+    {
+        for (int stat = 0; stat < RING_BUFFER_STAT_COUNT; ++stat)
+        {
+            sync_atomic_store_relaxed(block->m_counters[stat], 0LL);
+        }
+    }
+#else
+    (void)fifo;
+#endif
+}
+
+const char* ring_buffer_mpmc_stat_name(enum ring_buffer_mpmc_stat stat)
+{
+    return (((int)stat >= 0) && (stat < RING_BUFFER_STAT_COUNT)) ? st_stat_names[stat] : "unknown";
+}
+
+size_t ring_buffer_mpmc_storage_size(unsigned long long capacity)
+{
+    return (size_t)capacity * sizeof(_atomic_uintptr);
+}
 
 int init_ring_buffer_mpmc(struct ring_buffer_mpmc* fifo)
+{
+    return init_ring_buffer_mpmc_ex(fifo, RING_BUFFER_SIZE, NULL);
+}
+
+int init_ring_buffer_mpmc_ex(struct ring_buffer_mpmc* fifo, unsigned long long capacity, void* storage)
 {
     if (!fifo)
     {
         return -1;
     }
 
-    memset((void*)(fifo->m_buffer), 0, sizeof(fifo->m_buffer));
+    /* power of two only, mask computed per instance */
+    if ((capacity < 2ULL) || (0ULL != (capacity & (capacity - 1ULL))))
+    {
+        return -1;
+    }
+
+    fifo->m_owns_buffer = (NULL == storage);
+    fifo->m_buffer = (_atomic_uintptr*)(fifo->m_owns_buffer
+            ? mem_alloc_aligned(ring_buffer_mpmc_storage_size(capacity), RING_BUFFER_STORAGE_ALIGNMENT)
+            : storage);
+
+    if (!fifo->m_buffer)
+    {
+        return -1;
+    }
+
+    fifo->m_size = (long long)capacity;
+    fifo->m_mask = (long long)(capacity - 1ULL);
+
+    memset((void*)(fifo->m_buffer), 0, ring_buffer_mpmc_storage_size(capacity));
+#if RING_BUFFER_MPMC_STATS
+    sync_atomic_store(fifo->m_stats_blocks, 0LL);
+    fifo->m_stats_id = sync_atomic_inc_64(st_next_stats_id) + 1;
+#endif
     sync_atomic_store(fifo->m_read_idx, 0ULL);
     sync_atomic_store(fifo->m_write_idx, 0ULL);
     sync_atomic_store(fifo->m_reading, false);
     sync_atomic_store(fifo->m_writing, false);
     sync_write_release();
 
+#if RING_BUFFER_MPMC_LATENCY_HISTOGRAMS
+    /* calibrate the time stamp counter now rather than during the first measured operation */
+    (void)timer_chrono_ns_per_tick();
+#endif
+
 #if defined(_WIN32)
     InitializeCriticalSection(&(fifo->m_read_mutex));
     InitializeCriticalSection(&(fifo->m_write_mutex));
 #elif defined(__STDC_NO_THREADS__)
     if (0 != pthread_mutex_init(&(fifo->m_read_mutex), NULL))
     {
-        return -1;
+        goto free_buffer;
+    }
+
+    if (0 != pthread_mutex_init(&(fifo->m_write_mutex), NULL))
+    {
+        pthread_mutex_destroy(&(fifo->m_read_mutex));
+        goto free_buffer;
+    }
+#else
+    if (thrd_success != mtx_init(&(fifo->m_read_mutex), mtx_plain))
+    {
+        goto free_buffer;
+    }
+
+    if (thrd_success != mtx_init(&(fifo->m_write_mutex), mtx_plain))
+    {
+        mtx_destroy(&(fifo->m_read_mutex));
+        goto free_buffer;
+    }
+#endif
+
+    if (init_event_count(&(fifo->m_not_empty)) < 0)
+    {
+        goto destroy_mutexes;
+    }
+
+    if (init_event_count(&(fifo->m_not_full)) < 0)
+    {
+        deinit_event_count(&(fifo->m_not_empty));
+        goto destroy_mutexes;
+    }
+
+    return 0;
+
+destroy_mutexes:
+#if defined(_WIN32)
+    DeleteCriticalSection(&(fifo->m_read_mutex));
+    DeleteCriticalSection(&(fifo->m_write_mutex));
+#elif defined(__STDC_NO_THREADS__)
+    pthread_mutex_destroy(&(fifo->m_read_mutex));
+    pthread_mutex_destroy(&(fifo->m_write_mutex));
+#else
+    mtx_destroy(&(fifo->m_read_mutex));
+    mtx_destroy(&(fifo->m_write_mutex));
+#endif
+
+#if !defined(_WIN32)
+free_buffer:
+#endif
+    if (fifo->m_owns_buffer)
+    {
+        mem_free_aligned((void*)(fifo->m_buffer));
+    }
+    fifo->m_buffer = NULL;
+
+    return -1;
+}
+
+int deinit_ring_buffer_mpmc(struct ring_buffer_mpmc* fifo)
+{
+    if (!fifo)
+    {
+        return -1;
+    }
+
+    /* wake up parked threads, they will time out on the next try */
+    deinit_event_count(&(fifo->m_not_full));
+    deinit_event_count(&(fifo->m_not_empty));
+
+#if defined(_WIN32)
+    DeleteCriticalSection(&(fifo->m_read_mutex));
+    DeleteCriticalSection(&(fifo->m_write_mutex));
+#elif defined(__STDC_NO_THREADS__)
+    pthread_mutex_destroy(&(fifo->m_read_mutex));
+    pthread_mutex_destroy(&(fifo->m_write_mutex));
+#else
+    mtx_destroy(&(fifo->m_read_mutex));
+    mtx_destroy(&(fifo->m_write_mutex));
+#endif
+
+#if RING_BUFFER_MPMC_STATS
+    struct ring_buffer_mpmc_stats_block* block = (struct ring_buffer_mpmc_stats_block*)(intptr_t)sync_atomic_load_acquire(fifo->m_stats_blocks);
+    while (block)
+    {
+        struct ring_buffer_mpmc_stats_block* next = block->m_next;
+        mem_free_aligned(block);
+        block = next;
+    }
+    sync_atomic_store(fifo->m_stats_blocks, 0LL);
+#endif
+
+    if (fifo->m_owns_buffer)
+    {
+        mem_free_aligned((void*)(fifo->m_buffer));
+    }
+    fifo->m_buffer = NULL;
+
+    return 0;
+}
+
+static bool ring_buffer_do_push_sp(struct ring_buffer_mpmc* fifo, void* elem)
+{
+    if (!fifo || !elem)
+    {
+        return false;
+    }
+
+    sync_read_acquire();
+    const long long snap_write_idx = sync_atomic_load(fifo->m_write_idx);
+    const long long snap_read_idx = sync_atomic_load(fifo->m_read_idx);
+
+    /* is full ? */
+    if ((snap_read_idx & fifo->m_mask) == ((snap_write_idx + 1LL) & fifo->m_mask))
+    {
+        RING_BUFFER_STAT_ADD(fifo, RING_BUFFER_STAT_PUSH_FULL, 1);
+        return false;
+    }
+
+    /* getting close or wrap around, risk of race condition */
+    if (((snap_write_idx - snap_read_idx) <= 2) || (snap_write_idx < snap_read_idx))
+    {
+        long long spins = -1;
+        do
+        {
+            sync_read_acquire();
+            ++spins;
+        } while (sync_atomic_load(fifo->m_reading));
+
+        if (spins > 0)
+        {
+            RING_BUFFER_STAT_ADD(fifo, RING_BUFFER_STAT_WRITE_SPINS, spins);
+        }
+    }
+
+    sync_atomic_store(fifo->m_writing, true);
+    sync_read_write();
+    const long long write_idx = sync_atomic_inc_64(fifo->m_write_idx);
+    sync_atomic_store(fifo->m_buffer[write_idx & fifo->m_mask], (uintptr_t)elem);
+    sync_atomic_store(fifo->m_writing, false);
+
+    event_count_notify_one(&(fifo->m_not_empty));
+    RING_BUFFER_STAT_ADD(fifo, RING_BUFFER_STAT_PUSH_OK, 1);
+
+    return true;
+}
+
+static bool ring_buffer_do_push_mp(struct ring_buffer_mpmc* fifo, void* elem)
+{
+    if (!fifo || !elem)
+    {
+        return false;
     }
 
-    if (0 != pthread_mutex_init(&(fifo->m_write_mutex), NULL))
+    ring_buffer_lock_writers(fifo);
+    bool ret = ring_buffer_do_push_sp(fifo, elem);
+    ring_buffer_unlock_writers(fifo);
+
+    return ret;
+}
+
+static bool ring_buffer_do_pop_sc(struct ring_buffer_mpmc* fifo, void** elem)
+{
+    if (!fifo || !elem)
     {
-        return -1;
+        return false;
     }
-#else
-    if (thrd_success != mtx_init(&(fifo->m_read_mutex), mtx_plain))
+
+    sync_read_acquire();
+    const long long snap_write_idx = sync_atomic_load(fifo->m_write_idx);
+    const long long snap_read_idx = sync_atomic_load(fifo->m_read_idx);
+
+    /* is empty ? */
+    if ((snap_read_idx & fifo->m_mask) == (snap_write_idx & fifo->m_mask))
     {
-        return -1;
+        RING_BUFFER_STAT_ADD(fifo, RING_BUFFER_STAT_POP_EMPTY, 1);
+        return false;
     }
 
-    if (thrd_success != mtx_init(&(fifo->m_write_mutex), mtx_plain))
+    /* getting close or wrap around, risk of race condition */
+    if (((snap_write_idx - snap_read_idx) <= 2) || (snap_write_idx < snap_read_idx))
     {
-        return -1;
+        long long spins = -1;
+        do
+        {
+            sync_read_acquire();
+            ++spins;
+        } while (sync_atomic_load(fifo->m_writing));
+
+        if (spins > 0)
+        {
+            RING_BUFFER_STAT_ADD(fifo, RING_BUFFER_STAT_READ_SPINS, spins);
+        }
     }
-#endif
 
-    return 0;
+    sync_atomic_store(fifo->m_reading, true);
+    sync_read_write();
+    const long long read_idx = sync_atomic_inc_64(fifo->m_read_idx);
+
+    *elem = ring_buffer_take_slot(fifo, read_idx);
+
+    sync_atomic_store(fifo->m_reading, false);
+    sync_write_release();
+
+    event_count_notify_one(&(fifo->m_not_full));
+    RING_BUFFER_STAT_ADD(fifo, (*elem == NULL) ? RING_BUFFER_STAT_POP_EMPTY : RING_BUFFER_STAT_POP_OK, 1);
+
+    return (*elem == NULL) ? false : true;
 }
 
-int deinit_ring_buffer_mpmc(struct ring_buffer_mpmc* fifo)
+static bool ring_buffer_do_pop_mc(struct ring_buffer_mpmc* fifo, void** elem)
 {
-    if (!fifo)
+    if (!fifo || !elem)
     {
-        return -1;
+        return false;
     }
 
-#if defined(_WIN32)
-    DeleteCriticalSection(&(fifo->m_read_mutex));
-    DeleteCriticalSection(&(fifo->m_write_mutex));
-#elif defined(__STDC_NO_THREADS__)
-    pthread_mutex_destroy(&(fifo->m_read_mutex));
-    pthread_mutex_destroy(&(fifo->m_write_mutex));
-#else
-    mtx_destroy(&(fifo->m_read_mutex));
-    mtx_destroy(&(fifo->m_write_mutex));
-#endif
+    ring_buffer_lock_readers(fifo);
+    bool ret = ring_buffer_do_pop_sc(fifo, elem);
+    ring_buffer_unlock_readers(fifo);
 
-    return 0;
+    return ret;
 }
 
-bool ring_buffer_push_sp(struct ring_buffer_mpmc* fifo, void* elem)
+static size_t ring_buffer_do_push_n_sp(struct ring_buffer_mpmc* fifo, void* const* elems, size_t count)
 {
-    if (!fifo || !elem)
+    if (!fifo || !elems || (0U == count))
     {
-        return false;
+        return 0U;
     }
 
     sync_read_acquire();
     const long long snap_write_idx = sync_atomic_load(fifo->m_write_idx);
     const long long snap_read_idx = sync_atomic_load(fifo->m_read_idx);
 
+    /* one slot is always kept empty to tell full from empty */
+    const long long free_slots = fifo->m_mask - (snap_write_idx - snap_read_idx);
+
     /* is full ? */
-    if ((snap_read_idx & RING_BUFFER_MASK) == ((snap_write_idx + 1ULL) & RING_BUFFER_MASK))
+    if (free_slots <= 0)
     {
-        return false;
+        RING_BUFFER_STAT_ADD(fifo, RING_BUFFER_STAT_PUSH_FULL, 1);
+        return 0U;
+    }
+
+    size_t nb = ((unsigned long long)free_slots < count) ? (size_t)free_slots : count;
+
+    /* null pointers cannot be queued, stop at the first one */
+    for (size_t i = 0U; i < nb; ++i)
+    {
+        if (!elems[i])
+        {
+            nb = i;
+            break;
+        }
+    }
+
+    if (0U == nb)
+    {
+        return 0U;
     }
 
     /* getting close or wrap around, risk of race condition */
     if (((snap_write_idx - snap_read_idx) <= 2) || (snap_write_idx < snap_read_idx))
     {
+        long long spins = -1;
         do
         {
             sync_read_acquire();
+            ++spins;
         } while (sync_atomic_load(fifo->m_reading));
+
+        if (spins > 0)
+        {
+            RING_BUFFER_STAT_ADD(fifo, RING_BUFFER_STAT_WRITE_SPINS, spins);
+        }
     }
 
     sync_atomic_store(fifo->m_writing, true);
     sync_read_write();
-    const long long write_idx = sync_atomic_inc_64(fifo->m_write_idx);
-    sync_atomic_store(fifo->m_buffer[write_idx & RING_BUFFER_MASK], (uintptr_t)elem);
+
+    /* fill the reserved range first, then publish it with a single index update
+       (relaxed stores, ordered by the sequentially consistent index update) */
+    for (size_t i = 0U; i < nb; ++i)
+    {
+        sync_atomic_store_relaxed(fifo->m_buffer[(snap_write_idx + (long long)i) & fifo->m_mask], (uintptr_t)elems[i]);
+    }
+
+    sync_atomic_add_64(fifo->m_write_idx, (long long)nb);
     sync_atomic_store(fifo->m_writing, false);
 
-    return true;
+    event_count_notify_all(&(fifo->m_not_empty));
+    RING_BUFFER_STAT_ADD(fifo, RING_BUFFER_STAT_PUSH_OK, nb);
+
+    return nb;
 }
 
-bool ring_buffer_push_mp(struct ring_buffer_mpmc* fifo, void* elem)
+static size_t ring_buffer_do_push_n_mp(struct ring_buffer_mpmc* fifo, void* const* elems, size_t count)
 {
-    if (!fifo || !elem)
+    if (!fifo || !elems || (0U == count))
     {
-        return false;
+        return 0U;
     }
 
-#if defined(_WIN32)
-    EnterCriticalSection(&(fifo->m_write_mutex));
-#elif defined(__STDC_NO_THREADS__)
-    pthread_mutex_lock(&(fifo->m_write_mutex));
-#else
-    mtx_lock(&(fifo->m_write_mutex));
-#endif
-
-    bool ret = ring_buffer_push_sp(fifo, elem);
-
-#if defined(_WIN32)
-    LeaveCriticalSection(&(fifo->m_write_mutex));
-#elif defined(__STDC_NO_THREADS__)
-    pthread_mutex_unlock(&(fifo->m_write_mutex));
-#else
-    mtx_unlock(&(fifo->m_write_mutex));
-#endif
+    ring_buffer_lock_writers(fifo);
+    size_t ret = ring_buffer_do_push_n_sp(fifo, elems, count);
+    ring_buffer_unlock_writers(fifo);
 
     return ret;
 }
 
-bool ring_buffer_pop_sc(struct ring_buffer_mpmc* fifo, void** elem)
+static size_t ring_buffer_do_pop_n_sc(struct ring_buffer_mpmc* fifo, void** elems, size_t count)
 {
-    if (!fifo || !elem)
+    if (!fifo || !elems || (0U == count))
     {
-        return false;
+        return 0U;
     }
 
     sync_read_acquire();
     const long long snap_write_idx = sync_atomic_load(fifo->m_write_idx);
     const long long snap_read_idx = sync_atomic_load(fifo->m_read_idx);
 
+    const long long used_slots = snap_write_idx - snap_read_idx;
+
     /* is empty ? */
-    if ((snap_read_idx & RING_BUFFER_MASK) == (snap_write_idx & RING_BUFFER_MASK))
+    if (used_slots <= 0)
     {
-        return false;
+        RING_BUFFER_STAT_ADD(fifo, RING_BUFFER_STAT_POP_EMPTY, 1);
+        return 0U;
     }
 
+    size_t nb = ((unsigned long long)used_slots < count) ? (size_t)used_slots : count;
+
     /* getting close or wrap around, risk of race condition */
-    if (((snap_write_idx - snap_read_idx) <= 2) || (snap_write_idx < snap_read_idx))
+    if ((used_slots <= 2) || (snap_write_idx < snap_read_idx))
     {
+        long long spins = -1;
         do
         {
             sync_read_acquire();
+            ++spins;
         } while (sync_atomic_load(fifo->m_writing));
+
+        if (spins > 0)
+        {
+            RING_BUFFER_STAT_ADD(fifo, RING_BUFFER_STAT_READ_SPINS, spins);
+        }
     }
 
     sync_atomic_store(fifo->m_reading, true);
     sync_read_write();
-    const long long read_idx = sync_atomic_inc_64(fifo->m_read_idx);
 
-#if INTPTR_MAX == INT64_MAX
-    /* 64 bit arch */
-    *elem = (void*)sync_atomic_exchange_64(fifo->m_buffer[read_idx & RING_BUFFER_MASK], 0ULL);
-#elif INTPTR_MAX == INT32_MAX
-    /* 32 bit arch */
-    *elem = (void*)sync_atomic_exchange_32(fifo->m_buffer[read_idx & RING_BUFFER_MASK], 0UL);
-#else
-    /* unsupported */
-#endif
+    /* drain the range first, then release it to the producers with a single index update */
+    for (size_t i = 0U; i < nb; ++i)
+    {
+        elems[i] = ring_buffer_take_slot(fifo, snap_read_idx + (long long)i);
+
+        if (!elems[i])
+        {
+            /* slot reserved but not yet filled by the producer, keep it for the next pop */
+            nb = i;
+            break;
+        }
+    }
 
+    sync_write_release();
+    sync_atomic_add_64(fifo->m_read_idx, (long long)nb);
     sync_atomic_store(fifo->m_reading, false);
     sync_write_release();
 
-    return (*elem == NULL) ? false : true;
+    if (nb > 0U)
+    {
+        event_count_notify_all(&(fifo->m_not_full));
+        RING_BUFFER_STAT_ADD(fifo, RING_BUFFER_STAT_POP_OK, nb);
+    }
+    else
+    {
+        RING_BUFFER_STAT_ADD(fifo, RING_BUFFER_STAT_POP_EMPTY, 1);
+    }
+
+    return nb;
+}
+
+static size_t ring_buffer_do_pop_n_mc(struct ring_buffer_mpmc* fifo, void** elems, size_t count)
+{
+    if (!fifo || !elems || (0U == count))
+    {
+        return 0U;
+    }
+
+    ring_buffer_lock_readers(fifo);
+    size_t ret = ring_buffer_do_pop_n_sc(fifo, elems, count);
+    ring_buffer_unlock_readers(fifo);
+
+    return ret;
+}
+
+bool ring_buffer_push_sp(struct ring_buffer_mpmc* fifo, void* elem)
+{
+    RING_BUFFER_LATENCY_BEGIN();
+    const bool ret = ring_buffer_do_push_sp(fifo, elem);
+    RING_BUFFER_LATENCY_END(RING_BUFFER_OP_PUSH_SP);
+
+    return ret;
+}
+
+bool ring_buffer_push_mp(struct ring_buffer_mpmc* fifo, void* elem)
+{
+    RING_BUFFER_LATENCY_BEGIN();
+    const bool ret = ring_buffer_do_push_mp(fifo, elem);
+    RING_BUFFER_LATENCY_END(RING_BUFFER_OP_PUSH_MP);
+
+    return ret;
+}
+
+bool ring_buffer_pop_sc(struct ring_buffer_mpmc* fifo, void** elem)
+{
+    RING_BUFFER_LATENCY_BEGIN();
+    const bool ret = ring_buffer_do_pop_sc(fifo, elem);
+    RING_BUFFER_LATENCY_END(RING_BUFFER_OP_POP_SC);
+
+    return ret;
 }
 
 bool ring_buffer_pop_mc(struct ring_buffer_mpmc* fifo, void** elem)
+{
+    RING_BUFFER_LATENCY_BEGIN();
+    const bool ret = ring_buffer_do_pop_mc(fifo, elem);
+    RING_BUFFER_LATENCY_END(RING_BUFFER_OP_POP_MC);
+
+    return ret;
+}
+
+size_t ring_buffer_push_n_sp(struct ring_buffer_mpmc* fifo, void* const* elems, size_t count)
+{
+    RING_BUFFER_LATENCY_BEGIN();
+    const size_t ret = ring_buffer_do_push_n_sp(fifo, elems, count);
+    RING_BUFFER_LATENCY_END(RING_BUFFER_OP_PUSH_N_SP);
+
+    return ret;
+}
+
+size_t ring_buffer_push_n_mp(struct ring_buffer_mpmc* fifo, void* const* elems, size_t count)
+{
+    RING_BUFFER_LATENCY_BEGIN();
+    const size_t ret = ring_buffer_do_push_n_mp(fifo, elems, count);
+    RING_BUFFER_LATENCY_END(RING_BUFFER_OP_PUSH_N_MP);
+
+    return ret;
+}
+
+size_t ring_buffer_pop_n_sc(struct ring_buffer_mpmc* fifo, void** elems, size_t count)
+{
+    RING_BUFFER_LATENCY_BEGIN();
+    const size_t ret = ring_buffer_do_pop_n_sc(fifo, elems, count);
+    RING_BUFFER_LATENCY_END(RING_BUFFER_OP_POP_N_SC);
+
+    return ret;
+}
+
+size_t ring_buffer_pop_n_mc(struct ring_buffer_mpmc* fifo, void** elems, size_t count)
+{
+    RING_BUFFER_LATENCY_BEGIN();
+    const size_t ret = ring_buffer_do_pop_n_mc(fifo, elems, count);
+    RING_BUFFER_LATENCY_END(RING_BUFFER_OP_POP_N_MC);
+
+    return ret;
+}
+
+typedef bool (*ring_buffer_try_op)(struct ring_buffer_mpmc* fifo, void* arg);
+
+static bool ring_buffer_try_push_sp(struct ring_buffer_mpmc* fifo, void* arg)
+{
+    return ring_buffer_do_push_sp(fifo, arg);
+}
+
+static bool ring_buffer_try_push_mp(struct ring_buffer_mpmc* fifo, void* arg)
+{
+    return ring_buffer_do_push_mp(fifo, arg);
+}
+
+static bool ring_buffer_try_pop_sc(struct ring_buffer_mpmc* fifo, void* arg)
+{
+    return ring_buffer_do_pop_sc(fifo, (void**)arg);
+}
+
+static bool ring_buffer_try_pop_mc(struct ring_buffer_mpmc* fifo, void* arg)
+{
+    return ring_buffer_do_pop_mc(fifo, (void**)arg);
+}
+
+/* slow path of the blocking variants, the first try already failed */
+static bool ring_buffer_wait_for(struct ring_buffer_mpmc* fifo, struct event_count* ec, ring_buffer_try_op try_op, void* arg,
+    unsigned long timeout_us, enum ring_buffer_mpmc_stat park_stat)
+{
+    if (0UL == timeout_us)
+    {
+        return false;
+    }
+
+    /* bounded spin, short waits are cheaper than a park/unpark round trip */
+    for (int i = 0; i < RING_BUFFER_WAIT_SPINS; ++i)
+    {
+        sync_cpu_relax();
+        if (try_op(fifo, arg))
+        {
+            return true;
+        }
+    }
+
+    struct timer_chrono timer;
+    (void)init_timer_chrono(&timer);
+    const double start_time = timer_chrono_current_time_ms(&timer);
+    unsigned long remaining_us = timeout_us;
+
+    for (;;)
+    {
+        /* register as waiter before the last try, a push/pop completed after it will wake us */
+        const int key = event_count_prepare_wait(ec);
+        if (try_op(fifo, arg))
+        {
+            event_count_cancel_wait(ec);
+            return true;
+        }
+
+        RING_BUFFER_STAT_ADD(fifo, park_stat, 1);
+        (void)event_count_wait(ec, key, remaining_us);
+
+        if (try_op(fifo, arg))
+        {
+            return true;
+        }
+
+        if (RING_BUFFER_WAIT_INFINITE != timeout_us)
+        {
+            const double elapsed_us = (timer_chrono_current_time_ms(&timer) - start_time) * 1000.0;
+            if (elapsed_us >= (double)timeout_us)
+            {
+                return false;
+            }
+
+            remaining_us = timeout_us - (unsigned long)elapsed_us;
+        }
+    }
+}
+
+bool ring_buffer_push_wait_sp(struct ring_buffer_mpmc* fifo, void* elem, unsigned long timeout_us)
 {
     if (!fifo || !elem)
     {
         return false;
     }
 
-#if defined(_WIN32)
-    EnterCriticalSection(&(fifo->m_read_mutex));
-#elif defined(__STDC_NO_THREADS__)
-    pthread_mutex_lock(&(fifo->m_read_mutex));
-#else
-    mtx_lock(&(fifo->m_read_mutex));
-#endif
+    RING_BUFFER_LATENCY_BEGIN();
+    const bool ret = ring_buffer_do_push_sp(fifo, elem) || ring_buffer_wait_for(fifo, &(fifo->m_not_full), ring_buffer_try_push_sp, elem, timeout_us,
+        RING_BUFFER_STAT_PUSH_PARKS);
+    RING_BUFFER_LATENCY_END(RING_BUFFER_OP_PUSH_WAIT_SP);
 
-    bool ret = ring_buffer_pop_sc(fifo, elem);
+    return ret;
+}
 
-#if defined(_WIN32)
-    LeaveCriticalSection(&(fifo->m_read_mutex));
-#elif defined(__STDC_NO_THREADS__)
-    pthread_mutex_unlock(&(fifo->m_read_mutex));
-#else
-    mtx_unlock(&(fifo->m_read_mutex));
-#endif
+bool ring_buffer_push_wait_mp(struct ring_buffer_mpmc* fifo, void* elem, unsigned long timeout_us)
+{
+    if (!fifo || !elem)
+    {
+        return false;
+    }
+
+    RING_BUFFER_LATENCY_BEGIN();
+    const bool ret = ring_buffer_do_push_mp(fifo, elem) || ring_buffer_wait_for(fifo, &(fifo->m_not_full), ring_buffer_try_push_mp, elem, timeout_us,
+        RING_BUFFER_STAT_PUSH_PARKS);
+    RING_BUFFER_LATENCY_END(RING_BUFFER_OP_PUSH_WAIT_MP);
+
+    return ret;
+}
+
+bool ring_buffer_pop_wait_sc(struct ring_buffer_mpmc* fifo, void** elem, unsigned long timeout_us)
+{
+    if (!fifo || !elem)
+    {
+        return false;
+    }
+
+    RING_BUFFER_LATENCY_BEGIN();
+    const bool ret = ring_buffer_do_pop_sc(fifo, elem) || ring_buffer_wait_for(fifo, &(fifo->m_not_empty), ring_buffer_try_pop_sc, elem, timeout_us,
+        RING_BUFFER_STAT_POP_PARKS);
+    RING_BUFFER_LATENCY_END(RING_BUFFER_OP_POP_WAIT_SC);
+
+    return ret;
+}
+
+bool ring_buffer_pop_wait_mc(struct ring_buffer_mpmc* fifo, void** elem, unsigned long timeout_us)
+{
+    if (!fifo || !elem)
+    {
+        return false;
+    }
+
+    RING_BUFFER_LATENCY_BEGIN();
+    const bool ret = ring_buffer_do_pop_mc(fifo, elem) || ring_buffer_wait_for(fifo, &(fifo->m_not_empty), ring_buffer_try_pop_mc, elem, timeout_us,
+        RING_BUFFER_STAT_POP_PARKS);
+    RING_BUFFER_LATENCY_END(RING_BUFFER_OP_POP_WAIT_MC);
 
     return ret;
 }
@@ -27,8 +27,10 @@
 #define __RING_BUFFER_MPMC_H__
 
 #include "atomic_helper.h"
+#include "event_count.h"
 
 #include <stdbool.h>
+#include <stddef.h>
 #include <stdint.h>
 
 #if defined(_WIN32)
@@ -50,35 +52,192 @@ extern "C"
 {
 #endif
 
-#define RING_BUFFER_POW2 12U /* 2^x entries, can be growed up for no waits situations to limit buffer full cases */
+#define RING_BUFFER_POW2 12U /* default 2^x entries, can be growed up for no waits situations to limit buffer full cases */
 #define RING_BUFFER_SIZE (1ULL << RING_BUFFER_POW2)
 #define RING_BUFFER_MASK (RING_BUFFER_SIZE - 1ULL)
 
+/* 1: producer state, consumer state and slot array each live on their own cache lines,
+   0: packed layout (fields share cache lines, kept to measure the false sharing cost) */
+#if !defined(RING_BUFFER_MPMC_CACHE_ALIGNED)
+#define RING_BUFFER_MPMC_CACHE_ALIGNED 1
+#endif
+
+#if RING_BUFFER_MPMC_CACHE_ALIGNED
+#define RING_BUFFER_ALIGNED CACHE_LINE_ALIGNED
+#define RING_BUFFER_STORAGE_ALIGNMENT CACHE_LINE_SIZE
+#else
+#define RING_BUFFER_ALIGNED
+#define RING_BUFFER_STORAGE_ALIGNMENT sizeof(void*)
+#endif
+
+/* 1: record the latency of every push/pop entry point in per-thread log-linear histograms
+   (see ring_buffer_mpmc_latency_xxx), 0: compiled out */
+#if !defined(RING_BUFFER_MPMC_LATENCY_HISTOGRAMS)
+#define RING_BUFFER_MPMC_LATENCY_HISTOGRAMS 0
+#endif
+
+/* 1: count full/empty rejections, handshake spins, mutex contention and parks per queue
+   (see ring_buffer_mpmc_stats_xxx), 0: compiled out */
+#if !defined(RING_BUFFER_MPMC_STATS)
+#define RING_BUFFER_MPMC_STATS 0
+#endif
+
+/* number of queues a thread remembers its counter block for, the block of any other queue
+   is looked up in the queue's list */
+#if !defined(RING_BUFFER_STATS_THREAD_CACHES)
+#define RING_BUFFER_STATS_THREAD_CACHES 8
+#endif
+
+/* number of retries (with a cpu relax hint) before a blocking push/pop parks the thread */
+#if !defined(RING_BUFFER_WAIT_SPINS)
+#define RING_BUFFER_WAIT_SPINS 128
+#endif
+
+#define RING_BUFFER_WAIT_INFINITE EVENT_COUNT_INFINITE
+
+#if RING_BUFFER_MPMC_LATENCY_HISTOGRAMS
+#include "latency_histogram.h"
+
+#include <stdio.h>
+#endif
+
+    enum ring_buffer_mpmc_stat
+    {
+        RING_BUFFER_STAT_PUSH_OK,            /* elements pushed */
+        RING_BUFFER_STAT_PUSH_FULL,          /* push rejected, queue full */
+        RING_BUFFER_STAT_POP_OK,             /* elements popped */
+        RING_BUFFER_STAT_POP_EMPTY,          /* pop rejected, queue empty */
+        RING_BUFFER_STAT_WRITE_SPINS,        /* producer iterations waiting for m_reading */
+        RING_BUFFER_STAT_READ_SPINS,         /* consumer iterations waiting for m_writing */
+        RING_BUFFER_STAT_WRITE_LOCK_WAITS,   /* m_write_mutex found busy */
+        RING_BUFFER_STAT_WRITE_LOCK_WAIT_NS, /* time blocked on m_write_mutex */
+        RING_BUFFER_STAT_READ_LOCK_WAITS,    /* m_read_mutex found busy */
+        RING_BUFFER_STAT_READ_LOCK_WAIT_NS,  /* time blocked on m_read_mutex */
+        RING_BUFFER_STAT_PUSH_PARKS,         /* blocking push parked on a full queue */
+        RING_BUFFER_STAT_POP_PARKS,          /* blocking pop parked on an empty queue */
+        RING_BUFFER_STAT_COUNT
+    };
+
+    struct ring_buffer_mpmc_stats
+    {
+        unsigned long long m_counters[RING_BUFFER_STAT_COUNT];
+    };
+
+#if RING_BUFFER_MPMC_STATS
+    /* counters of one thread on one queue, only written by that thread */
+    struct ring_buffer_mpmc_stats_block
+    {
+        RING_BUFFER_ALIGNED _atomic_llong m_counters[RING_BUFFER_STAT_COUNT];
+        const void* m_owner;
+        struct ring_buffer_mpmc_stats_block* m_next;
+    };
+#endif
+
     struct ring_buffer_mpmc
     {
-        _atomic_uintptr m_buffer[RING_BUFFER_SIZE];
-        _atomic_llong m_read_idx;
-        _atomic_llong m_write_idx;
-        _atomic_bool m_reading;
+        /* read-only after init */
+        _atomic_uintptr* m_buffer;
+        long long m_size; /* power of two, the ring holds up to m_size - 1 elements */
+        long long m_mask;
+        bool m_owns_buffer;
+
+        /* producer side */
+        RING_BUFFER_ALIGNED _atomic_llong m_write_idx;
         _atomic_bool m_writing;
+#if defined(_WIN32)
+        CRITICAL_SECTION m_write_mutex;
+#elif defined(__STDC_NO_THREADS__)
+    pthread_mutex_t m_write_mutex;
+#else
+    mtx_t m_write_mutex;
+#endif
 
+        /* consumer side */
+        RING_BUFFER_ALIGNED _atomic_llong m_read_idx;
+        _atomic_bool m_reading;
 #if defined(_WIN32)
         CRITICAL_SECTION m_read_mutex;
-        CRITICAL_SECTION m_write_mutex;
 #elif defined(__STDC_NO_THREADS__)
     pthread_mutex_t m_read_mutex;
-    pthread_mutex_t m_write_mutex;
 #else
     mtx_t m_read_mutex;
-    mtx_t m_write_mutex;
+#endif
+
+        /* blocking side, waiter counts are only read by the non blocking paths */
+        RING_BUFFER_ALIGNED struct event_count m_not_empty;
+        struct event_count m_not_full;
+
+#if RING_BUFFER_MPMC_STATS
+        /* list of struct ring_buffer_mpmc_stats_block, released by deinit */
+        _atomic_llong m_stats_blocks;
+        long long m_stats_id; /* unique per init, tells the thread caches of a reused queue address apart */
 #endif
     };
 
+    /* default capacity of RING_BUFFER_SIZE entries, storage allocated on the heap */
     EXTERN_RING_BUFFER_MPMC int init_ring_buffer_mpmc(struct ring_buffer_mpmc* fifo);
+
+    /* capacity must be a power of two, storage can be NULL (allocated on the heap and released by deinit)
+       or point to ring_buffer_mpmc_storage_size(capacity) bytes owned by the caller, preferably aligned
+       on RING_BUFFER_STORAGE_ALIGNMENT */
+    EXTERN_RING_BUFFER_MPMC int init_ring_buffer_mpmc_ex(struct ring_buffer_mpmc* fifo, unsigned long long capacity, void* storage);
+    EXTERN_RING_BUFFER_MPMC size_t ring_buffer_mpmc_storage_size(unsigned long long capacity);
     EXTERN_RING_BUFFER_MPMC int deinit_ring_buffer_mpmc(struct ring_buffer_mpmc* fifo);
     EXTERN_RING_BUFFER_MPMC bool ring_buffer_push_sp(struct ring_buffer_mpmc* fifo, void* elem);
     EXTERN_RING_BUFFER_MPMC bool ring_buffer_push_mp(struct ring_buffer_mpmc* fifo, void* elem);
     EXTERN_RING_BUFFER_MPMC bool ring_buffer_pop_sc(struct ring_buffer_mpmc* fifo, void** elem);
     EXTERN_RING_BUFFER_MPMC bool ring_buffer_pop_mc(struct ring_buffer_mpmc* fifo, void** elem);
 
+    /* batch variants, a contiguous range of slots is reserved with a single index update,
+       return the number of elements actually transferred (0 if full/empty) */
+    EXTERN_RING_BUFFER_MPMC size_t ring_buffer_push_n_sp(struct ring_buffer_mpmc* fifo, void* const* elems, size_t count);
+    EXTERN_RING_BUFFER_MPMC size_t ring_buffer_push_n_mp(struct ring_buffer_mpmc* fifo, void* const* elems, size_t count);
+    EXTERN_RING_BUFFER_MPMC size_t ring_buffer_pop_n_sc(struct ring_buffer_mpmc* fifo, void** elems, size_t count);
+    EXTERN_RING_BUFFER_MPMC size_t ring_buffer_pop_n_mc(struct ring_buffer_mpmc* fifo, void** elems, size_t count);
+
+    /* blocking variants, spin up to RING_BUFFER_WAIT_SPINS retries then park until the queue is
+       not full/empty or timeout_us elapsed (0: single try, RING_BUFFER_WAIT_INFINITE: no timeout),
+       return false on timeout */
+    EXTERN_RING_BUFFER_MPMC bool ring_buffer_push_wait_sp(struct ring_buffer_mpmc* fifo, void* elem, unsigned long timeout_us);
+    EXTERN_RING_BUFFER_MPMC bool ring_buffer_push_wait_mp(struct ring_buffer_mpmc* fifo, void* elem, unsigned long timeout_us);
+    EXTERN_RING_BUFFER_MPMC bool ring_buffer_pop_wait_sc(struct ring_buffer_mpmc* fifo, void** elem, unsigned long timeout_us);
+    EXTERN_RING_BUFFER_MPMC bool ring_buffer_pop_wait_mc(struct ring_buffer_mpmc* fifo, void** elem, unsigned long timeout_us);
+
+    /* sum of the per thread counters (all zero when compiled out), a snapshot taken while the queue
+       is used is not atomic across counters; reset is not synchronized with the hot paths */
+    EXTERN_RING_BUFFER_MPMC void ring_buffer_mpmc_stats_snapshot(struct ring_buffer_mpmc* fifo, struct ring_buffer_mpmc_stats* stats);
+    EXTERN_RING_BUFFER_MPMC void ring_buffer_mpmc_stats_reset(struct ring_buffer_mpmc* fifo);
+    EXTERN_RING_BUFFER_MPMC const char* ring_buffer_mpmc_stat_name(enum ring_buffer_mpmc_stat stat);
+
+#if RING_BUFFER_MPMC_LATENCY_HISTOGRAMS
+    enum ring_buffer_mpmc_op
+    {
+        RING_BUFFER_OP_PUSH_SP,
+        RING_BUFFER_OP_PUSH_MP,
+        RING_BUFFER_OP_POP_SC,
+        RING_BUFFER_OP_POP_MC,
+        RING_BUFFER_OP_PUSH_N_SP,
+        RING_BUFFER_OP_PUSH_N_MP,
+        RING_BUFFER_OP_POP_N_SC,
+        RING_BUFFER_OP_POP_N_MC,
+        RING_BUFFER_OP_PUSH_WAIT_SP,
+        RING_BUFFER_OP_PUSH_WAIT_MP,
+        RING_BUFFER_OP_POP_WAIT_SC,
+        RING_BUFFER_OP_POP_WAIT_MC,
+        RING_BUFFER_OP_COUNT
+    };
+
+    /* histograms are per thread and per entry point (all queues together), merged on demand,
+       a thread's histograms outlive it so that its samples are kept */
+    EXTERN_RING_BUFFER_MPMC const char* ring_buffer_mpmc_op_name(enum ring_buffer_mpmc_op op);
+    EXTERN_RING_BUFFER_MPMC void ring_buffer_mpmc_latency_snapshot(enum ring_buffer_mpmc_op op, struct latency_histogram* merged);
+    EXTERN_RING_BUFFER_MPMC void ring_buffer_mpmc_latency_reset(void);
+    /* p50/p99/p99.9/max of every entry point called at least once */
+    EXTERN_RING_BUFFER_MPMC void ring_buffer_mpmc_latency_dump(FILE* out);
+#endif
+
+#if defined(__cplusplus)
+};
+#endif
+
 #endif /*  __RING_BUFFER_MPMC_H__ */
@@ -0,0 +1,200 @@
+//-----------------------------------------------------------------------------//
+// CRingBuffer MPMC - FIFO helper                                              //
+// (c) 2023 Laurent Lardinois https://be.linkedin.com/in/laurentlardinois      //
+//                                                                             //
+// https://github.com/type-one/CRingBuffer_MPSC                                //
+//                                                                             //
+// This software is provided 'as-is', without any express or implied           //
+// warranty.In no event will the authors be held liable for any damages        //
+// arising from the use of this software.                                      //
+//                                                                             //
+// Permission is granted to anyone to use this software for any purpose,       //
+// including commercial applications, and to alter itand redistribute it       //
+// freely, subject to the following restrictions :                             //
+//                                                                             //
+// 1. The origin of this software must not be misrepresented; you must not     //
+// claim that you wrote the original software.If you use this software         //
+// in a product, an acknowledgment in the product documentation would be       //
+// appreciated but is not required.                                            //
+// 2. Altered source versions must be plainly marked as such, and must not be  //
+// misrepresented as being the original software.                              //
+// 3. This notice may not be removed or altered from any source distribution.  //
+//-----------------------------------------------------------------------------//
+
+#include "atomic_helper.h"
+#define RING_BUFFER_MPMC_INLINE_IMPLEM
+#include "ring_buffer_mpmc_inline.h"
+#include "mem_alloc.h"
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <string.h>
+
+
+static size_t ring_buffer_inline_stride(size_t elem_size)
+{
+    const size_t align = sizeof(_atomic_llong);
+    return (sizeof(_atomic_llong) + elem_size + align - 1U) & ~(align - 1U);
+}
+
+static _atomic_llong* ring_buffer_inline_sequence(struct ring_buffer_mpmc_inline* fifo, long long idx)
+{
+    return (_atomic_llong*)(fifo->m_buffer + (size_t)(idx & fifo->m_mask) * fifo->m_stride);
+}
+
+static unsigned char* ring_buffer_inline_payload(struct ring_buffer_mpmc_inline* fifo, long long idx)
+{
+    return fifo->m_buffer + (size_t)(idx & fifo->m_mask) * fifo->m_stride + sizeof(_atomic_llong);
+}
+
+size_t ring_buffer_mpmc_inline_storage_size(unsigned long long capacity, size_t elem_size)
+{
+    return (size_t)capacity * ring_buffer_inline_stride(elem_size);
+}
+
+int init_ring_buffer_mpmc_inline(struct ring_buffer_mpmc_inline* fifo, size_t elem_size)
+{
+    return init_ring_buffer_mpmc_inline_ex(fifo, RING_BUFFER_SIZE, elem_size, NULL);
+}
+
+int init_ring_buffer_mpmc_inline_ex(struct ring_buffer_mpmc_inline* fifo, unsigned long long capacity, size_t elem_size, void* storage)
+{
+    if (!fifo || (0U == elem_size))
+    {
+        return -1;
+    }
+
+    /* power of two only, mask computed per instance */
+    if ((capacity < 2ULL) || (0ULL != (capacity & (capacity - 1ULL))))
+    {
+        return -1;
+    }
+
+    fifo->m_elem_size = elem_size;
+    fifo->m_stride = ring_buffer_inline_stride(elem_size);
+    fifo->m_owns_buffer = (NULL == storage);
+    fifo->m_buffer = (unsigned char*)(fifo->m_owns_buffer
+            ? mem_alloc_aligned(ring_buffer_mpmc_inline_storage_size(capacity, elem_size), RING_BUFFER_STORAGE_ALIGNMENT)
+            : storage);
+
+    if (!fifo->m_buffer)
+    {
+        return -1;
+    }
+
+    fifo->m_size = (long long)capacity;
+    fifo->m_mask = (long long)(capacity - 1ULL);
+
+    memset((void*)(fifo->m_buffer), 0, ring_buffer_mpmc_inline_storage_size(capacity, elem_size));
+    for (long long i = 0; i < fifo->m_size; ++i)
+    {
+        sync_atomic_store(*ring_buffer_inline_sequence(fifo, i), i);
+    }
+
+    sync_atomic_store(fifo->m_read_idx, 0LL);
+    sync_atomic_store(fifo->m_write_idx, 0LL);
+    sync_write_release();
+
+    return 0;
+}
+
+int deinit_ring_buffer_mpmc_inline(struct ring_buffer_mpmc_inline* fifo)
+{
+    if (!fifo)
+    {
+        return -1;
+    }
+
+    if (fifo->m_owns_buffer)
+    {
+        mem_free_aligned((void*)(fifo->m_buffer));
+    }
+    fifo->m_buffer = NULL;
+
+    return 0;
+}
+
+bool ring_buffer_inline_push(struct ring_buffer_mpmc_inline* fifo, const void* elem)
+{
+    if (!fifo || !elem)
+    {
+        return false;
+    }
+
+    long long write_idx = sync_atomic_load_relaxed(fifo->m_write_idx);
+
+    for (;;)
+    {
+        const long long sequence = sync_atomic_load_acquire(*ring_buffer_inline_sequence(fifo, write_idx));
+        const long long diff = sequence - write_idx;
+
+        if (0 == diff)
+        {
+            /* slot is free for this lap, try to claim it (write_idx is reloaded on failure) */
+            if (sync_atomic_cas_64_relaxed(fifo->m_write_idx, write_idx, write_idx + 1))
+            {
+                break;
+            }
+        }
+        else if (diff < 0)
+        {
+            /* is full ? slot not yet released by the consumer of the previous lap */
+            return false;
+        }
+        else
+        {
+            /* another producer already claimed this slot */
+            write_idx = sync_atomic_load_relaxed(fifo->m_write_idx);
+        }
+    }
+
+    /* the slot is owned until the sequence is published */
+    memcpy(ring_buffer_inline_payload(fifo, write_idx), elem, fifo->m_elem_size);
+
+    /* publish to the consumers */
+    sync_atomic_store_release(*ring_buffer_inline_sequence(fifo, write_idx), write_idx + 1);
+
+    return true;
+}
+
+bool ring_buffer_inline_pop(struct ring_buffer_mpmc_inline* fifo, void* elem)
+{
+    if (!fifo || !elem)
+    {
+        return false;
+    }
+
+    long long read_idx = sync_atomic_load_relaxed(fifo->m_read_idx);
+
+    for (;;)
+    {
+        const long long sequence = sync_atomic_load_acquire(*ring_buffer_inline_sequence(fifo, read_idx));
+        const long long diff = sequence - (read_idx + 1);
+
+        if (0 == diff)
+        {
+            /* slot is published for this lap, try to claim it (read_idx is reloaded on failure) */
+            if (sync_atomic_cas_64_relaxed(fifo->m_read_idx, read_idx, read_idx + 1))
+            {
+                break;
+            }
+        }
+        else if (diff < 0)
+        {
+            /* is empty ? slot not yet published by the producer */
+            return false;
+        }
+        else
+        {
+            /* another consumer already claimed this slot */
+            read_idx = sync_atomic_load_relaxed(fifo->m_read_idx);
+        }
+    }
+
+    memcpy(elem, ring_buffer_inline_payload(fifo, read_idx), fifo->m_elem_size);
+
+    /* release the slot for the producers of the next lap */
+    sync_atomic_store_release(*ring_buffer_inline_sequence(fifo, read_idx), read_idx + fifo->m_size);
+
+    return true;
+}
@@ -0,0 +1,87 @@
+//-----------------------------------------------------------------------------//
+// CRingBuffer MPMC - FIFO helper                                              //
+// (c) 2023 Laurent Lardinois https://be.linkedin.com/in/laurentlardinois      //
+//                                                                             //
+// https://github.com/type-one/CRingBuffer_MPSC                                //
+//                                                                             //
+// This software is provided 'as-is', without any express or implied           //
+// warranty.In no event will the authors be held liable for any damages        //
+// arising from the use of this software.                                      //
+//                                                                             //
+// Permission is granted to anyone to use this software for any purpose,       //
+// including commercial applications, and to alter itand redistribute it       //
+// freely, subject to the following restrictions :                             //
+//                                                                             //
+// 1. The origin of this software must not be misrepresented; you must not     //
+// claim that you wrote the original software.If you use this software         //
+// in a product, an acknowledgment in the product documentation would be       //
+// appreciated but is not required.                                            //
+// 2. Altered source versions must be plainly marked as such, and must not be  //
+// misrepresented as being the original software.                              //
+// 3. This notice may not be removed or altered from any source distribution.  //
+//-----------------------------------------------------------------------------//
+
+#pragma once
+
+#if !defined(__RING_BUFFER_MPMC_INLINE_H__)
+#define __RING_BUFFER_MPMC_INLINE_H__
+
+#include "atomic_helper.h"
+#include "ring_buffer_mpmc.h"
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#if defined(RING_BUFFER_MPMC_INLINE_IMPLEM)
+#define EXTERN_RING_BUFFER_MPMC_INLINE
+#else
+#define EXTERN_RING_BUFFER_MPMC_INLINE extern
+#endif
+
+#if defined(__cplusplus)
+extern "C"
+{
+#endif
+
+    /* lock-free MPMC engine storing fixed-size elements by value: each slot is a sequence number
+       followed by m_elem_size payload bytes, producers copy into the slot and consumers copy out,
+       no allocation and no pointer to chase (same slot claiming scheme as ring_buffer_mpmc_lf) */
+
+    struct ring_buffer_mpmc_inline
+    {
+        /* read-only after init */
+        unsigned char* m_buffer;
+        long long m_size; /* power of two, the ring holds up to m_size elements */
+        long long m_mask;
+        size_t m_elem_size;
+        size_t m_stride; /* sequence number + payload, rounded up to keep the sequence numbers aligned */
+        bool m_owns_buffer;
+
+        /* producer side */
+        RING_BUFFER_ALIGNED _atomic_llong m_write_idx;
+
+        /* consumer side */
+        RING_BUFFER_ALIGNED _atomic_llong m_read_idx;
+    };
+
+    /* default capacity of RING_BUFFER_SIZE entries, storage allocated on the heap */
+    EXTERN_RING_BUFFER_MPMC_INLINE int init_ring_buffer_mpmc_inline(struct ring_buffer_mpmc_inline* fifo, size_t elem_size);
+
+    /* capacity must be a power of two, storage can be NULL (allocated on the heap and released by deinit)
+       or point to ring_buffer_mpmc_inline_storage_size(capacity, elem_size) bytes owned by the caller,
+       preferably aligned on RING_BUFFER_STORAGE_ALIGNMENT */
+    EXTERN_RING_BUFFER_MPMC_INLINE int init_ring_buffer_mpmc_inline_ex(
+        struct ring_buffer_mpmc_inline* fifo, unsigned long long capacity, size_t elem_size, void* storage);
+    EXTERN_RING_BUFFER_MPMC_INLINE size_t ring_buffer_mpmc_inline_storage_size(unsigned long long capacity, size_t elem_size);
+    EXTERN_RING_BUFFER_MPMC_INLINE int deinit_ring_buffer_mpmc_inline(struct ring_buffer_mpmc_inline* fifo);
+
+    /* copy m_elem_size bytes from elem into the ring / from the ring into elem */
+    EXTERN_RING_BUFFER_MPMC_INLINE bool ring_buffer_inline_push(struct ring_buffer_mpmc_inline* fifo, const void* elem);
+    EXTERN_RING_BUFFER_MPMC_INLINE bool ring_buffer_inline_pop(struct ring_buffer_mpmc_inline* fifo, void* elem);
+
+#if defined(__cplusplus)
+};
+#endif
+
+#endif /*  __RING_BUFFER_MPMC_INLINE_H__ */
@@ -0,0 +1,303 @@
+//-----------------------------------------------------------------------------//
+// CRingBuffer MPMC - FIFO helper                                              //
+// (c) 2023 Laurent Lardinois https://be.linkedin.com/in/laurentlardinois      //
+//                                                                             //
+// https://github.com/type-one/CRingBuffer_MPSC                                //
+//                                                                             //
+// This software is provided 'as-is', without any express or implied           //
+// warranty.In no event will the authors be held liable for any damages        //
+// arising from the use of this software.                                      //
+//                                                                             //
+// Permission is granted to anyone to use this software for any purpose,       //
+// including commercial applications, and to alter itand redistribute it       //
+// freely, subject to the following restrictions :                             //
+//                                                                             //
+// 1. The origin of this software must not be misrepresented; you must not     //
+// claim that you wrote the original software.If you use this software         //
+// in a product, an acknowledgment in the product documentation would be       //
+// appreciated but is not required.                                            //
+// 2. Altered source versions must be plainly marked as such, and must not be  //
+// misrepresented as being the original software.                              //
+// 3. This notice may not be removed or altered from any source distribution.  //
+//-----------------------------------------------------------------------------//
+
+#include "atomic_helper.h"
+#define RING_BUFFER_MPMC_LF_IMPLEM
+#include "ring_buffer_mpmc_lf.h"
+#include "mem_alloc.h"
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <string.h>
+
+
+size_t ring_buffer_mpmc_lf_storage_size(unsigned long long capacity)
+{
+    return (size_t)capacity * sizeof(struct ring_buffer_mpmc_lf_cell);
+}
+
+int init_ring_buffer_mpmc_lf(struct ring_buffer_mpmc_lf* fifo)
+{
+    return init_ring_buffer_mpmc_lf_ex(fifo, RING_BUFFER_SIZE, NULL);
+}
+
+int init_ring_buffer_mpmc_lf_ex(struct ring_buffer_mpmc_lf* fifo, unsigned long long capacity, void* storage)
+{
+    if (!fifo)
+    {
+        return -1;
+    }
+
+    /* power of two only, mask computed per instance */
+    if ((capacity < 2ULL) || (0ULL != (capacity & (capacity - 1ULL))))
+    {
+        return -1;
+    }
+
+    fifo->m_owns_buffer = (NULL == storage);
+    fifo->m_buffer = (struct ring_buffer_mpmc_lf_cell*)(fifo->m_owns_buffer
+            ? mem_alloc_aligned(ring_buffer_mpmc_lf_storage_size(capacity), RING_BUFFER_STORAGE_ALIGNMENT)
+            : storage);
+
+    if (!fifo->m_buffer)
+    {
+        return -1;
+    }
+
+    fifo->m_size = (long long)capacity;
+    fifo->m_mask = (long long)(capacity - 1ULL);
+
+    for (long long i = 0; i < fifo->m_size; ++i)
+    {
+        sync_atomic_store(fifo->m_buffer[i].m_sequence, i);
+        sync_atomic_store(fifo->m_buffer[i].m_data, (uintptr_t)0U);
+    }
+
+    sync_atomic_store(fifo->m_read_idx, 0LL);
+    sync_atomic_store(fifo->m_write_idx, 0LL);
+    sync_write_release();
+
+    return 0;
+}
+
+int deinit_ring_buffer_mpmc_lf(struct ring_buffer_mpmc_lf* fifo)
+{
+    if (!fifo)
+    {
+        return -1;
+    }
+
+    if (fifo->m_owns_buffer)
+    {
+        mem_free_aligned((void*)(fifo->m_buffer));
+    }
+    fifo->m_buffer = NULL;
+
+    return 0;
+}
+
+bool ring_buffer_lf_push(struct ring_buffer_mpmc_lf* fifo, void* elem)
+{
+    if (!fifo || !elem)
+    {
+        return false;
+    }
+
+    struct ring_buffer_mpmc_lf_cell* cell;
+    long long write_idx = sync_atomic_load_relaxed(fifo->m_write_idx);
+
+    for (;;)
+    {
+        cell = &(fifo->m_buffer[write_idx & fifo->m_mask]);
+        const long long sequence = sync_atomic_load_acquire(cell->m_sequence);
+        const long long diff = sequence - write_idx;
+
+        if (0 == diff)
+        {
+            /* slot is free for this lap, try to claim it (write_idx is reloaded on failure) */
+            if (sync_atomic_cas_64_relaxed(fifo->m_write_idx, write_idx, write_idx + 1))
+            {
+                break;
+            }
+        }
+        else if (diff < 0)
+        {
+            /* is full ? slot not yet released by the consumer of the previous lap */
+            return false;
+        }
+        else
+        {
+            /* another producer already claimed this slot */
+            write_idx = sync_atomic_load_relaxed(fifo->m_write_idx);
+        }
+    }
+
+    sync_atomic_store_relaxed(cell->m_data, (uintptr_t)elem);
+
+    /* publish to the consumers */
+    sync_atomic_store_release(cell->m_sequence, write_idx + 1);
+
+    return true;
+}
+
+bool ring_buffer_lf_pop(struct ring_buffer_mpmc_lf* fifo, void** elem)
+{
+    if (!fifo || !elem)
+    {
+        return false;
+    }
+
+    struct ring_buffer_mpmc_lf_cell* cell;
+    long long read_idx = sync_atomic_load_relaxed(fifo->m_read_idx);
+
+    for (;;)
+    {
+        cell = &(fifo->m_buffer[read_idx & fifo->m_mask]);
+        const long long sequence = sync_atomic_load_acquire(cell->m_sequence);
+        const long long diff = sequence - (read_idx + 1);
+
+        if (0 == diff)
+        {
+            /* slot is published for this lap, try to claim it (read_idx is reloaded on failure) */
+            if (sync_atomic_cas_64_relaxed(fifo->m_read_idx, read_idx, read_idx + 1))
+            {
+                break;
+            }
+        }
+        else if (diff < 0)
+        {
+            /* is empty ? slot not yet published by the producer */
+            return false;
+        }
+        else
+        {
+            /* another consumer already claimed this slot */
+            read_idx = sync_atomic_load_relaxed(fifo->m_read_idx);
+        }
+    }
+
+    *elem = (void*)sync_atomic_load_relaxed(cell->m_data);
+
+    /* release the slot for the producers of the next lap */
+    sync_atomic_store_release(cell->m_sequence, read_idx + fifo->m_size);
+
+    return (*elem == NULL) ? false : true;
+}
+
+size_t ring_buffer_lf_push_n(struct ring_buffer_mpmc_lf* fifo, void* const* elems, size_t count)
+{
+    if (!fifo || !elems || (0U == count))
+    {
+        return 0U;
+    }
+
+    size_t nb;
+    long long write_idx = sync_atomic_load_relaxed(fifo->m_write_idx);
+
+    for (;;)
+    {
+        long long diff = 0;
+        nb = 0U;
+
+        /* count the consecutive slots free for this lap (null pointers cannot be queued) */
+        while ((nb < count) && elems[nb])
+        {
+            const long long sequence = sync_atomic_load_acquire(fifo->m_buffer[(write_idx + (long long)nb) & fifo->m_mask].m_sequence);
+            diff = sequence - (write_idx + (long long)nb);
+
+            if (0 != diff)
+            {
+                break;
+            }
+
+            ++nb;
+        }
+
+        if (nb > 0U)
+        {
+            /* claim the whole run at once (write_idx is reloaded on failure) */
+            if (sync_atomic_cas_64_relaxed(fifo->m_write_idx, write_idx, write_idx + (long long)nb))
+            {
+                break;
+            }
+        }
+        else if (diff <= 0)
+        {
+            /* is full ? (or null first element) */
+            return 0U;
+        }
+        else
+        {
+            /* another producer already claimed this slot */
+            write_idx = sync_atomic_load_relaxed(fifo->m_write_idx);
+        }
+    }
+
+    for (size_t i = 0U; i < nb; ++i)
+    {
+        struct ring_buffer_mpmc_lf_cell* cell = &(fifo->m_buffer[(write_idx + (long long)i) & fifo->m_mask]);
+        sync_atomic_store_relaxed(cell->m_data, (uintptr_t)elems[i]);
+        sync_atomic_store_release(cell->m_sequence, write_idx + (long long)i + 1);
+    }
+
+    return nb;
+}
+
+size_t ring_buffer_lf_pop_n(struct ring_buffer_mpmc_lf* fifo, void** elems, size_t count)
+{
+    if (!fifo || !elems || (0U == count))
+    {
+        return 0U;
+    }
+
+    size_t nb;
+    long long read_idx = sync_atomic_load_relaxed(fifo->m_read_idx);
+
+    for (;;)
+    {
+        long long diff = 0;
+        nb = 0U;
+
+        /* count the consecutive slots published for this lap */
+        while (nb < count)
+        {
+            const long long sequence = sync_atomic_load_acquire(fifo->m_buffer[(read_idx + (long long)nb) & fifo->m_mask].m_sequence);
+            diff = sequence - (read_idx + (long long)nb + 1);
+
+            if (0 != diff)
+            {
+                break;
+            }
+
+            ++nb;
+        }
+
+        if (nb > 0U)
+        {
+            /* claim the whole run at once (read_idx is reloaded on failure) */
+            if (sync_atomic_cas_64_relaxed(fifo->m_read_idx, read_idx, read_idx + (long long)nb))
+            {
+                break;
+            }
+        }
+        else if (diff < 0)
+        {
+            /* is empty ? */
+            return 0U;
+        }
+        else
+        {
+            /* another consumer already claimed this slot */
+            read_idx = sync_atomic_load_relaxed(fifo->m_read_idx);
+        }
+    }
+
+    for (size_t i = 0U; i < nb; ++i)
+    {
+        struct ring_buffer_mpmc_lf_cell* cell = &(fifo->m_buffer[(read_idx + (long long)i) & fifo->m_mask]);
+        elems[i] = (void*)sync_atomic_load_relaxed(cell->m_data);
+        sync_atomic_store_release(cell->m_sequence, read_idx + (long long)i + fifo->m_size);
+    }
+
+    return nb;
+}
@@ -0,0 +1,93 @@
+//-----------------------------------------------------------------------------//
+// CRingBuffer MPMC - FIFO helper                                              //
+// (c) 2023 Laurent Lardinois https://be.linkedin.com/in/laurentlardinois      //
+//                                                                             //
+// https://github.com/type-one/CRingBuffer_MPSC                                //
+//                                                                             //
+// This software is provided 'as-is', without any express or implied           //
+// warranty.In no event will the authors be held liable for any damages        //
+// arising from the use of this software.                                      //
+//                                                                             //
+// Permission is granted to anyone to use this software for any purpose,       //
+// including commercial applications, and to alter itand redistribute it       //
+// freely, subject to the following restrictions :                             //
+//                                                                             //
+// 1. The origin of this software must not be misrepresented; you must not     //
+// claim that you wrote the original software.If you use this software         //
+// in a product, an acknowledgment in the product documentation would be       //
+// appreciated but is not required.                                            //
+// 2. Altered source versions must be plainly marked as such, and must not be  //
+// misrepresented as being the original software.                              //
+// 3. This notice may not be removed or altered from any source distribution.  //
+//-----------------------------------------------------------------------------//
+
+#pragma once
+
+#if !defined(__RING_BUFFER_MPMC_LF_H__)
+#define __RING_BUFFER_MPMC_LF_H__
+
+#include "atomic_helper.h"
+#include "ring_buffer_mpmc.h"
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#if defined(RING_BUFFER_MPMC_LF_IMPLEM)
+#define EXTERN_RING_BUFFER_MPMC_LF
+#else
+#define EXTERN_RING_BUFFER_MPMC_LF extern
+#endif
+
+#if defined(__cplusplus)
+extern "C"
+{
+#endif
+
+    /* lock-free MPMC engine: every slot carries its own sequence number, producers and consumers
+       claim slots with a CAS on the shared write/read index instead of taking the mutex pair
+       (bounded MPMC queue design from Dmitry Vyukov) */
+
+    struct ring_buffer_mpmc_lf_cell
+    {
+        _atomic_llong m_sequence;
+        _atomic_uintptr m_data;
+    };
+
+    struct ring_buffer_mpmc_lf
+    {
+        /* read-only after init */
+        struct ring_buffer_mpmc_lf_cell* m_buffer;
+        long long m_size; /* power of two, the ring holds up to m_size elements */
+        long long m_mask;
+        bool m_owns_buffer;
+
+        /* producer side */
+        RING_BUFFER_ALIGNED _atomic_llong m_write_idx;
+
+        /* consumer side */
+        RING_BUFFER_ALIGNED _atomic_llong m_read_idx;
+    };
+
+    /* default capacity of RING_BUFFER_SIZE entries, storage allocated on the heap */
+    EXTERN_RING_BUFFER_MPMC_LF int init_ring_buffer_mpmc_lf(struct ring_buffer_mpmc_lf* fifo);
+
+    /* capacity must be a power of two, storage can be NULL (allocated on the heap and released by deinit)
+       or point to ring_buffer_mpmc_lf_storage_size(capacity) bytes owned by the caller, preferably aligned
+       on RING_BUFFER_STORAGE_ALIGNMENT */
+    EXTERN_RING_BUFFER_MPMC_LF int init_ring_buffer_mpmc_lf_ex(struct ring_buffer_mpmc_lf* fifo, unsigned long long capacity, void* storage);
+    EXTERN_RING_BUFFER_MPMC_LF size_t ring_buffer_mpmc_lf_storage_size(unsigned long long capacity);
+    EXTERN_RING_BUFFER_MPMC_LF int deinit_ring_buffer_mpmc_lf(struct ring_buffer_mpmc_lf* fifo);
+    EXTERN_RING_BUFFER_MPMC_LF bool ring_buffer_lf_push(struct ring_buffer_mpmc_lf* fifo, void* elem);
+    EXTERN_RING_BUFFER_MPMC_LF bool ring_buffer_lf_pop(struct ring_buffer_mpmc_lf* fifo, void** elem);
+
+    /* batch variants, a run of consecutive ready slots is claimed with a single CAS,
+       return the number of elements actually transferred (0 if full/empty) */
+    EXTERN_RING_BUFFER_MPMC_LF size_t ring_buffer_lf_push_n(struct ring_buffer_mpmc_lf* fifo, void* const* elems, size_t count);
+    EXTERN_RING_BUFFER_MPMC_LF size_t ring_buffer_lf_pop_n(struct ring_buffer_mpmc_lf* fifo, void** elems, size_t count);
+
+#if defined(__cplusplus)
+};
+#endif
+
+#endif /*  __RING_BUFFER_MPMC_LF_H__ */
@@ -0,0 +1,300 @@
+//-----------------------------------------------------------------------------//
+// CRingBuffer MPMC - FIFO helper                                              //
+// (c) 2023 Laurent Lardinois https://be.linkedin.com/in/laurentlardinois      //
+//                                                                             //
+// https://github.com/type-one/CRingBuffer_MPSC                                //
+//                                                                             //
+// This software is provided 'as-is', without any express or implied           //
+// warranty.In no event will the authors be held liable for any damages        //
+// arising from the use of this software.                                      //
+//                                                                             //
+// Permission is granted to anyone to use this software for any purpose,       //
+// including commercial applications, and to alter itand redistribute it       //
+// freely, subject to the following restrictions :                             //
+//                                                                             //
+// 1. The origin of this software must not be misrepresented; you must not     //
+// claim that you wrote the original software.If you use this software         //
+// in a product, an acknowledgment in the product documentation would be       //
+// appreciated but is not required.                                            //
+// 2. Altered source versions must be plainly marked as such, and must not be  //
+// misrepresented as being the original software.                              //
+// 3. This notice may not be removed or altered from any source distribution.  //
+//-----------------------------------------------------------------------------//
+
+#include "atomic_helper.h"
+#define RING_BUFFER_NUMA_IMPLEM
+#include "ring_buffer_numa.h"
+#include "mem_alloc.h"
+#include "ring_buffer_mpmc_lf.h"
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+
+#if defined(_WIN32)
+#include <windows.h>
+#elif defined(__linux__)
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+static THREAD_LOCAL int st_thread_node = -1;
+
+
+int ring_buffer_numa_node_count(void)
+{
+    int count = 1;
+
+#if defined(_WIN32)
+    ULONG highest = 0;
+    if (GetNumaHighestNodeNumber(&highest))
+    {
+        count = (int)highest + 1;
+    }
+#elif defined(__linux__)
+    /* "0", "0-1", "0-3,5"... the highest node gives the count */
+    FILE* file = fopen("/sys/devices/system/node/possible", "r");
+    if (file)
+    {
+        int first = 0;
+        int node = 0;
+        char separator = 0;
+
+        if (1 == fscanf(file, "%d", &first))
+        {
+            node = first;
+            while (2 == fscanf(file, "%c%d", &separator, &node))
+            {
+            }
+            count = node + 1;
+        }
+        fclose(file);
+    }
+#endif
+
+    if (count > RING_BUFFER_NUMA_MAX_NODES)
+    {
+        count = RING_BUFFER_NUMA_MAX_NODES;
+    }
+
+    return (count > 0) ? count : 1;
+}
+
+int ring_buffer_numa_current_node(void)
+{
+#if defined(_WIN32)
+    PROCESSOR_NUMBER processor;
+    USHORT node = 0;
+
+    GetCurrentProcessorNumberEx(&processor);
+    if (GetNumaProcessorNodeEx(&processor, &node))
+    {
+        return (int)node;
+    }
+#elif defined(__linux__) && defined(SYS_getcpu)
+    unsigned int cpu = 0U;
+    unsigned int node = 0U;
+
+    if (0 == syscall(SYS_getcpu, &cpu, &node, NULL))
+    {
+        return (int)node;
+    }
+#endif
+
+    return 0;
+}
+
+void ring_buffer_numa_set_thread_node(int node)
+{
+    st_thread_node = (node >= 0) ? node : -1;
+}
+
+/* looked up once per thread, threads are expected to stay on their node */
+static int ring_buffer_numa_thread_node(struct ring_buffer_numa* fifo)
+{
+    if (st_thread_node < 0)
+    {
+        st_thread_node = ring_buffer_numa_current_node();
+    }
+
+    return st_thread_node % fifo->m_nb_nodes;
+}
+
+int init_ring_buffer_numa(struct ring_buffer_numa* fifo)
+{
+    return init_ring_buffer_numa_ex(fifo, 0, RING_BUFFER_SIZE, 0);
+}
+
+int init_ring_buffer_numa_ex(struct ring_buffer_numa* fifo, int nb_nodes, unsigned long long node_capacity, int page_flags)
+{
+    if (!fifo || (nb_nodes < 0) || (nb_nodes > RING_BUFFER_NUMA_MAX_NODES))
+    {
+        return -1;
+    }
+
+    if (0 == nb_nodes)
+    {
+        nb_nodes = ring_buffer_numa_node_count();
+    }
+
+    fifo->m_nodes = (struct ring_buffer_numa_node*)mem_alloc_aligned(
+        (size_t)nb_nodes * sizeof(struct ring_buffer_numa_node), RING_BUFFER_STORAGE_ALIGNMENT);
+
+    if (!fifo->m_nodes)
+    {
+        return -1;
+    }
+
+    fifo->m_page_flags = page_flags;
+
+    /* binding only makes sense with several nodes, more rings than nodes wrap around them */
+    const int machine_nodes = ring_buffer_numa_node_count();
+    const bool bind = (machine_nodes > 1);
+
+    for (int node = 0; node < nb_nodes; ++node)
+    {
+        struct ring_buffer_numa_node* local = &(fifo->m_nodes[node]);
+
+        local->m_storage_size = ring_buffer_mpmc_lf_storage_size(node_capacity);
+        local->m_storage = mem_alloc_pages(local->m_storage_size, page_flags, bind ? (node % machine_nodes) : MEM_ALLOC_ANY_NODE);
+        sync_atomic_store(local->m_steals, 0LL);
+        sync_atomic_store(local->m_spills, 0LL);
+
+        if (!local->m_storage || (init_ring_buffer_mpmc_lf_ex(&(local->m_ring), node_capacity, local->m_storage) < 0))
+        {
+            mem_free_pages(local->m_storage, local->m_storage_size, page_flags);
+
+            while (node-- > 0)
+            {
+                (void)deinit_ring_buffer_mpmc_lf(&(fifo->m_nodes[node].m_ring));
+                mem_free_pages(fifo->m_nodes[node].m_storage, fifo->m_nodes[node].m_storage_size, page_flags);
+            }
+            mem_free_aligned((void*)(fifo->m_nodes));
+            fifo->m_nodes = NULL;
+            return -1;
+        }
+    }
+
+    fifo->m_nb_nodes = nb_nodes;
+    sync_write_release();
+
+    return 0;
+}
+
+int deinit_ring_buffer_numa(struct ring_buffer_numa* fifo)
+{
+    if (!fifo)
+    {
+        return -1;
+    }
+
+    for (int node = 0; node < fifo->m_nb_nodes; ++node)
+    {
+        (void)deinit_ring_buffer_mpmc_lf(&(fifo->m_nodes[node].m_ring));
+        mem_free_pages(fifo->m_nodes[node].m_storage, fifo->m_nodes[node].m_storage_size, fifo->m_page_flags);
+    }
+
+    mem_free_aligned((void*)(fifo->m_nodes));
+    fifo->m_nodes = NULL;
+    fifo->m_nb_nodes = 0;
+
+    return 0;
+}
+
+bool ring_buffer_numa_push_node(struct ring_buffer_numa* fifo, int node, void* elem)
+{
+    if (!fifo || !elem || (node < 0))
+    {
+        return false;
+    }
+
+    node %= fifo->m_nb_nodes;
+
+    if (ring_buffer_lf_push(&(fifo->m_nodes[node].m_ring), elem))
+    {
+        return true;
+    }
+
+    /* local ring full, spill to the next nodes */
+    for (int i = 1; i < fifo->m_nb_nodes; ++i)
+    {
+        if (ring_buffer_lf_push(&(fifo->m_nodes[(node + i) % fifo->m_nb_nodes].m_ring), elem))
+        {
+            sync_atomic_inc_64(fifo->m_nodes[node].m_spills);
+            return true;
+        }
+    }
+
+    return false;
+}
+
+bool ring_buffer_numa_pop_node(struct ring_buffer_numa* fifo, int node, void** elem)
+{
+    if (!fifo || !elem || (node < 0))
+    {
+        return false;
+    }
+
+    node %= fifo->m_nb_nodes;
+
+    if (ring_buffer_lf_pop(&(fifo->m_nodes[node].m_ring), elem))
+    {
+        return true;
+    }
+
+    /* local ring empty, steal from the next nodes */
+    for (int i = 1; i < fifo->m_nb_nodes; ++i)
+    {
+        if (ring_buffer_lf_pop(&(fifo->m_nodes[(node + i) % fifo->m_nb_nodes].m_ring), elem))
+        {
+            sync_atomic_inc_64(fifo->m_nodes[node].m_steals);
+            return true;
+        }
+    }
+
+    return false;
+}
+
+bool ring_buffer_numa_push(struct ring_buffer_numa* fifo, void* elem)
+{
+    if (!fifo)
+    {
+        return false;
+    }
+
+    return ring_buffer_numa_push_node(fifo, ring_buffer_numa_thread_node(fifo), elem);
+}
+
+bool ring_buffer_numa_pop(struct ring_buffer_numa* fifo, void** elem)
+{
+    if (!fifo)
+    {
+        return false;
+    }
+
+    return ring_buffer_numa_pop_node(fifo, ring_buffer_numa_thread_node(fifo), elem);
+}
+
+long long ring_buffer_numa_steals(struct ring_buffer_numa* fifo)
+{
+    long long total = 0LL;
+
+    for (int node = 0; fifo && (node < fifo->m_nb_nodes); ++node)
+    {
+        total += sync_atomic_load_relaxed(fifo->m_nodes[node].m_steals);
+    }
+
+    return total;
+}
+
+long long ring_buffer_numa_spills(struct ring_buffer_numa* fifo)
+{
+    long long total = 0LL;
+
+    for (int node = 0; fifo && (node < fifo->m_nb_nodes); ++node)
+    {
+        total += sync_atomic_load_relaxed(fifo->m_nodes[node].m_spills);
+    }
+
+    return total;
+}
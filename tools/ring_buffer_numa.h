@@ -0,0 +1,109 @@
+//-----------------------------------------------------------------------------//
+// CRingBuffer MPMC - FIFO helper                                              //
+// (c) 2023 Laurent Lardinois https://be.linkedin.com/in/laurentlardinois      //
+//                                                                             //
+// https://github.com/type-one/CRingBuffer_MPSC                                //
+//                                                                             //
+// This software is provided 'as-is', without any express or implied           //
+// warranty.In no event will the authors be held liable for any damages        //
+// arising from the use of this software.                                      //
+//                                                                             //
+// Permission is granted to anyone to use this software for any purpose,       //
+// including commercial applications, and to alter itand redistribute it       //
+// freely, subject to the following restrictions :                             //
+//                                                                             //
+// 1. The origin of this software must not be misrepresented; you must not     //
+// claim that you wrote the original software.If you use this software         //
+// in a product, an acknowledgment in the product documentation would be       //
+// appreciated but is not required.                                            //
+// 2. Altered source versions must be plainly marked as such, and must not be  //
+// misrepresented as being the original software.                              //
+// 3. This notice may not be removed or altered from any source distribution.  //
+//-----------------------------------------------------------------------------//
+
+#pragma once
+
+#if !defined(__RING_BUFFER_NUMA_H__)
+#define __RING_BUFFER_NUMA_H__
+
+#include "atomic_helper.h"
+#include "ring_buffer_mpmc.h"
+#include "ring_buffer_mpmc_lf.h"
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#if defined(RING_BUFFER_NUMA_IMPLEM)
+#define EXTERN_RING_BUFFER_NUMA
+#else
+#define EXTERN_RING_BUFFER_NUMA extern
+#endif
+
+#if defined(__cplusplus)
+extern "C"
+{
+#endif
+
+    /* NUMA-aware MPMC queue: one lock-free ring (ring_buffer_mpmc_lf) per node, its slot storage bound
+       to that node, threads push and pop on the ring of their own node and only go to the remote rings
+       when the local one is full (spill) or empty (steal), so the indexes of a ring mostly stay in the
+       caches of one socket; the order is FIFO per node only.  The ring descriptors (indexes, counters)
+       are not node-local: they share one heap array, each on its own cache lines */
+
+#define RING_BUFFER_NUMA_MAX_NODES 64
+
+    struct ring_buffer_numa_node
+    {
+        struct ring_buffer_mpmc_lf m_ring;
+        void* m_storage;
+        size_t m_storage_size;
+
+        /* cross-node traffic initiated by the threads of this node */
+        RING_BUFFER_ALIGNED _atomic_llong m_steals; /* pops served by a remote ring */
+        _atomic_llong m_spills;                     /* pushes sent to a remote ring */
+    };
+
+    struct ring_buffer_numa
+    {
+        /* read-only after init */
+        struct ring_buffer_numa_node* m_nodes; /* cache line aligned array */
+        int m_nb_nodes;
+        int m_page_flags;
+    };
+
+    /* nodes of the machine (1 when unknown) and node of the CPU running the calling thread */
+    EXTERN_RING_BUFFER_NUMA int ring_buffer_numa_node_count(void);
+    EXTERN_RING_BUFFER_NUMA int ring_buffer_numa_current_node(void);
+
+    /* one ring of RING_BUFFER_SIZE entries per node of the machine */
+    EXTERN_RING_BUFFER_NUMA int init_ring_buffer_numa(struct ring_buffer_numa* fifo);
+
+    /* nb_nodes rings (0: node count of the machine), ring i bound to node i modulo the node count
+       when there are more rings than nodes, node_capacity must be a power of two,
+       page_flags from mem_alloc.h for the storage of each ring (MEM_ALLOC_HUGE_PAGES, MEM_ALLOC_PREFAULT) */
+    EXTERN_RING_BUFFER_NUMA int init_ring_buffer_numa_ex(
+        struct ring_buffer_numa* fifo, int nb_nodes, unsigned long long node_capacity, int page_flags);
+    EXTERN_RING_BUFFER_NUMA int deinit_ring_buffer_numa(struct ring_buffer_numa* fifo);
+
+    /* the node of a thread is looked up on its first push/pop and kept, a thread pinned (or moved) by
+       the application can set it explicitly */
+    EXTERN_RING_BUFFER_NUMA void ring_buffer_numa_set_thread_node(int node);
+
+    /* local ring first, false only if every ring is full / looks empty */
+    EXTERN_RING_BUFFER_NUMA bool ring_buffer_numa_push(struct ring_buffer_numa* fifo, void* elem);
+    EXTERN_RING_BUFFER_NUMA bool ring_buffer_numa_pop(struct ring_buffer_numa* fifo, void** elem);
+
+    /* explicit node, taken modulo the number of rings */
+    EXTERN_RING_BUFFER_NUMA bool ring_buffer_numa_push_node(struct ring_buffer_numa* fifo, int node, void* elem);
+    EXTERN_RING_BUFFER_NUMA bool ring_buffer_numa_pop_node(struct ring_buffer_numa* fifo, int node, void** elem);
+
+    /* cross-node pops and pushes, summed over the nodes */
+    EXTERN_RING_BUFFER_NUMA long long ring_buffer_numa_steals(struct ring_buffer_numa* fifo);
+    EXTERN_RING_BUFFER_NUMA long long ring_buffer_numa_spills(struct ring_buffer_numa* fifo);
+
+#if defined(__cplusplus)
+};
+#endif
+
+#endif /*  __RING_BUFFER_NUMA_H__ */
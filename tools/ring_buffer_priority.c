@@ -0,0 +1,286 @@
+//-----------------------------------------------------------------------------//
+// CRingBuffer MPMC - FIFO helper                                              //
+// (c) 2023 Laurent Lardinois https://be.linkedin.com/in/laurentlardinois      //
+//                                                                             //
+// https://github.com/type-one/CRingBuffer_MPSC                                //
+//                                                                             //
+// This software is provided 'as-is', without any express or implied           //
+// warranty.In no event will the authors be held liable for any damages        //
+// arising from the use of this software.                                      //
+//                                                                             //
+// Permission is granted to anyone to use this software for any purpose,       //
+// including commercial applications, and to alter itand redistribute it       //
+// freely, subject to the following restrictions :                             //
+//                                                                             //
+// 1. The origin of this software must not be misrepresented; you must not     //
+// claim that you wrote the original software.If you use this software         //
+// in a product, an acknowledgment in the product documentation would be       //
+// appreciated but is not required.                                            //
+// 2. Altered source versions must be plainly marked as such, and must not be  //
+// misrepresented as being the original software.                              //
+// 3. This notice may not be removed or altered from any source distribution.  //
+//-----------------------------------------------------------------------------//
+
+#include "atomic_helper.h"
+#define RING_BUFFER_PRIORITY_IMPLEM
+#include "ring_buffer_priority.h"
+#include "mem_alloc.h"
+#include "ring_buffer_mpmc.h"
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <string.h>
+
+#if defined(_MSC_VER)
+#include <intrin.h>
+#endif
+
+
+/* highest priority class in a non-empty bitmap */
+static int ring_buffer_priority_first_class(long long occupancy)
+{
+#if defined(_MSC_VER) && (defined(_M_X64) || defined(_M_ARM64))
+    unsigned long idx;
+    _BitScanForward64(&idx, (unsigned long long)occupancy);
+    return (int)idx;
+#elif defined(__GNUC__) || defined(__clang__)
+    return __builtin_ctzll((unsigned long long)occupancy);
+#else
+    int idx = 0;
+    while (0LL == (occupancy & (1LL << idx)))
+    {
+        ++idx;
+    }
+    return idx;
+#endif
+}
+
+/* smooth weighted round-robin: the classes are interleaved instead of served in bursts */
+static void ring_buffer_priority_build_schedule(struct ring_buffer_priority* fifo, const unsigned int* weights, int total)
+{
+    long current[RING_BUFFER_PRIORITY_MAX_CLASSES];
+
+    memset(current, 0, sizeof(current));
+
+    for (int step = 0; step < total; ++step)
+    {
+        int best = 0;
+
+        for (int i = 0; i < fifo->m_nb_classes; ++i)
+        {
+            current[i] += (long)weights[i];
+            if (current[i] > current[best])
+            {
+                best = i;
+            }
+        }
+
+        current[best] -= total;
+        fifo->m_schedule[step] = (unsigned char)best;
+    }
+
+    fifo->m_schedule_size = total;
+}
+
+static int ring_buffer_priority_select(struct ring_buffer_priority* fifo, long long occupancy)
+{
+    if (RING_BUFFER_PRIORITY_WEIGHTED == fifo->m_policy)
+    {
+        const long long ticket = sync_atomic_add_64_relaxed(fifo->m_ticket, 1LL);
+        const int scheduled = fifo->m_schedule[ticket % fifo->m_schedule_size];
+
+        if (0LL != (occupancy & (1LL << scheduled)))
+        {
+            return scheduled;
+        }
+    }
+
+    return ring_buffer_priority_first_class(occupancy);
+}
+
+static bool ring_buffer_priority_pop(struct ring_buffer_priority* fifo, void** elem, int* priority, bool multiple_consumers)
+{
+    int selected;
+
+    for (;;)
+    {
+        const long long occupancy = sync_atomic_load(fifo->m_occupancy);
+
+        /* is empty ? */
+        if (0LL == occupancy)
+        {
+            return false;
+        }
+
+        selected = ring_buffer_priority_select(fifo, occupancy);
+        struct ring_buffer_mpmc* ring = &(fifo->m_classes[selected]);
+
+        if (multiple_consumers ? ring_buffer_pop_mc(ring, elem) : ring_buffer_pop_sc(ring, elem))
+        {
+            break;
+        }
+
+        /* found empty, clear its bit then check again: a producer pushing meanwhile either
+           sets the bit after this clear or its element is seen by this second pop */
+        (void)sync_atomic_and_64(fifo->m_occupancy, ~(1LL << selected));
+
+        if (multiple_consumers ? ring_buffer_pop_mc(ring, elem) : ring_buffer_pop_sc(ring, elem))
+        {
+            (void)sync_atomic_or_64(fifo->m_occupancy, 1LL << selected);
+            break;
+        }
+    }
+
+    if (priority)
+    {
+        *priority = selected;
+    }
+
+    return true;
+}
+
+static bool ring_buffer_priority_push(struct ring_buffer_priority* fifo, int priority, void* elem, bool multiple_producers)
+{
+    if (!fifo || !elem || (priority < 0) || (priority >= fifo->m_nb_classes))
+    {
+        return false;
+    }
+
+    struct ring_buffer_mpmc* ring = &(fifo->m_classes[priority]);
+
+    if (!(multiple_producers ? ring_buffer_push_mp(ring, elem) : ring_buffer_push_sp(ring, elem)))
+    {
+        return false;
+    }
+
+    /* the element must be visible before the occupancy is read (store-load order), otherwise a consumer
+       clearing the bit meanwhile could miss both, see ring_buffer_priority_pop */
+    sync_fence_seq_cst();
+    if (0LL == (sync_atomic_load(fifo->m_occupancy) & (1LL << priority)))
+    {
+        (void)sync_atomic_or_64(fifo->m_occupancy, 1LL << priority);
+    }
+
+    return true;
+}
+
+int init_ring_buffer_priority(struct ring_buffer_priority* fifo, int nb_classes)
+{
+    return init_ring_buffer_priority_ex(fifo, nb_classes, RING_BUFFER_SIZE, RING_BUFFER_PRIORITY_STRICT, NULL);
+}
+
+int init_ring_buffer_priority_ex(struct ring_buffer_priority* fifo, int nb_classes, unsigned long long capacity,
+    enum ring_buffer_priority_policy policy, const unsigned int* weights)
+{
+    if (!fifo || (nb_classes <= 0) || (nb_classes > RING_BUFFER_PRIORITY_MAX_CLASSES))
+    {
+        return -1;
+    }
+
+    fifo->m_nb_classes = nb_classes;
+    fifo->m_policy = policy;
+    fifo->m_schedule_size = 0;
+
+    if (RING_BUFFER_PRIORITY_WEIGHTED == policy)
+    {
+        int total = 0;
+
+        if (!weights)
+        {
+            return -1;
+        }
+
+        for (int i = 0; i < nb_classes; ++i)
+        {
+            if ((0U == weights[i]) || (weights[i] > RING_BUFFER_PRIORITY_MAX_SCHEDULE))
+            {
+                return -1;
+            }
+            total += (int)weights[i];
+        }
+
+        if (total > RING_BUFFER_PRIORITY_MAX_SCHEDULE)
+        {
+            return -1;
+        }
+
+        ring_buffer_priority_build_schedule(fifo, weights, total);
+    }
+
+    fifo->m_classes = (struct ring_buffer_mpmc*)mem_alloc_aligned(
+        (size_t)nb_classes * sizeof(struct ring_buffer_mpmc), RING_BUFFER_STORAGE_ALIGNMENT);
+
+    if (!fifo->m_classes)
+    {
+        return -1;
+    }
+
+    for (int i = 0; i < nb_classes; ++i)
+    {
+        if (init_ring_buffer_mpmc_ex(&(fifo->m_classes[i]), capacity, NULL) < 0)
+        {
+            while (i-- > 0)
+            {
+                (void)deinit_ring_buffer_mpmc(&(fifo->m_classes[i]));
+            }
+            mem_free_aligned((void*)(fifo->m_classes));
+            fifo->m_classes = NULL;
+            return -1;
+        }
+    }
+
+    sync_atomic_store(fifo->m_occupancy, 0LL);
+    sync_atomic_store(fifo->m_ticket, 0LL);
+    sync_write_release();
+
+    return 0;
+}
+
+int deinit_ring_buffer_priority(struct ring_buffer_priority* fifo)
+{
+    if (!fifo)
+    {
+        return -1;
+    }
+
+    for (int i = 0; i < fifo->m_nb_classes; ++i)
+    {
+        (void)deinit_ring_buffer_mpmc(&(fifo->m_classes[i]));
+    }
+
+    mem_free_aligned((void*)(fifo->m_classes));
+    fifo->m_classes = NULL;
+    fifo->m_nb_classes = 0;
+
+    return 0;
+}
+
+bool ring_buffer_priority_push_sp(struct ring_buffer_priority* fifo, int priority, void* elem)
+{
+    return ring_buffer_priority_push(fifo, priority, elem, false);
+}
+
+bool ring_buffer_priority_push_mp(struct ring_buffer_priority* fifo, int priority, void* elem)
+{
+    return ring_buffer_priority_push(fifo, priority, elem, true);
+}
+
+bool ring_buffer_priority_pop_sc(struct ring_buffer_priority* fifo, void** elem, int* priority)
+{
+    if (!fifo || !elem)
+    {
+        return false;
+    }
+
+    return ring_buffer_priority_pop(fifo, elem, priority, false);
+}
+
+bool ring_buffer_priority_pop_mc(struct ring_buffer_priority* fifo, void** elem, int* priority)
+{
+    if (!fifo || !elem)
+    {
+        return false;
+    }
+
+    return ring_buffer_priority_pop(fifo, elem, priority, true);
+}
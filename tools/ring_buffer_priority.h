@@ -0,0 +1,99 @@
+//-----------------------------------------------------------------------------//
+// CRingBuffer MPMC - FIFO helper                                              //
+// (c) 2023 Laurent Lardinois https://be.linkedin.com/in/laurentlardinois      //
+//                                                                             //
+// https://github.com/type-one/CRingBuffer_MPSC                                //
+//                                                                             //
+// This software is provided 'as-is', without any express or implied           //
+// warranty.In no event will the authors be held liable for any damages        //
+// arising from the use of this software.                                      //
+//                                                                             //
+// Permission is granted to anyone to use this software for any purpose,       //
+// including commercial applications, and to alter itand redistribute it       //
+// freely, subject to the following restrictions :                             //
+//                                                                             //
+// 1. The origin of this software must not be misrepresented; you must not     //
+// claim that you wrote the original software.If you use this software         //
+// in a product, an acknowledgment in the product documentation would be       //
+// appreciated but is not required.                                            //
+// 2. Altered source versions must be plainly marked as such, and must not be  //
+// misrepresented as being the original software.                              //
+// 3. This notice may not be removed or altered from any source distribution.  //
+//-----------------------------------------------------------------------------//
+
+#pragma once
+
+#if !defined(__RING_BUFFER_PRIORITY_H__)
+#define __RING_BUFFER_PRIORITY_H__
+
+#include "atomic_helper.h"
+#include "ring_buffer_mpmc.h"
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#if defined(RING_BUFFER_PRIORITY_IMPLEM)
+#define EXTERN_RING_BUFFER_PRIORITY
+#else
+#define EXTERN_RING_BUFFER_PRIORITY extern
+#endif
+
+#if defined(__cplusplus)
+extern "C"
+{
+#endif
+
+    /* multi-priority queue: one ring_buffer_mpmc per priority class (0 is the highest priority) and a
+       shared occupancy bitmap with a bit per class that may hold elements, so that a consumer finds
+       work without polling every ring; classes are picked either strictly by priority or by weighted
+       round-robin (a class with weight 3 is served three times as often as a class with weight 1,
+       the highest non-empty class is used when the scheduled one is empty) */
+
+#define RING_BUFFER_PRIORITY_MAX_CLASSES 32
+#define RING_BUFFER_PRIORITY_MAX_SCHEDULE 256 /* maximum sum of the weights */
+
+    enum ring_buffer_priority_policy
+    {
+        RING_BUFFER_PRIORITY_STRICT,
+        RING_BUFFER_PRIORITY_WEIGHTED
+    };
+
+    struct ring_buffer_priority
+    {
+        /* read-only after init */
+        struct ring_buffer_mpmc* m_classes; /* cache line aligned array */
+        int m_nb_classes;
+        enum ring_buffer_priority_policy m_policy;
+        int m_schedule_size;
+        unsigned char m_schedule[RING_BUFFER_PRIORITY_MAX_SCHEDULE]; /* interleaved class sequence (weighted) */
+
+        /* bit i set: class i may hold elements (set after a push, cleared by a consumer finding it empty) */
+        RING_BUFFER_ALIGNED _atomic_llong m_occupancy;
+
+        /* position in m_schedule (weighted) */
+        RING_BUFFER_ALIGNED _atomic_llong m_ticket;
+    };
+
+    /* strict priority, nb_classes rings of RING_BUFFER_SIZE entries */
+    EXTERN_RING_BUFFER_PRIORITY int init_ring_buffer_priority(struct ring_buffer_priority* fifo, int nb_classes);
+
+    /* capacity (per class) must be a power of two, weights (one per class, at least 1, sum up to
+       RING_BUFFER_PRIORITY_MAX_SCHEDULE) are required by RING_BUFFER_PRIORITY_WEIGHTED only */
+    EXTERN_RING_BUFFER_PRIORITY int init_ring_buffer_priority_ex(struct ring_buffer_priority* fifo, int nb_classes,
+        unsigned long long capacity, enum ring_buffer_priority_policy policy, const unsigned int* weights);
+    EXTERN_RING_BUFFER_PRIORITY int deinit_ring_buffer_priority(struct ring_buffer_priority* fifo);
+
+    /* false if the ring of this class is full */
+    EXTERN_RING_BUFFER_PRIORITY bool ring_buffer_priority_push_sp(struct ring_buffer_priority* fifo, int priority, void* elem);
+    EXTERN_RING_BUFFER_PRIORITY bool ring_buffer_priority_push_mp(struct ring_buffer_priority* fifo, int priority, void* elem);
+
+    /* false if every class is empty, priority (can be NULL) receives the class of the element */
+    EXTERN_RING_BUFFER_PRIORITY bool ring_buffer_priority_pop_sc(struct ring_buffer_priority* fifo, void** elem, int* priority);
+    EXTERN_RING_BUFFER_PRIORITY bool ring_buffer_priority_pop_mc(struct ring_buffer_priority* fifo, void** elem, int* priority);
+
+#if defined(__cplusplus)
+};
+#endif
+
+#endif /*  __RING_BUFFER_PRIORITY_H__ */
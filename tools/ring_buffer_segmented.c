@@ -0,0 +1,364 @@
+//-----------------------------------------------------------------------------//
+// CRingBuffer MPMC - FIFO helper                                              //
+// (c) 2023 Laurent Lardinois https://be.linkedin.com/in/laurentlardinois      //
+//                                                                             //
+// https://github.com/type-one/CRingBuffer_MPSC                                //
+//                                                                             //
+// This software is provided 'as-is', without any express or implied           //
+// warranty.In no event will the authors be held liable for any damages        //
+// arising from the use of this software.                                      //
+//                                                                             //
+// Permission is granted to anyone to use this software for any purpose,       //
+// including commercial applications, and to alter itand redistribute it       //
+// freely, subject to the following restrictions :                             //
+//                                                                             //
+// 1. The origin of this software must not be misrepresented; you must not     //
+// claim that you wrote the original software.If you use this software         //
+// in a product, an acknowledgment in the product documentation would be       //
+// appreciated but is not required.                                            //
+// 2. Altered source versions must be plainly marked as such, and must not be  //
+// misrepresented as being the original software.                              //
+// 3. This notice may not be removed or altered from any source distribution.  //
+//-----------------------------------------------------------------------------//
+
+#include "atomic_helper.h"
+#define RING_BUFFER_SEGMENTED_IMPLEM
+#include "ring_buffer_segmented.h"
+#include "mem_alloc.h"
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#if defined(_WIN32)
+#include <windows.h>
+#elif defined(__STDC_NO_THREADS__)
+#include <pthread.h>
+#else
+#include <threads.h>
+#endif
+
+#if defined(_WIN32)
+typedef CRITICAL_SECTION ring_buffer_segmented_mutex;
+#elif defined(__STDC_NO_THREADS__)
+typedef pthread_mutex_t ring_buffer_segmented_mutex;
+#else
+typedef mtx_t ring_buffer_segmented_mutex;
+#endif
+
+
+static bool ring_buffer_segmented_mutex_init(ring_buffer_segmented_mutex* mutex)
+{
+#if defined(_WIN32)
+    InitializeCriticalSection(mutex);
+    return true;
+#elif defined(__STDC_NO_THREADS__)
+    return (0 == pthread_mutex_init(mutex, NULL));
+#else
+    return (thrd_success == mtx_init(mutex, mtx_plain));
+#endif
+}
+
+static void ring_buffer_segmented_mutex_destroy(ring_buffer_segmented_mutex* mutex)
+{
+#if defined(_WIN32)
+    DeleteCriticalSection(mutex);
+#elif defined(__STDC_NO_THREADS__)
+    pthread_mutex_destroy(mutex);
+#else
+    mtx_destroy(mutex);
+#endif
+}
+
+static void ring_buffer_segmented_lock(ring_buffer_segmented_mutex* mutex)
+{
+#if defined(_WIN32)
+    EnterCriticalSection(mutex);
+#elif defined(__STDC_NO_THREADS__)
+    pthread_mutex_lock(mutex);
+#else
+    mtx_lock(mutex);
+#endif
+}
+
+static void ring_buffer_segmented_unlock(ring_buffer_segmented_mutex* mutex)
+{
+#if defined(_WIN32)
+    LeaveCriticalSection(mutex);
+#elif defined(__STDC_NO_THREADS__)
+    pthread_mutex_unlock(mutex);
+#else
+    mtx_unlock(mutex);
+#endif
+}
+
+/* the slots follow the segment header, which is a multiple of its alignment */
+static void** ring_buffer_segment_slots(struct ring_buffer_segment* segment)
+{
+    return (void**)(segment + 1);
+}
+
+/* recycled segment if any, a new one otherwise, ready to be linked as the tail */
+static struct ring_buffer_segment* ring_buffer_segmented_acquire(struct ring_buffer_segmented* fifo)
+{
+    struct ring_buffer_segment* segment;
+
+    ring_buffer_segmented_lock(&(fifo->m_spare_mutex));
+    segment = fifo->m_spare;
+    if (segment)
+    {
+        fifo->m_spare = (struct ring_buffer_segment*)sync_atomic_load_relaxed(segment->m_next);
+        --fifo->m_nb_spare;
+    }
+    ring_buffer_segmented_unlock(&(fifo->m_spare_mutex));
+
+    if (!segment)
+    {
+        segment = (struct ring_buffer_segment*)mem_alloc_aligned(
+            sizeof(struct ring_buffer_segment) + (size_t)fifo->m_segment_size * sizeof(void*), RING_BUFFER_STORAGE_ALIGNMENT);
+
+        if (!segment)
+        {
+            return NULL;
+        }
+
+        sync_atomic_inc_64(fifo->m_nb_allocs);
+    }
+
+    sync_atomic_store_relaxed(segment->m_write_idx, 0LL);
+    sync_atomic_store_relaxed(segment->m_next, (uintptr_t)NULL);
+    segment->m_read_idx = 0LL;
+
+    return segment;
+}
+
+/* drained segment given back by a consumer, the producers no longer reference it */
+static void ring_buffer_segmented_recycle(struct ring_buffer_segmented* fifo, struct ring_buffer_segment* segment)
+{
+    bool keep;
+
+    ring_buffer_segmented_lock(&(fifo->m_spare_mutex));
+    keep = (fifo->m_nb_spare < fifo->m_max_spare);
+    if (keep)
+    {
+        sync_atomic_store_relaxed(segment->m_next, (uintptr_t)(fifo->m_spare));
+        fifo->m_spare = segment;
+        ++fifo->m_nb_spare;
+    }
+    ring_buffer_segmented_unlock(&(fifo->m_spare_mutex));
+
+    if (!keep)
+    {
+        mem_free_aligned((void*)segment);
+    }
+}
+
+static void ring_buffer_segmented_free_chain(struct ring_buffer_segment* segment)
+{
+    while (segment)
+    {
+        struct ring_buffer_segment* next = (struct ring_buffer_segment*)sync_atomic_load_relaxed(segment->m_next);
+        mem_free_aligned((void*)segment);
+        segment = next;
+    }
+}
+
+int init_ring_buffer_segmented(struct ring_buffer_segmented* fifo)
+{
+    return init_ring_buffer_segmented_ex(fifo, RING_BUFFER_SIZE, RING_BUFFER_SEGMENTED_MAX_SPARE);
+}
+
+int init_ring_buffer_segmented_ex(struct ring_buffer_segmented* fifo, unsigned long long segment_size, size_t max_spare)
+{
+    if (!fifo || (0ULL == segment_size) || (segment_size > (unsigned long long)(SIZE_MAX / sizeof(void*))))
+    {
+        return -1;
+    }
+
+    fifo->m_segment_size = (long long)segment_size;
+    fifo->m_max_spare = max_spare;
+    fifo->m_spare = NULL;
+    fifo->m_nb_spare = 0U;
+    sync_atomic_store(fifo->m_nb_allocs, 0LL);
+
+    if (!ring_buffer_segmented_mutex_init(&(fifo->m_spare_mutex)))
+    {
+        return -1;
+    }
+
+    if (!ring_buffer_segmented_mutex_init(&(fifo->m_read_mutex)))
+    {
+        goto destroy_spare_mutex;
+    }
+
+    if (!ring_buffer_segmented_mutex_init(&(fifo->m_write_mutex)))
+    {
+        goto destroy_read_mutex;
+    }
+
+    fifo->m_tail = ring_buffer_segmented_acquire(fifo);
+    if (!fifo->m_tail)
+    {
+        goto destroy_write_mutex;
+    }
+
+    fifo->m_head = fifo->m_tail;
+    sync_write_release();
+
+    return 0;
+
+destroy_write_mutex:
+    ring_buffer_segmented_mutex_destroy(&(fifo->m_write_mutex));
+destroy_read_mutex:
+    ring_buffer_segmented_mutex_destroy(&(fifo->m_read_mutex));
+destroy_spare_mutex:
+    ring_buffer_segmented_mutex_destroy(&(fifo->m_spare_mutex));
+
+    return -1;
+}
+
+int deinit_ring_buffer_segmented(struct ring_buffer_segmented* fifo)
+{
+    if (!fifo)
+    {
+        return -1;
+    }
+
+    /* pending elements are dropped, the chain runs from the head to the tail */
+    ring_buffer_segmented_free_chain(fifo->m_head);
+    ring_buffer_segmented_free_chain(fifo->m_spare);
+    fifo->m_head = NULL;
+    fifo->m_tail = NULL;
+    fifo->m_spare = NULL;
+    fifo->m_nb_spare = 0U;
+
+    ring_buffer_segmented_mutex_destroy(&(fifo->m_write_mutex));
+    ring_buffer_segmented_mutex_destroy(&(fifo->m_read_mutex));
+    ring_buffer_segmented_mutex_destroy(&(fifo->m_spare_mutex));
+
+    return 0;
+}
+
+static bool ring_buffer_segmented_do_push(struct ring_buffer_segmented* fifo, void* elem)
+{
+    struct ring_buffer_segment* tail = fifo->m_tail;
+    long long write_idx = sync_atomic_load_relaxed(tail->m_write_idx);
+
+    if (write_idx == fifo->m_segment_size)
+    {
+        /* tail segment full, link a new one (the consumers move on once they see m_next) */
+        struct ring_buffer_segment* next = ring_buffer_segmented_acquire(fifo);
+        if (!next)
+        {
+            return false;
+        }
+
+        sync_atomic_store_release(tail->m_next, (uintptr_t)next);
+        fifo->m_tail = next;
+        tail = next;
+        write_idx = 0LL;
+    }
+
+    ring_buffer_segment_slots(tail)[write_idx] = elem;
+
+    /* publish to the consumers */
+    sync_atomic_store_release(tail->m_write_idx, write_idx + 1);
+
+    return true;
+}
+
+bool ring_buffer_segmented_push_sp(struct ring_buffer_segmented* fifo, void* elem)
+{
+    if (!fifo || !elem)
+    {
+        return false;
+    }
+
+    return ring_buffer_segmented_do_push(fifo, elem);
+}
+
+bool ring_buffer_segmented_push_mp(struct ring_buffer_segmented* fifo, void* elem)
+{
+    bool ret;
+
+    if (!fifo || !elem)
+    {
+        return false;
+    }
+
+    ring_buffer_segmented_lock(&(fifo->m_write_mutex));
+    ret = ring_buffer_segmented_do_push(fifo, elem);
+    ring_buffer_segmented_unlock(&(fifo->m_write_mutex));
+
+    return ret;
+}
+
+static bool ring_buffer_segmented_do_pop(struct ring_buffer_segmented* fifo, void** elem)
+{
+    struct ring_buffer_segment* head = fifo->m_head;
+
+    for (;;)
+    {
+        const long long read_idx = head->m_read_idx;
+
+        if (read_idx < fifo->m_segment_size)
+        {
+            /* is empty ? */
+            if (read_idx >= sync_atomic_load_acquire(head->m_write_idx))
+            {
+                return false;
+            }
+
+            *elem = ring_buffer_segment_slots(head)[read_idx];
+            head->m_read_idx = read_idx + 1;
+
+            return true;
+        }
+
+        /* head segment drained, the producers stopped using it once they linked the next one */
+        struct ring_buffer_segment* next = (struct ring_buffer_segment*)sync_atomic_load_acquire(head->m_next);
+        if (!next)
+        {
+            return false;
+        }
+
+        fifo->m_head = next;
+        ring_buffer_segmented_recycle(fifo, head);
+        head = next;
+    }
+}
+
+bool ring_buffer_segmented_pop_sc(struct ring_buffer_segmented* fifo, void** elem)
+{
+    if (!fifo || !elem)
+    {
+        return false;
+    }
+
+    return ring_buffer_segmented_do_pop(fifo, elem);
+}
+
+bool ring_buffer_segmented_pop_mc(struct ring_buffer_segmented* fifo, void** elem)
+{
+    bool ret;
+
+    if (!fifo || !elem)
+    {
+        return false;
+    }
+
+    ring_buffer_segmented_lock(&(fifo->m_read_mutex));
+    ret = ring_buffer_segmented_do_pop(fifo, elem);
+    ring_buffer_segmented_unlock(&(fifo->m_read_mutex));
+
+    return ret;
+}
+
+unsigned long long ring_buffer_segmented_allocations(struct ring_buffer_segmented* fifo)
+{
+    if (!fifo)
+    {
+        return 0ULL;
+    }
+
+    return (unsigned long long)sync_atomic_load(fifo->m_nb_allocs);
+}
@@ -0,0 +1,135 @@
+//-----------------------------------------------------------------------------//
+// CRingBuffer MPMC - FIFO helper                                              //
+// (c) 2023 Laurent Lardinois https://be.linkedin.com/in/laurentlardinois      //
+//                                                                             //
+// https://github.com/type-one/CRingBuffer_MPSC                                //
+//                                                                             //
+// This software is provided 'as-is', without any express or implied           //
+// warranty.In no event will the authors be held liable for any damages        //
+// arising from the use of this software.                                      //
+//                                                                             //
+// Permission is granted to anyone to use this software for any purpose,       //
+// including commercial applications, and to alter itand redistribute it       //
+// freely, subject to the following restrictions :                             //
+//                                                                             //
+// 1. The origin of this software must not be misrepresented; you must not     //
+// claim that you wrote the original software.If you use this software         //
+// in a product, an acknowledgment in the product documentation would be       //
+// appreciated but is not required.                                            //
+// 2. Altered source versions must be plainly marked as such, and must not be  //
+// misrepresented as being the original software.                              //
+// 3. This notice may not be removed or altered from any source distribution.  //
+//-----------------------------------------------------------------------------//
+
+#pragma once
+
+#if !defined(__RING_BUFFER_SEGMENTED_H__)
+#define __RING_BUFFER_SEGMENTED_H__
+
+#include "atomic_helper.h"
+#include "ring_buffer_mpmc.h"
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#if defined(_WIN32)
+#include <windows.h>
+#elif defined(__STDC_NO_THREADS__)
+#include <pthread.h>
+#else
+#include <threads.h>
+#endif
+
+#if defined(RING_BUFFER_SEGMENTED_IMPLEM)
+#define EXTERN_RING_BUFFER_SEGMENTED
+#else
+#define EXTERN_RING_BUFFER_SEGMENTED extern
+#endif
+
+#if defined(__cplusplus)
+extern "C"
+{
+#endif
+
+    /* unbounded FIFO made of a chain of fixed-size segments: producers append to the tail segment and
+       link a new one when it is full, consumers drain the head segment and hand it back to a free list
+       once the next one is linked, so a push only fails if a segment cannot be allocated and the steady
+       state runs on recycled segments (the queue grows during bursts, the spare segments above
+       m_max_spare are released) */
+
+#define RING_BUFFER_SEGMENTED_MAX_SPARE 16U /* default number of drained segments kept for reuse */
+
+    struct ring_buffer_segment
+    {
+        /* producer side */
+        RING_BUFFER_ALIGNED _atomic_llong m_write_idx; /* entries published in this segment */
+        _atomic_uintptr m_next;                        /* set once this segment is full */
+
+        /* consumer side */
+        RING_BUFFER_ALIGNED long long m_read_idx;
+
+        /* the segment size entries follow */
+    };
+
+    struct ring_buffer_segmented
+    {
+        /* read-only after init */
+        long long m_segment_size; /* entries per segment */
+        size_t m_max_spare;
+
+        /* producer side */
+        RING_BUFFER_ALIGNED struct ring_buffer_segment* m_tail;
+#if defined(_WIN32)
+        CRITICAL_SECTION m_write_mutex;
+#elif defined(__STDC_NO_THREADS__)
+    pthread_mutex_t m_write_mutex;
+#else
+    mtx_t m_write_mutex;
+#endif
+
+        /* consumer side */
+        RING_BUFFER_ALIGNED struct ring_buffer_segment* m_head;
+#if defined(_WIN32)
+        CRITICAL_SECTION m_read_mutex;
+#elif defined(__STDC_NO_THREADS__)
+    pthread_mutex_t m_read_mutex;
+#else
+    mtx_t m_read_mutex;
+#endif
+
+        /* drained segments, taken once per segment by producers and given back by consumers */
+        RING_BUFFER_ALIGNED struct ring_buffer_segment* m_spare;
+        size_t m_nb_spare;
+        _atomic_llong m_nb_allocs; /* segments allocated since init */
+#if defined(_WIN32)
+        CRITICAL_SECTION m_spare_mutex;
+#elif defined(__STDC_NO_THREADS__)
+    pthread_mutex_t m_spare_mutex;
+#else
+    mtx_t m_spare_mutex;
+#endif
+    };
+
+    /* segments of RING_BUFFER_SIZE entries, up to RING_BUFFER_SEGMENTED_MAX_SPARE spare segments */
+    EXTERN_RING_BUFFER_SEGMENTED int init_ring_buffer_segmented(struct ring_buffer_segmented* fifo);
+
+    /* segment_size entries per segment (any size from 1), max_spare drained segments kept for reuse,
+       the first segment is allocated by init */
+    EXTERN_RING_BUFFER_SEGMENTED int init_ring_buffer_segmented_ex(struct ring_buffer_segmented* fifo, unsigned long long segment_size, size_t max_spare);
+    EXTERN_RING_BUFFER_SEGMENTED int deinit_ring_buffer_segmented(struct ring_buffer_segmented* fifo);
+
+    /* push returns false only if a new segment is needed and cannot be allocated */
+    EXTERN_RING_BUFFER_SEGMENTED bool ring_buffer_segmented_push_sp(struct ring_buffer_segmented* fifo, void* elem);
+    EXTERN_RING_BUFFER_SEGMENTED bool ring_buffer_segmented_push_mp(struct ring_buffer_segmented* fifo, void* elem);
+    EXTERN_RING_BUFFER_SEGMENTED bool ring_buffer_segmented_pop_sc(struct ring_buffer_segmented* fifo, void** elem);
+    EXTERN_RING_BUFFER_SEGMENTED bool ring_buffer_segmented_pop_mc(struct ring_buffer_segmented* fifo, void** elem);
+
+    /* number of segments allocated since init, stops growing once the free list covers the bursts */
+    EXTERN_RING_BUFFER_SEGMENTED unsigned long long ring_buffer_segmented_allocations(struct ring_buffer_segmented* fifo);
+
+#if defined(__cplusplus)
+};
+#endif
+
+#endif /*  __RING_BUFFER_SEGMENTED_H__ */
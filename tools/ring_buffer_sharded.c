@@ -0,0 +1,162 @@
+//-----------------------------------------------------------------------------//
+// CRingBuffer MPMC - FIFO helper                                              //
+// (c) 2023 Laurent Lardinois https://be.linkedin.com/in/laurentlardinois      //
+//                                                                             //
+// https://github.com/type-one/CRingBuffer_MPSC                                //
+//                                                                             //
+// This software is provided 'as-is', without any express or implied           //
+// warranty.In no event will the authors be held liable for any damages        //
+// arising from the use of this software.                                      //
+//                                                                             //
+// Permission is granted to anyone to use this software for any purpose,       //
+// including commercial applications, and to alter itand redistribute it       //
+// freely, subject to the following restrictions :                             //
+//                                                                             //
+// 1. The origin of this software must not be misrepresented; you must not     //
+// claim that you wrote the original software.If you use this software         //
+// in a product, an acknowledgment in the product documentation would be       //
+// appreciated but is not required.                                            //
+// 2. Altered source versions must be plainly marked as such, and must not be  //
+// misrepresented as being the original software.                              //
+// 3. This notice may not be removed or altered from any source distribution.  //
+//-----------------------------------------------------------------------------//
+
+#include "atomic_helper.h"
+#define RING_BUFFER_SHARDED_IMPLEM
+#include "ring_buffer_sharded.h"
+#include "mem_alloc.h"
+#include "ring_buffer_mpmc_lf.h"
+
+#include <stdbool.h>
+#include <stdint.h>
+
+static _atomic_int st_next_home_lane;
+static THREAD_LOCAL int st_home_lane = -1;
+
+
+/* threads are assigned a lane round robin on first use */
+static int ring_buffer_sharded_home_lane(struct ring_buffer_sharded* fifo)
+{
+    if (st_home_lane < 0)
+    {
+        st_home_lane = (int)((unsigned int)sync_atomic_inc_32(st_next_home_lane) % RING_BUFFER_SHARDED_MAX_LANES);
+    }
+
+    return st_home_lane % fifo->m_nb_lanes;
+}
+
+int init_ring_buffer_sharded(struct ring_buffer_sharded* fifo, int nb_lanes)
+{
+    return init_ring_buffer_sharded_ex(fifo, nb_lanes, RING_BUFFER_SIZE);
+}
+
+int init_ring_buffer_sharded_ex(struct ring_buffer_sharded* fifo, int nb_lanes, unsigned long long lane_capacity)
+{
+    if (!fifo || (nb_lanes <= 0) || (nb_lanes > RING_BUFFER_SHARDED_MAX_LANES))
+    {
+        return -1;
+    }
+
+    fifo->m_lanes = (struct ring_buffer_mpmc_lf*)mem_alloc_aligned(
+        (size_t)nb_lanes * sizeof(struct ring_buffer_mpmc_lf), RING_BUFFER_STORAGE_ALIGNMENT);
+
+    if (!fifo->m_lanes)
+    {
+        return -1;
+    }
+
+    for (int lane = 0; lane < nb_lanes; ++lane)
+    {
+        if (init_ring_buffer_mpmc_lf_ex(&(fifo->m_lanes[lane]), lane_capacity, NULL) < 0)
+        {
+            while (lane-- > 0)
+            {
+                (void)deinit_ring_buffer_mpmc_lf(&(fifo->m_lanes[lane]));
+            }
+            mem_free_aligned((void*)(fifo->m_lanes));
+            fifo->m_lanes = NULL;
+            return -1;
+        }
+    }
+
+    fifo->m_nb_lanes = nb_lanes;
+
+    return 0;
+}
+
+int deinit_ring_buffer_sharded(struct ring_buffer_sharded* fifo)
+{
+    if (!fifo)
+    {
+        return -1;
+    }
+
+    for (int lane = 0; lane < fifo->m_nb_lanes; ++lane)
+    {
+        (void)deinit_ring_buffer_mpmc_lf(&(fifo->m_lanes[lane]));
+    }
+
+    mem_free_aligned((void*)(fifo->m_lanes));
+    fifo->m_lanes = NULL;
+    fifo->m_nb_lanes = 0;
+
+    return 0;
+}
+
+bool ring_buffer_sharded_push_lane(struct ring_buffer_sharded* fifo, int lane, void* elem)
+{
+    if (!fifo || !elem || (lane < 0))
+    {
+        return false;
+    }
+
+    /* home lane first, spill to the next lanes when it is full */
+    for (int i = 0; i < fifo->m_nb_lanes; ++i)
+    {
+        if (ring_buffer_lf_push(&(fifo->m_lanes[(lane + i) % fifo->m_nb_lanes]), elem))
+        {
+            return true;
+        }
+    }
+
+    return false;
+}
+
+bool ring_buffer_sharded_pop_lane(struct ring_buffer_sharded* fifo, int lane, void** elem)
+{
+    if (!fifo || !elem || (lane < 0))
+    {
+        return false;
+    }
+
+    /* home lane first, then steal from the other lanes */
+    for (int i = 0; i < fifo->m_nb_lanes; ++i)
+    {
+        if (ring_buffer_lf_pop(&(fifo->m_lanes[(lane + i) % fifo->m_nb_lanes]), elem))
+        {
+            return true;
+        }
+    }
+
+    return false;
+}
+
+bool ring_buffer_sharded_push(struct ring_buffer_sharded* fifo, void* elem)
+{
+    if (!fifo)
+    {
+        return false;
+    }
+
+    return ring_buffer_sharded_push_lane(fifo, ring_buffer_sharded_home_lane(fifo), elem);
+}
+
+bool ring_buffer_sharded_pop(struct ring_buffer_sharded* fifo, void** elem)
+{
+    if (!fifo)
+    {
+        return false;
+    }
+
+    return ring_buffer_sharded_pop_lane(fifo, ring_buffer_sharded_home_lane(fifo), elem);
+}
@@ -0,0 +1,84 @@
+//-----------------------------------------------------------------------------//
+// CRingBuffer MPMC - FIFO helper                                              //
+// (c) 2023 Laurent Lardinois https://be.linkedin.com/in/laurentlardinois      //
+//                                                                             //
+// https://github.com/type-one/CRingBuffer_MPSC                                //
+//                                                                             //
+// This software is provided 'as-is', without any express or implied           //
+// warranty.In no event will the authors be held liable for any damages        //
+// arising from the use of this software.                                      //
+//                                                                             //
+// Permission is granted to anyone to use this software for any purpose,       //
+// including commercial applications, and to alter itand redistribute it       //
+// freely, subject to the following restrictions :                             //
+//                                                                             //
+// 1. The origin of this software must not be misrepresented; you must not     //
+// claim that you wrote the original software.If you use this software         //
+// in a product, an acknowledgment in the product documentation would be       //
+// appreciated but is not required.                                            //
+// 2. Altered source versions must be plainly marked as such, and must not be  //
+// misrepresented as being the original software.                              //
+// 3. This notice may not be removed or altered from any source distribution.  //
+//-----------------------------------------------------------------------------//
+
+#pragma once
+
+#if !defined(__RING_BUFFER_SHARDED_H__)
+#define __RING_BUFFER_SHARDED_H__
+
+#include "atomic_helper.h"
+#include "ring_buffer_mpmc.h"
+#include "ring_buffer_mpmc_lf.h"
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#if defined(RING_BUFFER_SHARDED_IMPLEM)
+#define EXTERN_RING_BUFFER_SHARDED
+#else
+#define EXTERN_RING_BUFFER_SHARDED extern
+#endif
+
+#if defined(__cplusplus)
+extern "C"
+{
+#endif
+
+    /* sharded MPMC queue made of several lock-free lanes (ring_buffer_mpmc_lf): each thread has a home
+       lane, producers push to their home lane (spilling to the next lanes when it is full), consumers
+       pop from their home lane first then scan the other lanes, so the threads mostly update different
+       indexes; the order is FIFO per lane only, not across lanes */
+
+#define RING_BUFFER_SHARDED_MAX_LANES 64
+
+    struct ring_buffer_sharded
+    {
+        /* read-only after init */
+        struct ring_buffer_mpmc_lf* m_lanes; /* cache line aligned array */
+        int m_nb_lanes;
+    };
+
+    /* nb_lanes lanes of RING_BUFFER_SIZE entries */
+    EXTERN_RING_BUFFER_SHARDED int init_ring_buffer_sharded(struct ring_buffer_sharded* fifo, int nb_lanes);
+
+    /* lane_capacity must be a power of two, total capacity is nb_lanes * lane_capacity */
+    EXTERN_RING_BUFFER_SHARDED int init_ring_buffer_sharded_ex(struct ring_buffer_sharded* fifo, int nb_lanes, unsigned long long lane_capacity);
+    EXTERN_RING_BUFFER_SHARDED int deinit_ring_buffer_sharded(struct ring_buffer_sharded* fifo);
+
+    /* home lane of the calling thread (threads are assigned lanes round robin on first use),
+       false only if every lane is full */
+    EXTERN_RING_BUFFER_SHARDED bool ring_buffer_sharded_push(struct ring_buffer_sharded* fifo, void* elem);
+
+    /* home lane of the calling thread first, then the other lanes, false if every lane looks empty */
+    EXTERN_RING_BUFFER_SHARDED bool ring_buffer_sharded_pop(struct ring_buffer_sharded* fifo, void** elem);
+
+    /* explicit lane (for instance one lane per producer), lane is taken modulo the number of lanes */
+    EXTERN_RING_BUFFER_SHARDED bool ring_buffer_sharded_push_lane(struct ring_buffer_sharded* fifo, int lane, void* elem);
+    EXTERN_RING_BUFFER_SHARDED bool ring_buffer_sharded_pop_lane(struct ring_buffer_sharded* fifo, int lane, void** elem);
+
+#if defined(__cplusplus)
+};
+#endif
+
+#endif /*  __RING_BUFFER_SHARDED_H__ */
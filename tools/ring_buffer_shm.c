@@ -0,0 +1,510 @@
+//-----------------------------------------------------------------------------//
+// CRingBuffer MPMC - FIFO helper                                              //
+// (c) 2023 Laurent Lardinois https://be.linkedin.com/in/laurentlardinois      //
+//                                                                             //
+// https://github.com/type-one/CRingBuffer_MPSC                                //
+//                                                                             //
+// This software is provided 'as-is', without any express or implied           //
+// warranty.In no event will the authors be held liable for any damages        //
+// arising from the use of this software.                                      //
+//                                                                             //
+// Permission is granted to anyone to use this software for any purpose,       //
+// including commercial applications, and to alter itand redistribute it       //
+// freely, subject to the following restrictions :                             //
+//                                                                             //
+// 1. The origin of this software must not be misrepresented; you must not     //
+// claim that you wrote the original software.If you use this software         //
+// in a product, an acknowledgment in the product documentation would be       //
+// appreciated but is not required.                                            //
+// 2. Altered source versions must be plainly marked as such, and must not be  //
+// misrepresented as being the original software.                              //
+// 3. This notice may not be removed or altered from any source distribution.  //
+//-----------------------------------------------------------------------------//
+
+#include "atomic_helper.h"
+#define RING_BUFFER_SHM_IMPLEM
+#include "ring_buffer_shm.h"
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <string.h>
+
+#if defined(_WIN32)
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+
+static size_t ring_buffer_shm_round_up(size_t size)
+{
+    return (size + RING_BUFFER_STORAGE_ALIGNMENT - 1U) & ~((size_t)RING_BUFFER_STORAGE_ALIGNMENT - 1U);
+}
+
+/* a process-shared atomic must not fall back to a process-local lock */
+static bool ring_buffer_shm_lock_free(struct ring_buffer_shm_header* header)
+{
+#if !defined(__STDC_NO_ATOMICS__) && !defined(_WIN32)
+    return atomic_is_lock_free(&(header->m_frames.m_write_idx)) ? true : false;
+#else
+    (void)header;
+    return true;
+#endif
+}
+
+static void ring_buffer_shm_bind(struct ring_buffer_shm* shm, void* region)
+{
+    unsigned char* base = (unsigned char*)region;
+
+    shm->m_header = (struct ring_buffer_shm_header*)region;
+    shm->m_cells = (struct ring_buffer_shm_cell*)(base + shm->m_header->m_cells_offset);
+    shm->m_free_cells = (struct ring_buffer_shm_cell*)(base + shm->m_header->m_free_cells_offset);
+    shm->m_arena = base + shm->m_header->m_arena_offset;
+}
+
+/* same slot claiming scheme as ring_buffer_mpmc_lf, on offsets */
+static bool ring_buffer_shm_enqueue(
+    struct ring_buffer_shm_header* header, struct ring_buffer_shm_queue* queue, struct ring_buffer_shm_cell* cells, long long offset, long long length)
+{
+    struct ring_buffer_shm_cell* cell;
+    long long write_idx = sync_atomic_load_relaxed(queue->m_write_idx);
+
+    for (;;)
+    {
+        cell = &(cells[write_idx & header->m_mask]);
+        const long long sequence = sync_atomic_load_acquire(cell->m_sequence);
+        const long long diff = sequence - write_idx;
+
+        if (0 == diff)
+        {
+            /* slot is free for this lap, try to claim it (write_idx is reloaded on failure) */
+            if (sync_atomic_cas_64_relaxed(queue->m_write_idx, write_idx, write_idx + 1))
+            {
+                break;
+            }
+        }
+        else if (diff < 0)
+        {
+            /* is full ? */
+            return false;
+        }
+        else
+        {
+            /* another producer already claimed this slot */
+            write_idx = sync_atomic_load_relaxed(queue->m_write_idx);
+        }
+    }
+
+    sync_atomic_store_relaxed(cell->m_offset, offset);
+    sync_atomic_store_relaxed(cell->m_length, length);
+
+    /* publish to the consumers */
+    sync_atomic_store_release(cell->m_sequence, write_idx + 1);
+
+    return true;
+}
+
+static bool ring_buffer_shm_dequeue(
+    struct ring_buffer_shm_header* header, struct ring_buffer_shm_queue* queue, struct ring_buffer_shm_cell* cells, long long* offset, long long* length)
+{
+    struct ring_buffer_shm_cell* cell;
+    long long read_idx = sync_atomic_load_relaxed(queue->m_read_idx);
+
+    for (;;)
+    {
+        cell = &(cells[read_idx & header->m_mask]);
+        const long long sequence = sync_atomic_load_acquire(cell->m_sequence);
+        const long long diff = sequence - (read_idx + 1);
+
+        if (0 == diff)
+        {
+            /* slot is published for this lap, try to claim it (read_idx is reloaded on failure) */
+            if (sync_atomic_cas_64_relaxed(queue->m_read_idx, read_idx, read_idx + 1))
+            {
+                break;
+            }
+        }
+        else if (diff < 0)
+        {
+            /* is empty ? */
+            return false;
+        }
+        else
+        {
+            /* another consumer already claimed this slot */
+            read_idx = sync_atomic_load_relaxed(queue->m_read_idx);
+        }
+    }
+
+    *offset = sync_atomic_load_relaxed(cell->m_offset);
+    *length = sync_atomic_load_relaxed(cell->m_length);
+
+    /* release the slot for the producers of the next lap */
+    sync_atomic_store_release(cell->m_sequence, read_idx + header->m_size);
+
+    return true;
+}
+
+size_t ring_buffer_shm_region_size(unsigned long long capacity, size_t block_size)
+{
+    return ring_buffer_shm_round_up(sizeof(struct ring_buffer_shm_header))
+        + 2U * ring_buffer_shm_round_up((size_t)capacity * sizeof(struct ring_buffer_shm_cell))
+        + (size_t)capacity * ring_buffer_shm_round_up(block_size);
+}
+
+int init_ring_buffer_shm(struct ring_buffer_shm* shm, void* region, unsigned long long capacity, size_t block_size)
+{
+    if (!shm || !region || (0U == block_size))
+    {
+        return -1;
+    }
+
+    /* power of two only, mask computed per instance */
+    if ((capacity < 2ULL) || (0ULL != (capacity & (capacity - 1ULL))))
+    {
+        return -1;
+    }
+
+    struct ring_buffer_shm_header* header = (struct ring_buffer_shm_header*)region;
+
+    if (!ring_buffer_shm_lock_free(header))
+    {
+        return -1;
+    }
+
+    const size_t cells_size = ring_buffer_shm_round_up((size_t)capacity * sizeof(struct ring_buffer_shm_cell));
+
+    memset(region, 0, ring_buffer_shm_round_up(sizeof(struct ring_buffer_shm_header)));
+    header->m_version = RING_BUFFER_SHM_VERSION;
+    header->m_header_size = (unsigned int)sizeof(struct ring_buffer_shm_header);
+    header->m_size = (long long)capacity;
+    header->m_mask = (long long)(capacity - 1ULL);
+    header->m_block_size = ring_buffer_shm_round_up(block_size);
+    header->m_region_size = ring_buffer_shm_region_size(capacity, block_size);
+    header->m_cells_offset = ring_buffer_shm_round_up(sizeof(struct ring_buffer_shm_header));
+    header->m_free_cells_offset = header->m_cells_offset + cells_size;
+    header->m_arena_offset = header->m_free_cells_offset + cells_size;
+
+    ring_buffer_shm_bind(shm, region);
+    shm->m_region_size = (size_t)header->m_region_size;
+    shm->m_mapped = false;
+
+    for (long long i = 0; i < header->m_size; ++i)
+    {
+        sync_atomic_store(shm->m_cells[i].m_sequence, i);
+        sync_atomic_store(shm->m_cells[i].m_offset, 0LL);
+        sync_atomic_store(shm->m_cells[i].m_length, 0LL);
+
+        /* every block starts in the free queue */
+        sync_atomic_store(shm->m_free_cells[i].m_sequence, i + 1);
+        sync_atomic_store(shm->m_free_cells[i].m_offset, i * (long long)header->m_block_size);
+        sync_atomic_store(shm->m_free_cells[i].m_length, 0LL);
+    }
+
+    sync_atomic_store(header->m_frames.m_write_idx, 0LL);
+    sync_atomic_store(header->m_frames.m_read_idx, 0LL);
+    sync_atomic_store(header->m_free.m_write_idx, header->m_size);
+    sync_atomic_store(header->m_free.m_read_idx, 0LL);
+
+    /* the region is ready for the other processes */
+    sync_atomic_store_release(header->m_magic, RING_BUFFER_SHM_MAGIC);
+
+    return 0;
+}
+
+int attach_ring_buffer_shm(struct ring_buffer_shm* shm, void* region)
+{
+    if (!shm || !region)
+    {
+        return -1;
+    }
+
+    struct ring_buffer_shm_header* header = (struct ring_buffer_shm_header*)region;
+
+    /* not formatted yet, or another layout */
+    if ((RING_BUFFER_SHM_MAGIC != sync_atomic_load_acquire(header->m_magic)) || (RING_BUFFER_SHM_VERSION != header->m_version)
+        || (sizeof(struct ring_buffer_shm_header) != header->m_header_size) || !ring_buffer_shm_lock_free(header))
+    {
+        return -1;
+    }
+
+    ring_buffer_shm_bind(shm, region);
+    shm->m_region_size = (size_t)header->m_region_size;
+    shm->m_mapped = false;
+
+    return 0;
+}
+
+#if defined(_WIN32)
+
+int init_ring_buffer_shm_named(struct ring_buffer_shm* shm, const char* name, unsigned long long capacity, size_t block_size)
+{
+    if (!shm || !name)
+    {
+        return -1;
+    }
+
+    const unsigned long long size = (unsigned long long)ring_buffer_shm_region_size(capacity, block_size);
+    HANDLE mapping = CreateFileMappingA(INVALID_HANDLE_VALUE, NULL, PAGE_READWRITE, (DWORD)(size >> 32), (DWORD)(size & 0xFFFFFFFFULL), name);
+
+    if (!mapping)
+    {
+        return -1;
+    }
+
+    if (ERROR_ALREADY_EXISTS == GetLastError())
+    {
+        CloseHandle(mapping);
+        return -1;
+    }
+
+    void* region = MapViewOfFile(mapping, FILE_MAP_ALL_ACCESS, 0, 0, 0);
+
+    if (!region || (0 != init_ring_buffer_shm(shm, region, capacity, block_size)))
+    {
+        if (region)
+        {
+            UnmapViewOfFile(region);
+        }
+        CloseHandle(mapping);
+        return -1;
+    }
+
+    shm->m_mapping = mapping;
+    shm->m_mapped = true;
+
+    return 0;
+}
+
+int attach_ring_buffer_shm_named(struct ring_buffer_shm* shm, const char* name)
+{
+    if (!shm || !name)
+    {
+        return -1;
+    }
+
+    HANDLE mapping = OpenFileMappingA(FILE_MAP_ALL_ACCESS, FALSE, name);
+
+    if (!mapping)
+    {
+        return -1;
+    }
+
+    void* region = MapViewOfFile(mapping, FILE_MAP_ALL_ACCESS, 0, 0, 0);
+
+    if (!region || (0 != attach_ring_buffer_shm(shm, region)))
+    {
+        if (region)
+        {
+            UnmapViewOfFile(region);
+        }
+        CloseHandle(mapping);
+        return -1;
+    }
+
+    shm->m_mapping = mapping;
+    shm->m_mapped = true;
+
+    return 0;
+}
+
+int deinit_ring_buffer_shm(struct ring_buffer_shm* shm)
+{
+    if (!shm || !shm->m_header)
+    {
+        return -1;
+    }
+
+    if (shm->m_mapped)
+    {
+        UnmapViewOfFile(shm->m_header);
+        CloseHandle(shm->m_mapping);
+    }
+    shm->m_header = NULL;
+
+    return 0;
+}
+
+int ring_buffer_shm_unlink(const char* name)
+{
+    /* the mapping goes away with its last handle */
+    return name ? 0 : -1;
+}
+
+#else
+
+int init_ring_buffer_shm_named(struct ring_buffer_shm* shm, const char* name, unsigned long long capacity, size_t block_size)
+{
+    if (!shm || !name)
+    {
+        return -1;
+    }
+
+    const size_t size = ring_buffer_shm_region_size(capacity, block_size);
+    const int fd = shm_open(name, O_CREAT | O_EXCL | O_RDWR, 0600);
+
+    if (fd < 0)
+    {
+        return -1;
+    }
+
+    void* region = MAP_FAILED;
+
+    if (0 == ftruncate(fd, (off_t)size))
+    {
+        region = mmap(NULL, size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    }
+
+    /* the mapping keeps the object alive */
+    close(fd);
+
+    if ((MAP_FAILED == region) || (0 != init_ring_buffer_shm(shm, region, capacity, block_size)))
+    {
+        if (MAP_FAILED != region)
+        {
+            munmap(region, size);
+        }
+        shm_unlink(name);
+        return -1;
+    }
+
+    shm->m_mapped = true;
+
+    return 0;
+}
+
+int attach_ring_buffer_shm_named(struct ring_buffer_shm* shm, const char* name)
+{
+    if (!shm || !name)
+    {
+        return -1;
+    }
+
+    const int fd = shm_open(name, O_RDWR, 0600);
+
+    if (fd < 0)
+    {
+        return -1;
+    }
+
+    struct stat st;
+    void* region = MAP_FAILED;
+
+    if ((0 == fstat(fd, &st)) && ((size_t)st.st_size >= sizeof(struct ring_buffer_shm_header)))
+    {
+        region = mmap(NULL, (size_t)st.st_size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    }
+
+    close(fd);
+
+    if (MAP_FAILED == region)
+    {
+        return -1;
+    }
+
+    /* the creator may still be sizing or formatting the region */
+    if ((0 != attach_ring_buffer_shm(shm, region)) || (shm->m_region_size > (size_t)st.st_size))
+    {
+        munmap(region, (size_t)st.st_size);
+        shm->m_header = NULL;
+        return -1;
+    }
+
+    shm->m_mapped = true;
+
+    return 0;
+}
+
+int deinit_ring_buffer_shm(struct ring_buffer_shm* shm)
+{
+    if (!shm || !shm->m_header)
+    {
+        return -1;
+    }
+
+    if (shm->m_mapped)
+    {
+        munmap((void*)(shm->m_header), shm->m_region_size);
+    }
+    shm->m_header = NULL;
+
+    return 0;
+}
+
+int ring_buffer_shm_unlink(const char* name)
+{
+    if (!name)
+    {
+        return -1;
+    }
+
+    return (0 == shm_unlink(name)) ? 0 : -1;
+}
+
+#endif
+
+void* ring_buffer_shm_alloc(struct ring_buffer_shm* shm)
+{
+    long long offset;
+    long long length;
+
+    if (!shm || !ring_buffer_shm_dequeue(shm->m_header, &(shm->m_header->m_free), shm->m_free_cells, &offset, &length))
+    {
+        return NULL;
+    }
+
+    return shm->m_arena + offset;
+}
+
+void ring_buffer_shm_free(struct ring_buffer_shm* shm, void* block)
+{
+    if (!shm || !block)
+    {
+        return;
+    }
+
+    /* never full, there are as many free slots as blocks */
+    (void)ring_buffer_shm_enqueue(shm->m_header, &(shm->m_header->m_free), shm->m_free_cells, ring_buffer_shm_offset(shm, block), 0LL);
+}
+
+bool ring_buffer_shm_push(struct ring_buffer_shm* shm, void* block, size_t length)
+{
+    if (!shm || !block || (length > shm->m_header->m_block_size))
+    {
+        return false;
+    }
+
+    return ring_buffer_shm_enqueue(shm->m_header, &(shm->m_header->m_frames), shm->m_cells, ring_buffer_shm_offset(shm, block), (long long)length);
+}
+
+bool ring_buffer_shm_pop(struct ring_buffer_shm* shm, void** block, size_t* length)
+{
+    long long offset;
+    long long used;
+
+    if (!shm || !block || !ring_buffer_shm_dequeue(shm->m_header, &(shm->m_header->m_frames), shm->m_cells, &offset, &used))
+    {
+        return false;
+    }
+
+    *block = shm->m_arena + offset;
+    if (length)
+    {
+        *length = (size_t)used;
+    }
+
+    return true;
+}
+
+long long ring_buffer_shm_offset(const struct ring_buffer_shm* shm, const void* block)
+{
+    return (long long)((const unsigned char*)block - shm->m_arena);
+}
+
+void* ring_buffer_shm_pointer(const struct ring_buffer_shm* shm, long long offset)
+{
+    return shm->m_arena + offset;
+}
@@ -0,0 +1,142 @@
+//-----------------------------------------------------------------------------//
+// CRingBuffer MPMC - FIFO helper                                              //
+// (c) 2023 Laurent Lardinois https://be.linkedin.com/in/laurentlardinois      //
+//                                                                             //
+// https://github.com/type-one/CRingBuffer_MPSC                                //
+//                                                                             //
+// This software is provided 'as-is', without any express or implied           //
+// warranty.In no event will the authors be held liable for any damages        //
+// arising from the use of this software.                                      //
+//                                                                             //
+// Permission is granted to anyone to use this software for any purpose,       //
+// including commercial applications, and to alter itand redistribute it       //
+// freely, subject to the following restrictions :                             //
+//                                                                             //
+// 1. The origin of this software must not be misrepresented; you must not     //
+// claim that you wrote the original software.If you use this software         //
+// in a product, an acknowledgment in the product documentation would be       //
+// appreciated but is not required.                                            //
+// 2. Altered source versions must be plainly marked as such, and must not be  //
+// misrepresented as being the original software.                              //
+// 3. This notice may not be removed or altered from any source distribution.  //
+//-----------------------------------------------------------------------------//
+
+#pragma once
+
+#if !defined(__RING_BUFFER_SHM_H__)
+#define __RING_BUFFER_SHM_H__
+
+#include "atomic_helper.h"
+#include "ring_buffer_mpmc.h"
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#if defined(_WIN32)
+#include <windows.h>
+#endif
+
+#if defined(RING_BUFFER_SHM_IMPLEM)
+#define EXTERN_RING_BUFFER_SHM
+#else
+#define EXTERN_RING_BUFFER_SHM extern
+#endif
+
+#if defined(__cplusplus)
+extern "C"
+{
+#endif
+
+    /* inter-process MPMC ring living in a shared memory region: the region holds a header, the queue
+       of frames, a queue of free blocks and the payload arena of fixed-size blocks; the queues store
+       offsets into the arena (each process maps the region at its own address) and only use lock-free
+       atomics (no process-local mutex), so producers and consumers can be in different processes,
+       the 64-bit atomics must be lock-free (address free) on the target;
+       there is no fault isolation between the processes: one killed between claiming a slot (index CAS)
+       and publishing it (m_sequence store) blocks that slot, so the queue stalls there for every other
+       process, and the blocks held by a process that dies (allocated, or popped and not freed yet) are
+       never given back, the region must then be recreated (see ring_buffer_shm_unlink) */
+
+#define RING_BUFFER_SHM_MAGIC 0x314d485342524343ULL /* "CCRBSHM1" */
+#define RING_BUFFER_SHM_VERSION 1U
+
+    struct ring_buffer_shm_cell
+    {
+        _atomic_llong m_sequence;
+        _atomic_llong m_offset; /* frame block, relative to the arena */
+        _atomic_llong m_length;
+    };
+
+    struct ring_buffer_shm_queue
+    {
+        RING_BUFFER_ALIGNED _atomic_llong m_write_idx;
+        RING_BUFFER_ALIGNED _atomic_llong m_read_idx;
+    };
+
+    /* at the start of the region, shared by every process */
+    struct ring_buffer_shm_header
+    {
+        _atomic_ullong m_magic; /* written last, once the region is formatted */
+        unsigned int m_version;
+        unsigned int m_header_size; /* both sides must be built with the same cache line alignment */
+        long long m_size;           /* power of two, number of blocks and entries of each queue */
+        long long m_mask;
+        unsigned long long m_block_size;
+        unsigned long long m_region_size;
+        unsigned long long m_cells_offset;
+        unsigned long long m_free_cells_offset;
+        unsigned long long m_arena_offset;
+
+        struct ring_buffer_shm_queue m_frames;
+        struct ring_buffer_shm_queue m_free;
+    };
+
+    /* process-local view of the region */
+    struct ring_buffer_shm
+    {
+        struct ring_buffer_shm_header* m_header;
+        struct ring_buffer_shm_cell* m_cells;
+        struct ring_buffer_shm_cell* m_free_cells;
+        unsigned char* m_arena;
+        size_t m_region_size;
+        bool m_mapped; /* region mapped by init/attach_named, unmapped by deinit */
+#if defined(_WIN32)
+        HANDLE m_mapping;
+#endif
+    };
+
+    /* bytes needed for capacity blocks (power of two) of block_size bytes */
+    EXTERN_RING_BUFFER_SHM size_t ring_buffer_shm_region_size(unsigned long long capacity, size_t block_size);
+
+    /* format a region mapped by the caller (memfd, MAP_SHARED | MAP_ANONYMOUS before fork...),
+       preferably aligned on RING_BUFFER_STORAGE_ALIGNMENT, other processes then attach to it */
+    EXTERN_RING_BUFFER_SHM int init_ring_buffer_shm(struct ring_buffer_shm* shm, void* region, unsigned long long capacity, size_t block_size);
+    EXTERN_RING_BUFFER_SHM int attach_ring_buffer_shm(struct ring_buffer_shm* shm, void* region);
+
+    /* create (fails if it exists) or open a named region: shm_open on POSIX, named file mapping on Windows */
+    EXTERN_RING_BUFFER_SHM int init_ring_buffer_shm_named(
+        struct ring_buffer_shm* shm, const char* name, unsigned long long capacity, size_t block_size);
+    EXTERN_RING_BUFFER_SHM int attach_ring_buffer_shm_named(struct ring_buffer_shm* shm, const char* name);
+
+    /* detach this process, the region stays until unlinked (POSIX) or until the last process closed it (Windows) */
+    EXTERN_RING_BUFFER_SHM int deinit_ring_buffer_shm(struct ring_buffer_shm* shm);
+    EXTERN_RING_BUFFER_SHM int ring_buffer_shm_unlink(const char* name);
+
+    /* block of m_block_size bytes from the arena, NULL if all the blocks are in use */
+    EXTERN_RING_BUFFER_SHM void* ring_buffer_shm_alloc(struct ring_buffer_shm* shm);
+    EXTERN_RING_BUFFER_SHM void ring_buffer_shm_free(struct ring_buffer_shm* shm, void* block);
+
+    /* hand a block (and the used length) to the consumers without copy, the consumer frees it once done */
+    EXTERN_RING_BUFFER_SHM bool ring_buffer_shm_push(struct ring_buffer_shm* shm, void* block, size_t length);
+    EXTERN_RING_BUFFER_SHM bool ring_buffer_shm_pop(struct ring_buffer_shm* shm, void** block, size_t* length);
+
+    /* address translation for frames linking to other blocks */
+    EXTERN_RING_BUFFER_SHM long long ring_buffer_shm_offset(const struct ring_buffer_shm* shm, const void* block);
+    EXTERN_RING_BUFFER_SHM void* ring_buffer_shm_pointer(const struct ring_buffer_shm* shm, long long offset);
+
+#if defined(__cplusplus)
+};
+#endif
+
+#endif /*  __RING_BUFFER_SHM_H__ */
@@ -0,0 +1,158 @@
+//-----------------------------------------------------------------------------//
+// CRingBuffer MPMC - FIFO helper                                              //
+// (c) 2023 Laurent Lardinois https://be.linkedin.com/in/laurentlardinois      //
+//                                                                             //
+// https://github.com/type-one/CRingBuffer_MPSC                                //
+//                                                                             //
+// This software is provided 'as-is', without any express or implied           //
+// warranty.In no event will the authors be held liable for any damages        //
+// arising from the use of this software.                                      //
+//                                                                             //
+// Permission is granted to anyone to use this software for any purpose,       //
+// including commercial applications, and to alter itand redistribute it       //
+// freely, subject to the following restrictions :                             //
+//                                                                             //
+// 1. The origin of this software must not be misrepresented; you must not     //
+// claim that you wrote the original software.If you use this software         //
+// in a product, an acknowledgment in the product documentation would be       //
+// appreciated but is not required.                                            //
+// 2. Altered source versions must be plainly marked as such, and must not be  //
+// misrepresented as being the original software.                              //
+// 3. This notice may not be removed or altered from any source distribution.  //
+//-----------------------------------------------------------------------------//
+
+#include "atomic_helper.h"
+#define RING_BUFFER_SPSC_IMPLEM
+#include "ring_buffer_spsc.h"
+#include "mem_alloc.h"
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <string.h>
+
+
+size_t ring_buffer_spsc_storage_size(unsigned long long capacity)
+{
+    return (size_t)capacity * sizeof(_atomic_uintptr);
+}
+
+int init_ring_buffer_spsc(struct ring_buffer_spsc* fifo)
+{
+    return init_ring_buffer_spsc_ex(fifo, RING_BUFFER_SIZE, NULL);
+}
+
+int init_ring_buffer_spsc_ex(struct ring_buffer_spsc* fifo, unsigned long long capacity, void* storage)
+{
+    if (!fifo)
+    {
+        return -1;
+    }
+
+    /* power of two only, mask computed per instance */
+    if ((capacity < 2ULL) || (0ULL != (capacity & (capacity - 1ULL))))
+    {
+        return -1;
+    }
+
+    fifo->m_owns_buffer = (NULL == storage);
+    fifo->m_buffer = (_atomic_uintptr*)(fifo->m_owns_buffer
+            ? mem_alloc_aligned(ring_buffer_spsc_storage_size(capacity), RING_BUFFER_STORAGE_ALIGNMENT)
+            : storage);
+
+    if (!fifo->m_buffer)
+    {
+        return -1;
+    }
+
+    fifo->m_size = (long long)capacity;
+    fifo->m_mask = (long long)(capacity - 1ULL);
+
+    memset((void*)(fifo->m_buffer), 0, ring_buffer_spsc_storage_size(capacity));
+    sync_atomic_store(fifo->m_write_idx, 0LL);
+    sync_atomic_store(fifo->m_read_idx, 0LL);
+    fifo->m_read_idx_cache = 0LL;
+    fifo->m_write_idx_cache = 0LL;
+    fifo->m_read_idx_reloads = 0ULL;
+    fifo->m_write_idx_reloads = 0ULL;
+    sync_write_release();
+
+    return 0;
+}
+
+int deinit_ring_buffer_spsc(struct ring_buffer_spsc* fifo)
+{
+    if (!fifo)
+    {
+        return -1;
+    }
+
+    if (fifo->m_owns_buffer)
+    {
+        mem_free_aligned((void*)(fifo->m_buffer));
+    }
+    fifo->m_buffer = NULL;
+
+    return 0;
+}
+
+bool ring_buffer_spsc_push(struct ring_buffer_spsc* fifo, void* elem)
+{
+    if (!fifo || !elem)
+    {
+        return false;
+    }
+
+    /* own index, only written by this producer */
+    const long long write_idx = sync_atomic_load_relaxed(fifo->m_write_idx);
+
+    /* looks full ? refresh the cached consumer index */
+    if ((write_idx - fifo->m_read_idx_cache) >= fifo->m_size)
+    {
+        fifo->m_read_idx_cache = sync_atomic_load_acquire(fifo->m_read_idx);
+        ++(fifo->m_read_idx_reloads);
+
+        /* is full ? */
+        if ((write_idx - fifo->m_read_idx_cache) >= fifo->m_size)
+        {
+            return false;
+        }
+    }
+
+    sync_atomic_store_relaxed(fifo->m_buffer[write_idx & fifo->m_mask], (uintptr_t)elem);
+
+    /* publish to the consumer */
+    sync_atomic_store_release(fifo->m_write_idx, write_idx + 1);
+
+    return true;
+}
+
+bool ring_buffer_spsc_pop(struct ring_buffer_spsc* fifo, void** elem)
+{
+    if (!fifo || !elem)
+    {
+        return false;
+    }
+
+    /* own index, only written by this consumer */
+    const long long read_idx = sync_atomic_load_relaxed(fifo->m_read_idx);
+
+    /* looks empty ? refresh the cached producer index */
+    if (read_idx >= fifo->m_write_idx_cache)
+    {
+        fifo->m_write_idx_cache = sync_atomic_load_acquire(fifo->m_write_idx);
+        ++(fifo->m_write_idx_reloads);
+
+        /* is empty ? */
+        if (read_idx >= fifo->m_write_idx_cache)
+        {
+            return false;
+        }
+    }
+
+    *elem = (void*)sync_atomic_load_relaxed(fifo->m_buffer[read_idx & fifo->m_mask]);
+
+    /* release the slot to the producer */
+    sync_atomic_store_release(fifo->m_read_idx, read_idx + 1);
+
+    return (*elem == NULL) ? false : true;
+}
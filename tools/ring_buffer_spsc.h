@@ -0,0 +1,85 @@
+//-----------------------------------------------------------------------------//
+// CRingBuffer MPMC - FIFO helper                                              //
+// (c) 2023 Laurent Lardinois https://be.linkedin.com/in/laurentlardinois      //
+//                                                                             //
+// https://github.com/type-one/CRingBuffer_MPSC                                //
+//                                                                             //
+// This software is provided 'as-is', without any express or implied           //
+// warranty.In no event will the authors be held liable for any damages        //
+// arising from the use of this software.                                      //
+//                                                                             //
+// Permission is granted to anyone to use this software for any purpose,       //
+// including commercial applications, and to alter itand redistribute it       //
+// freely, subject to the following restrictions :                             //
+//                                                                             //
+// 1. The origin of this software must not be misrepresented; you must not     //
+// claim that you wrote the original software.If you use this software         //
+// in a product, an acknowledgment in the product documentation would be       //
+// appreciated but is not required.                                            //
+// 2. Altered source versions must be plainly marked as such, and must not be  //
+// misrepresented as being the original software.                              //
+// 3. This notice may not be removed or altered from any source distribution.  //
+//-----------------------------------------------------------------------------//
+
+#pragma once
+
+#if !defined(__RING_BUFFER_SPSC_H__)
+#define __RING_BUFFER_SPSC_H__
+
+#include "atomic_helper.h"
+#include "ring_buffer_mpmc.h"
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#if defined(RING_BUFFER_SPSC_IMPLEM)
+#define EXTERN_RING_BUFFER_SPSC
+#else
+#define EXTERN_RING_BUFFER_SPSC extern
+#endif
+
+#if defined(__cplusplus)
+extern "C"
+{
+#endif
+
+    /* strict single producer/single consumer engine: each side keeps a private cached copy of the
+       other side index and only reloads the shared one when the queue looks full (producer) or
+       empty (consumer), no handshake flags */
+
+    struct ring_buffer_spsc
+    {
+        /* read-only after init */
+        _atomic_uintptr* m_buffer;
+        long long m_size; /* power of two, the ring holds up to m_size elements */
+        long long m_mask;
+        bool m_owns_buffer;
+
+        /* producer side */
+        RING_BUFFER_ALIGNED _atomic_llong m_write_idx;
+        long long m_read_idx_cache;
+        unsigned long long m_read_idx_reloads; /* number of loads of the shared consumer index */
+
+        /* consumer side */
+        RING_BUFFER_ALIGNED _atomic_llong m_read_idx;
+        long long m_write_idx_cache;
+        unsigned long long m_write_idx_reloads; /* number of loads of the shared producer index */
+    };
+
+    /* default capacity of RING_BUFFER_SIZE entries, storage allocated on the heap */
+    EXTERN_RING_BUFFER_SPSC int init_ring_buffer_spsc(struct ring_buffer_spsc* fifo);
+
+    /* capacity must be a power of two, storage can be NULL (allocated on the heap and released by deinit)
+       or point to ring_buffer_spsc_storage_size(capacity) bytes owned by the caller */
+    EXTERN_RING_BUFFER_SPSC int init_ring_buffer_spsc_ex(struct ring_buffer_spsc* fifo, unsigned long long capacity, void* storage);
+    EXTERN_RING_BUFFER_SPSC size_t ring_buffer_spsc_storage_size(unsigned long long capacity);
+    EXTERN_RING_BUFFER_SPSC int deinit_ring_buffer_spsc(struct ring_buffer_spsc* fifo);
+    EXTERN_RING_BUFFER_SPSC bool ring_buffer_spsc_push(struct ring_buffer_spsc* fifo, void* elem);
+    EXTERN_RING_BUFFER_SPSC bool ring_buffer_spsc_pop(struct ring_buffer_spsc* fifo, void** elem);
+
+#if defined(__cplusplus)
+};
+#endif
+
+#endif /*  __RING_BUFFER_SPSC_H__ */
@@ -0,0 +1,396 @@
+//-----------------------------------------------------------------------------//
+// CRingBuffer MPMC - FIFO helper                                              //
+// (c) 2023 Laurent Lardinois https://be.linkedin.com/in/laurentlardinois      //
+//                                                                             //
+// https://github.com/type-one/CRingBuffer_MPSC                                //
+//                                                                             //
+// This software is provided 'as-is', without any express or implied           //
+// warranty.In no event will the authors be held liable for any damages        //
+// arising from the use of this software.                                      //
+//                                                                             //
+// Permission is granted to anyone to use this software for any purpose,       //
+// including commercial applications, and to alter itand redistribute it       //
+// freely, subject to the following restrictions :                             //
+//                                                                             //
+// 1. The origin of this software must not be misrepresented; you must not     //
+// claim that you wrote the original software.If you use this software         //
+// in a product, an acknowledgment in the product documentation would be       //
+// appreciated but is not required.                                            //
+// 2. Altered source versions must be plainly marked as such, and must not be  //
+// misrepresented as being the original software.                              //
+// 3. This notice may not be removed or altered from any source distribution.  //
+//-----------------------------------------------------------------------------//
+
+#if defined(__linux__) && !defined(_GNU_SOURCE)
+#define _GNU_SOURCE /* sched_setaffinity, CPU_SET */
+#endif
+
+#define THREAD_HELPER_IMPLEM
+#include "thread_helper.h"
+
+#include "atomic_helper.h"
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+
+#if defined(_WIN32)
+#include <windows.h>
+#else
+#include <sched.h>
+#include <unistd.h>
+#endif
+
+#define THREAD_START_PENDING 0
+#define THREAD_START_RUNNING 1
+#define THREAD_START_REFUSED 2
+
+/* on the stack of start_thread, which waits for m_status before returning */
+struct thread_start
+{
+    thread_func m_func;
+    void* m_arg;
+    bool m_pinned;
+    struct thread_cpu_set m_cpus;
+    _atomic_int m_status;
+};
+
+static void thread_yield(void)
+{
+#if defined(_WIN32)
+    Sleep(0);
+#elif defined(__STDC_NO_THREADS__)
+    sched_yield();
+#else
+    thrd_yield();
+#endif
+}
+
+
+void thread_cpu_set_clear(struct thread_cpu_set* cpus)
+{
+    memset(cpus, 0, sizeof(struct thread_cpu_set));
+}
+
+void thread_cpu_set_add(struct thread_cpu_set* cpus, int cpu)
+{
+    if ((cpu >= 0) && (cpu < THREAD_MAX_CPUS))
+    {
+        cpus->m_mask[cpu / 64] |= (uint64_t)1U << (cpu % 64);
+    }
+}
+
+bool thread_cpu_set_has(const struct thread_cpu_set* cpus, int cpu)
+{
+    if ((cpu < 0) || (cpu >= THREAD_MAX_CPUS))
+    {
+        return false;
+    }
+
+    return (0U != (cpus->m_mask[cpu / 64] & ((uint64_t)1U << (cpu % 64))));
+}
+
+int thread_cpu_count(void)
+{
+    int count = 1;
+
+#if defined(_WIN32)
+    SYSTEM_INFO info;
+    GetSystemInfo(&info);
+    count = (int)info.dwNumberOfProcessors;
+#elif defined(_SC_NPROCESSORS_ONLN)
+    count = (int)sysconf(_SC_NPROCESSORS_ONLN);
+#endif
+
+    if (count > THREAD_MAX_CPUS)
+    {
+        count = THREAD_MAX_CPUS;
+    }
+
+    return (count > 0) ? count : 1;
+}
+
+int thread_cpu_allowed(struct thread_cpu_set* cpus)
+{
+    int count = 0;
+
+    if (!cpus)
+    {
+        return 0;
+    }
+
+    thread_cpu_set_clear(cpus);
+
+#if defined(_WIN32)
+    DWORD_PTR process_mask = 0U;
+    DWORD_PTR system_mask = 0U;
+
+    if (GetProcessAffinityMask(GetCurrentProcess(), &process_mask, &system_mask))
+    {
+        for (int cpu = 0; cpu < (int)(8U * sizeof(DWORD_PTR)); ++cpu)
+        {
+            if (0U != (process_mask & ((DWORD_PTR)1U << cpu)))
+            {
+                thread_cpu_set_add(cpus, cpu);
+                ++count;
+            }
+        }
+    }
+#elif defined(__linux__)
+    cpu_set_t set;
+    CPU_ZERO(&set);
+
+    if (0 == sched_getaffinity(0, sizeof(cpu_set_t), &set))
+    {
+        for (int cpu = 0; (cpu < THREAD_MAX_CPUS) && (cpu < CPU_SETSIZE); ++cpu)
+        {
+            if (CPU_ISSET(cpu, &set))
+            {
+                thread_cpu_set_add(cpus, cpu);
+                ++count;
+            }
+        }
+    }
+#endif
+
+    /* no affinity mask available: every online CPU */
+    if (0 == count)
+    {
+        count = thread_cpu_count();
+        for (int cpu = 0; cpu < count; ++cpu)
+        {
+            thread_cpu_set_add(cpus, cpu);
+        }
+    }
+
+    return count;
+}
+
+#if defined(__linux__)
+static int thread_read_topology(int cpu, const char* entry)
+{
+    char path[128];
+    int value = -1;
+
+    snprintf(path, sizeof(path), "/sys/devices/system/cpu/cpu%d/topology/%s", cpu, entry);
+
+    FILE* file = fopen(path, "r");
+    if (file)
+    {
+        if (1 != fscanf(file, "%d", &value))
+        {
+            value = -1;
+        }
+        fclose(file);
+    }
+
+    return value;
+}
+#endif
+
+int thread_cpu_topology(int cpu, int* core, int* package)
+{
+    if ((cpu < 0) || (cpu >= THREAD_MAX_CPUS) || !core || !package)
+    {
+        return -1;
+    }
+
+    /* unknown topology: one core per CPU, a single package */
+    *core = cpu;
+    *package = 0;
+
+#if defined(_WIN32)
+    SYSTEM_LOGICAL_PROCESSOR_INFORMATION infos[256];
+    DWORD length = (DWORD)sizeof(infos);
+
+    if ((cpu >= 64) || !GetLogicalProcessorInformation(infos, &length))
+    {
+        return -1;
+    }
+
+    int nb_cores = 0;
+    int nb_packages = 0;
+    const ULONG_PTR bit = (ULONG_PTR)1U << cpu;
+
+    for (DWORD i = 0; i < length / (DWORD)sizeof(SYSTEM_LOGICAL_PROCESSOR_INFORMATION); ++i)
+    {
+        if (RelationProcessorCore == infos[i].Relationship)
+        {
+            if (0U != (infos[i].ProcessorMask & bit))
+            {
+                *core = nb_cores;
+            }
+            ++nb_cores;
+        }
+        else if (RelationProcessorPackage == infos[i].Relationship)
+        {
+            if (0U != (infos[i].ProcessorMask & bit))
+            {
+                *package = nb_packages;
+            }
+            ++nb_packages;
+        }
+    }
+#elif defined(__linux__)
+    const int core_id = thread_read_topology(cpu, "core_id");
+    const int package_id = thread_read_topology(cpu, "physical_package_id");
+
+    if ((core_id < 0) || (package_id < 0))
+    {
+        return -1;
+    }
+
+    /* core ids are only unique within a package */
+    *core = package_id * THREAD_MAX_CPUS + core_id;
+    *package = package_id;
+#endif
+
+    return 0;
+}
+
+int thread_pin_current(const struct thread_cpu_set* cpus)
+{
+    if (!cpus)
+    {
+        return -1;
+    }
+
+#if defined(_WIN32)
+    DWORD_PTR mask = (DWORD_PTR)cpus->m_mask[0];
+
+    return ((0U != mask) && (0U != SetThreadAffinityMask(GetCurrentThread(), mask))) ? 0 : -1;
+#elif defined(__linux__)
+    cpu_set_t set;
+    CPU_ZERO(&set);
+
+    for (int cpu = 0; (cpu < THREAD_MAX_CPUS) && (cpu < CPU_SETSIZE); ++cpu)
+    {
+        if (thread_cpu_set_has(cpus, cpu))
+        {
+            CPU_SET(cpu, &set);
+        }
+    }
+
+    return (0 == sched_setaffinity(0, sizeof(cpu_set_t), &set)) ? 0 : -1;
+#else
+    return -1;
+#endif
+}
+
+int thread_pin_current_cpu(int cpu)
+{
+    struct thread_cpu_set cpus;
+
+    thread_cpu_set_clear(&cpus);
+    thread_cpu_set_add(&cpus, cpu);
+
+    return thread_pin_current(&cpus);
+}
+
+static void thread_run(struct thread_start* start)
+{
+    const thread_func func = start->m_func;
+    void* const arg = start->m_arg;
+
+    /* pin before running anything, start_thread reports a refused placement instead of an unpinned thread */
+    const bool refused = start->m_pinned && (thread_pin_current(&(start->m_cpus)) < 0);
+
+    /* start belongs to start_thread again once the status is published */
+    sync_atomic_store_release(start->m_status, refused ? THREAD_START_REFUSED : THREAD_START_RUNNING);
+
+    if (!refused)
+    {
+        func(arg);
+    }
+}
+
+#if defined(_WIN32)
+static DWORD WINAPI thread_entry(LPVOID arg)
+{
+    thread_run((struct thread_start*)arg);
+    return 0;
+}
+#elif defined(__STDC_NO_THREADS__)
+static void* thread_entry(void* arg)
+{
+    thread_run((struct thread_start*)arg);
+    return NULL;
+}
+#else
+static int thread_entry(void* arg)
+{
+    thread_run((struct thread_start*)arg);
+    return 0;
+}
+#endif
+
+int start_thread(struct thread_handle* thread, thread_func func, void* arg, const struct thread_cpu_set* cpus)
+{
+    if (!thread || !func)
+    {
+        return -1;
+    }
+
+    struct thread_start start;
+
+    start.m_func = func;
+    start.m_arg = arg;
+    start.m_pinned = (NULL != cpus);
+    if (cpus)
+    {
+        start.m_cpus = *cpus;
+    }
+    sync_atomic_store(start.m_status, THREAD_START_PENDING);
+
+#if defined(_WIN32)
+    thread->m_thread = CreateThread(0, 0, thread_entry, &start, 0, NULL);
+    const bool created = (NULL != thread->m_thread);
+#elif defined(__STDC_NO_THREADS__)
+    const bool created = (0 == pthread_create(&(thread->m_thread), NULL, thread_entry, &start));
+#else
+    const bool created = (thrd_success == thrd_create(&(thread->m_thread), thread_entry, &start));
+#endif
+
+    if (!created)
+    {
+        return -1;
+    }
+
+    /* wait for the placement result, the thread does not touch start afterwards */
+    int status;
+    while (THREAD_START_PENDING == (status = sync_atomic_load_acquire(start.m_status)))
+    {
+        thread_yield();
+    }
+
+    if (THREAD_START_REFUSED == status)
+    {
+        (void)join_thread(thread);
+        return -1;
+    }
+
+    return 0;
+}
+
+int join_thread(struct thread_handle* thread)
+{
+    if (!thread)
+    {
+        return -1;
+    }
+
+#if defined(_WIN32)
+    WaitForSingleObject(thread->m_thread, INFINITE);
+    CloseHandle(thread->m_thread);
+    thread->m_thread = NULL;
+#elif defined(__STDC_NO_THREADS__)
+    void* ret;
+    pthread_join(thread->m_thread, &ret);
+#else
+    int ret;
+    thrd_join(thread->m_thread, &ret);
+#endif
+
+    return 0;
+}
@@ -0,0 +1,101 @@
+//-----------------------------------------------------------------------------//
+// CRingBuffer MPMC - FIFO helper                                              //
+// (c) 2023 Laurent Lardinois https://be.linkedin.com/in/laurentlardinois      //
+//                                                                             //
+// https://github.com/type-one/CRingBuffer_MPSC                                //
+//                                                                             //
+// This software is provided 'as-is', without any express or implied           //
+// warranty.In no event will the authors be held liable for any damages        //
+// arising from the use of this software.                                      //
+//                                                                             //
+// Permission is granted to anyone to use this software for any purpose,       //
+// including commercial applications, and to alter itand redistribute it       //
+// freely, subject to the following restrictions :                             //
+//                                                                             //
+// 1. The origin of this software must not be misrepresented; you must not     //
+// claim that you wrote the original software.If you use this software         //
+// in a product, an acknowledgment in the product documentation would be       //
+// appreciated but is not required.                                            //
+// 2. Altered source versions must be plainly marked as such, and must not be  //
+// misrepresented as being the original software.                              //
+// 3. This notice may not be removed or altered from any source distribution.  //
+//-----------------------------------------------------------------------------//
+
+#pragma once
+
+#if !defined(__THREAD_HELPER_H__)
+#define __THREAD_HELPER_H__
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#if defined(_WIN32)
+#include <windows.h>
+#elif defined(__STDC_NO_THREADS__)
+#include <pthread.h>
+#else
+#include <threads.h>
+#endif
+
+#if defined(THREAD_HELPER_IMPLEM)
+#define EXTERN_THREAD_HELPER
+#else
+#define EXTERN_THREAD_HELPER extern
+#endif
+
+#if defined(__cplusplus)
+extern "C"
+{
+#endif
+
+    /* portable thread creation with optional CPU placement: the new thread pins itself to the given
+       CPU set and reports the result before running its function (sched_setaffinity on Linux,
+       SetThreadAffinityMask on Windows, first processor group only; no placement where the OS has no
+       hard affinity), start_thread fails rather than running an unpinned thread */
+
+#define THREAD_MAX_CPUS 256
+
+    struct thread_cpu_set
+    {
+        uint64_t m_mask[THREAD_MAX_CPUS / 64];
+    };
+
+    typedef void (*thread_func)(void* arg);
+
+    struct thread_handle
+    {
+#if defined(_WIN32)
+        HANDLE m_thread;
+#elif defined(__STDC_NO_THREADS__)
+    pthread_t m_thread;
+#else
+    thrd_t m_thread;
+#endif
+    };
+
+    EXTERN_THREAD_HELPER void thread_cpu_set_clear(struct thread_cpu_set* cpus);
+    EXTERN_THREAD_HELPER void thread_cpu_set_add(struct thread_cpu_set* cpus, int cpu);
+    EXTERN_THREAD_HELPER bool thread_cpu_set_has(const struct thread_cpu_set* cpus, int cpu);
+
+    /* online CPUs, and core / package (socket) of a CPU: CPUs sharing a core are SMT siblings */
+    EXTERN_THREAD_HELPER int thread_cpu_count(void);
+
+    /* CPUs the calling thread may run on (the process affinity, cpuset of a container...) when called
+       before any pinning, returns their number */
+    EXTERN_THREAD_HELPER int thread_cpu_allowed(struct thread_cpu_set* cpus);
+    EXTERN_THREAD_HELPER int thread_cpu_topology(int cpu, int* core, int* package);
+
+    /* pin the calling thread, -1 if the placement could not be applied */
+    EXTERN_THREAD_HELPER int thread_pin_current(const struct thread_cpu_set* cpus);
+    EXTERN_THREAD_HELPER int thread_pin_current_cpu(int cpu);
+
+    /* cpus can be NULL (no placement), -1 if the thread could not be created or pinned (it is then
+       joined and func never runs) */
+    EXTERN_THREAD_HELPER int start_thread(struct thread_handle* thread, thread_func func, void* arg, const struct thread_cpu_set* cpus);
+    EXTERN_THREAD_HELPER int join_thread(struct thread_handle* thread);
+
+#if defined(__cplusplus)
+};
+#endif
+
+#endif /*  __THREAD_HELPER_H__ */
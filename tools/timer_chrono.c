@@ -24,6 +24,8 @@
 #define TIMER_CHRONO_IMPLEM
 #include "timer_chrono.h"
 
+#include "atomic_helper.h"
+
 #if defined(_WIN32)
 #include <windows.h>
 #elif defined(__MACH__)
@@ -37,6 +39,67 @@
 #endif
 
 #include <stdint.h>
+#include <string.h>
+
+#if defined(_WIN32)
+#elif defined(__STDC_NO_THREADS__)
+#include <pthread.h>
+#else
+#include <threads.h>
+#endif
+
+/* bits of the double ratio, 0 until calibrated, can be recalibrated while other threads convert */
+static _atomic_ullong st_ns_per_tick_bits;
+
+/* the lazy calibration runs once even when several threads convert their first ticks together */
+#if defined(_WIN32)
+static INIT_ONCE st_calibration_once = INIT_ONCE_STATIC_INIT;
+#elif defined(__STDC_NO_THREADS__)
+static pthread_once_t st_calibration_once = PTHREAD_ONCE_INIT;
+#else
+static once_flag st_calibration_once = ONCE_FLAG_INIT;
+#endif
+
+static void timer_chrono_store_ns_per_tick(double ns_per_tick)
+{
+    unsigned long long bits;
+    memcpy(&bits, &ns_per_tick, sizeof(bits));
+    sync_atomic_store_release(st_ns_per_tick_bits, bits);
+}
+
+static double timer_chrono_load_ns_per_tick(void)
+{
+    const unsigned long long bits = sync_atomic_load_acquire(st_ns_per_tick_bits);
+    double ns_per_tick;
+    memcpy(&ns_per_tick, &bits, sizeof(ns_per_tick));
+    return ns_per_tick;
+}
+
+/* the once flag is spent after this: a failed calibration (ticks not moving) must still leave a usable
+   ratio, the ticks are then taken as ns rather than every conversion returning 0 */
+static void timer_chrono_calibrate_or_fallback(void)
+{
+    if ((timer_chrono_calibrate() < 0) && (0.0 == timer_chrono_load_ns_per_tick()))
+    {
+        timer_chrono_store_ns_per_tick(1.0);
+    }
+}
+
+#if defined(_WIN32)
+static BOOL CALLBACK timer_chrono_calibrate_once(PINIT_ONCE once, PVOID parameter, PVOID* context)
+{
+    (void)once;
+    (void)parameter;
+    (void)context;
+    timer_chrono_calibrate_or_fallback();
+    return TRUE;
+}
+#else
+static void timer_chrono_calibrate_once(void)
+{
+    timer_chrono_calibrate_or_fallback();
+}
+#endif
 
 int init_timer_chrono(struct timer_chrono* ctxt)
 {
@@ -111,3 +174,114 @@ double timer_chrono_current_time_ms(struct timer_chrono* ctxt)
 
     return current_time;
 }
+
+uint64_t timer_chrono_now_ns(void)
+{
+#if defined(_WIN32)
+
+    static LARGE_INTEGER qw_ticks_per_sec = { 0 };
+    if (0 == qw_ticks_per_sec.QuadPart)
+    {
+        QueryPerformanceFrequency(&qw_ticks_per_sec); /* same value for every thread, race is harmless */
+    }
+
+    LARGE_INTEGER qw_time;
+    QueryPerformanceCounter(&qw_time);
+
+    /* split to avoid overflowing the multiplication */
+    const uint64_t secs = (uint64_t)(qw_time.QuadPart / qw_ticks_per_sec.QuadPart);
+    const uint64_t rem = (uint64_t)(qw_time.QuadPart % qw_ticks_per_sec.QuadPart);
+    return secs * 1000000000ULL + (rem * 1000000000ULL) / (uint64_t)qw_ticks_per_sec.QuadPart;
+
+#elif defined(__MACH__)
+
+    static mach_timebase_info_data_t info = { 0, 0 };
+    if (0 == info.denom)
+    {
+        mach_timebase_info(&info);
+    }
+
+    return mach_absolute_time() * info.numer / info.denom;
+
+#elif defined(__unix__) || defined(__linux__)
+
+    struct timespec spec;
+    clock_gettime(CLOCK_MONOTONIC, &spec);
+    return (uint64_t)spec.tv_sec * 1000000000ULL + (uint64_t)spec.tv_nsec;
+
+#else
+
+    return 0U;
+
+#endif
+}
+
+int timer_chrono_calibrate(void)
+{
+#if defined(TIMER_CHRONO_TSC_X86)
+
+    /* spin against the monotonic clock, long enough to make the read jitter negligible */
+    const uint64_t start_ns = timer_chrono_now_ns();
+    const uint64_t start_ticks = timer_chrono_ticks_ordered();
+    uint64_t end_ns;
+
+    do
+    {
+        end_ns = timer_chrono_now_ns();
+    } while ((end_ns - start_ns) < (uint64_t)TIMER_CHRONO_CALIBRATION_MS * 1000000ULL);
+
+    const uint64_t end_ticks = timer_chrono_ticks_ordered();
+
+    if (end_ticks <= start_ticks)
+    {
+        return -1;
+    }
+
+    timer_chrono_store_ns_per_tick((double)(end_ns - start_ns) / (double)(end_ticks - start_ticks));
+
+#elif defined(TIMER_CHRONO_TSC_ARM64)
+
+    /* the generic timer frequency is given by the system */
+    uint64_t frequency;
+    __asm__ __volatile__("mrs %0, cntfrq_el0" : "=r"(frequency));
+
+    if (0U == frequency)
+    {
+        return -1;
+    }
+
+    timer_chrono_store_ns_per_tick(1.0e9 / (double)frequency);
+
+#else
+
+    /* the ticks already are ns */
+    timer_chrono_store_ns_per_tick(1.0);
+
+#endif
+
+    return 0;
+}
+
+double timer_chrono_ns_per_tick(void)
+{
+    double ns_per_tick = timer_chrono_load_ns_per_tick();
+
+    if (0.0 == ns_per_tick)
+    {
+#if defined(_WIN32)
+        (void)InitOnceExecuteOnce(&st_calibration_once, timer_chrono_calibrate_once, NULL, NULL);
+#elif defined(__STDC_NO_THREADS__)
+        (void)pthread_once(&st_calibration_once, timer_chrono_calibrate_once);
+#else
+        call_once(&st_calibration_once, timer_chrono_calibrate_once);
+#endif
+        ns_per_tick = timer_chrono_load_ns_per_tick();
+    }
+
+    return ns_per_tick;
+}
+
+uint64_t timer_chrono_ticks_to_ns(uint64_t ticks)
+{
+    return (uint64_t)((double)ticks * timer_chrono_ns_per_tick());
+}
@@ -40,6 +40,18 @@
 
 #include <stdint.h>
 
+#if defined(_MSC_VER) && (defined(_M_X64) || defined(_M_IX86))
+#include <intrin.h>
+#define TIMER_CHRONO_TSC_X86 1
+#elif (defined(__GNUC__) || defined(__clang__)) && (defined(__x86_64__) || defined(__i386__))
+#include <x86intrin.h>
+#define TIMER_CHRONO_TSC_X86 1
+#elif (defined(__GNUC__) || defined(__clang__)) && defined(__aarch64__)
+#define TIMER_CHRONO_TSC_ARM64 1
+#endif
+
+#define TIMER_CHRONO_CALIBRATION_MS 10
+
 #if defined(__cplusplus)
 extern "C"
 {
@@ -77,6 +89,47 @@ extern "C"
     EXTERN_TIMER_CHRONO int init_timer_chrono(struct timer_chrono* ctxt);
     EXTERN_TIMER_CHRONO double timer_chrono_current_time_ms(struct timer_chrono* ctxt);
 
+    /* monotonic time stamp in ns (arbitrary origin), no context, to time short operations */
+    EXTERN_TIMER_CHRONO uint64_t timer_chrono_now_ns(void);
+
+    /* CPU time stamp counter (rdtsc on x86, cntvct_el0 on ARM64, timer_chrono_now_ns elsewhere), a few ns
+       to read so each element can be stamped; the counter is expected to be invariant and synchronized
+       between cores (constant_tsc and nonstop_tsc flags on x86) to compare stamps taken by different threads */
+    static inline uint64_t timer_chrono_ticks(void)
+    {
+#if defined(TIMER_CHRONO_TSC_X86)
+        return (uint64_t)__rdtsc();
+#elif defined(TIMER_CHRONO_TSC_ARM64)
+        uint64_t ticks;
+        __asm__ __volatile__("mrs %0, cntvct_el0" : "=r"(ticks));
+        return ticks;
+#else
+        return timer_chrono_now_ns();
+#endif
+    }
+
+    /* same, but waits for the previous instructions to complete (rdtscp / isb), for the end of a measured section */
+    static inline uint64_t timer_chrono_ticks_ordered(void)
+    {
+#if defined(TIMER_CHRONO_TSC_X86)
+        unsigned int aux;
+        return (uint64_t)__rdtscp(&aux);
+#elif defined(TIMER_CHRONO_TSC_ARM64)
+        uint64_t ticks;
+        __asm__ __volatile__("isb\n\tmrs %0, cntvct_el0" : "=r"(ticks) : : "memory");
+        return ticks;
+#else
+        return timer_chrono_now_ns();
+#endif
+    }
+
+    /* measure the tick rate against the monotonic clock (for TIMER_CHRONO_CALIBRATION_MS on x86), to call once
+       at startup, the conversions calibrate on first use otherwise; -1 if the ticks did not move (the ratio is
+       left as is, a failed first-use calibration falls back to 1 ns per tick) */
+    EXTERN_TIMER_CHRONO int timer_chrono_calibrate(void);
+    EXTERN_TIMER_CHRONO double timer_chrono_ns_per_tick(void);
+    EXTERN_TIMER_CHRONO uint64_t timer_chrono_ticks_to_ns(uint64_t ticks);
+
 #if defined(__cplusplus)
 };
 #endif
@@ -0,0 +1,204 @@
+//-----------------------------------------------------------------------------//
+// CRingBuffer MPMC - FIFO helper                                              //
+// (c) 2023 Laurent Lardinois https://be.linkedin.com/in/laurentlardinois      //
+//                                                                             //
+// https://github.com/type-one/CRingBuffer_MPSC                                //
+//                                                                             //
+// This software is provided 'as-is', without any express or implied           //
+// warranty.In no event will the authors be held liable for any damages        //
+// arising from the use of this software.                                      //
+//                                                                             //
+// Permission is granted to anyone to use this software for any purpose,       //
+// including commercial applications, and to alter itand redistribute it       //
+// freely, subject to the following restrictions :                             //
+//                                                                             //
+// 1. The origin of this software must not be misrepresented; you must not     //
+// claim that you wrote the original software.If you use this software         //
+// in a product, an acknowledgment in the product documentation would be       //
+// appreciated but is not required.                                            //
+// 2. Altered source versions must be plainly marked as such, and must not be  //
+// misrepresented as being the original software.                              //
+// 3. This notice may not be removed or altered from any source distribution.  //
+//-----------------------------------------------------------------------------//
+
+#include "atomic_helper.h"
+#define WORK_STEALING_DEQUE_IMPLEM
+#include "work_stealing_deque.h"
+#include "mem_alloc.h"
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <string.h>
+
+/* ordering follows "Correct and Efficient Work-Stealing for Weak Memory Models" (Le, Pop, Cohen,
+   Zappa Nardelli, PPoPP 2013), the slots are accessed with relaxed atomics because a thief may read
+   a slot the owner is overwriting, its CAS on m_top then fails */
+
+
+size_t work_stealing_deque_storage_size(unsigned long long capacity)
+{
+    return (size_t)capacity * sizeof(_atomic_uintptr);
+}
+
+int init_work_stealing_deque(struct work_stealing_deque* deque)
+{
+    return init_work_stealing_deque_ex(deque, RING_BUFFER_SIZE, NULL);
+}
+
+int init_work_stealing_deque_ex(struct work_stealing_deque* deque, unsigned long long capacity, void* storage)
+{
+    if (!deque)
+    {
+        return -1;
+    }
+
+    /* power of two only, mask computed per instance */
+    if ((capacity < 2ULL) || (0ULL != (capacity & (capacity - 1ULL))))
+    {
+        return -1;
+    }
+
+    deque->m_owns_buffer = (NULL == storage);
+    deque->m_buffer = (_atomic_uintptr*)(deque->m_owns_buffer
+            ? mem_alloc_aligned(work_stealing_deque_storage_size(capacity), RING_BUFFER_STORAGE_ALIGNMENT)
+            : storage);
+
+    if (!deque->m_buffer)
+    {
+        return -1;
+    }
+
+    deque->m_size = (long long)capacity;
+    deque->m_mask = (long long)(capacity - 1ULL);
+
+    memset((void*)(deque->m_buffer), 0, work_stealing_deque_storage_size(capacity));
+    sync_atomic_store(deque->m_bottom, 0LL);
+    sync_atomic_store(deque->m_top, 0LL);
+    sync_write_release();
+
+    return 0;
+}
+
+int deinit_work_stealing_deque(struct work_stealing_deque* deque)
+{
+    if (!deque)
+    {
+        return -1;
+    }
+
+    if (deque->m_owns_buffer)
+    {
+        mem_free_aligned((void*)(deque->m_buffer));
+    }
+    deque->m_buffer = NULL;
+
+    return 0;
+}
+
+bool work_stealing_deque_push(struct work_stealing_deque* deque, void* elem)
+{
+    if (!deque || !elem)
+    {
+        return false;
+    }
+
+    const long long bottom = sync_atomic_load_relaxed(deque->m_bottom);
+    const long long top = sync_atomic_load_acquire(deque->m_top);
+
+    /* is full ? */
+    if ((bottom - top) >= deque->m_size)
+    {
+        return false;
+    }
+
+    sync_atomic_store_relaxed(deque->m_buffer[bottom & deque->m_mask], (uintptr_t)elem);
+
+    /* publish the slot to the thieves */
+    sync_fence_release();
+    sync_atomic_store_relaxed(deque->m_bottom, bottom + 1);
+
+    return true;
+}
+
+bool work_stealing_deque_pop(struct work_stealing_deque* deque, void** elem)
+{
+    if (!deque || !elem)
+    {
+        return false;
+    }
+
+    const long long bottom = sync_atomic_load_relaxed(deque->m_bottom) - 1;
+
+    /* claim the bottom slot before looking at m_top, a thief sees either the claim or the element */
+    sync_atomic_store_relaxed(deque->m_bottom, bottom);
+    sync_fence_seq_cst();
+    long long top = sync_atomic_load_relaxed(deque->m_top);
+
+    /* is empty ? */
+    if (top > bottom)
+    {
+        sync_atomic_store_relaxed(deque->m_bottom, bottom + 1);
+        return false;
+    }
+
+    void* value = (void*)sync_atomic_load_relaxed(deque->m_buffer[bottom & deque->m_mask]);
+
+    if (top == bottom)
+    {
+        /* last element, race the thieves for it */
+        const bool won = sync_atomic_cas_64(deque->m_top, top, top + 1);
+        sync_atomic_store_relaxed(deque->m_bottom, bottom + 1);
+
+        if (!won)
+        {
+            return false;
+        }
+    }
+
+    *elem = value;
+
+    return true;
+}
+
+bool work_stealing_deque_steal(struct work_stealing_deque* deque, void** elem)
+{
+    if (!deque || !elem)
+    {
+        return false;
+    }
+
+    long long top = sync_atomic_load_acquire(deque->m_top);
+    sync_fence_seq_cst();
+    const long long bottom = sync_atomic_load_acquire(deque->m_bottom);
+
+    /* is empty ? */
+    if (top >= bottom)
+    {
+        return false;
+    }
+
+    void* value = (void*)sync_atomic_load_relaxed(deque->m_buffer[top & deque->m_mask]);
+
+    /* another thief or the owner may have taken it */
+    if (!sync_atomic_cas_64(deque->m_top, top, top + 1))
+    {
+        return false;
+    }
+
+    *elem = value;
+
+    return true;
+}
+
+bool work_stealing_deque_is_empty(struct work_stealing_deque* deque)
+{
+    if (!deque)
+    {
+        return true;
+    }
+
+    const long long top = sync_atomic_load_acquire(deque->m_top);
+    const long long bottom = sync_atomic_load_acquire(deque->m_bottom);
+
+    return (top >= bottom);
+}
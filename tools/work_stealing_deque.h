@@ -0,0 +1,90 @@
+//-----------------------------------------------------------------------------//
+// CRingBuffer MPMC - FIFO helper                                              //
+// (c) 2023 Laurent Lardinois https://be.linkedin.com/in/laurentlardinois      //
+//                                                                             //
+// https://github.com/type-one/CRingBuffer_MPSC                                //
+//                                                                             //
+// This software is provided 'as-is', without any express or implied           //
+// warranty.In no event will the authors be held liable for any damages        //
+// arising from the use of this software.                                      //
+//                                                                             //
+// Permission is granted to anyone to use this software for any purpose,       //
+// including commercial applications, and to alter itand redistribute it       //
+// freely, subject to the following restrictions :                             //
+//                                                                             //
+// 1. The origin of this software must not be misrepresented; you must not     //
+// claim that you wrote the original software.If you use this software         //
+// in a product, an acknowledgment in the product documentation would be       //
+// appreciated but is not required.                                            //
+// 2. Altered source versions must be plainly marked as such, and must not be  //
+// misrepresented as being the original software.                              //
+// 3. This notice may not be removed or altered from any source distribution.  //
+//-----------------------------------------------------------------------------//
+
+#pragma once
+
+#if !defined(__WORK_STEALING_DEQUE_H__)
+#define __WORK_STEALING_DEQUE_H__
+
+#include "atomic_helper.h"
+#include "ring_buffer_mpmc.h"
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#if defined(WORK_STEALING_DEQUE_IMPLEM)
+#define EXTERN_WORK_STEALING_DEQUE
+#else
+#define EXTERN_WORK_STEALING_DEQUE extern
+#endif
+
+#if defined(__cplusplus)
+extern "C"
+{
+#endif
+
+    /* Chase-Lev work-stealing deque with a fixed power of two capacity: the owner thread pushes and
+       pops at the bottom without any atomic read-modify-write (except to race a thief for the last
+       element), other threads steal from the top with a CAS, so a worker pool only contends when a
+       worker runs out of its own tasks */
+
+    struct work_stealing_deque
+    {
+        /* read-only after init */
+        _atomic_uintptr* m_buffer;
+        long long m_size; /* power of two, the deque holds up to m_size elements */
+        long long m_mask;
+        bool m_owns_buffer;
+
+        /* owner side */
+        RING_BUFFER_ALIGNED _atomic_llong m_bottom;
+
+        /* thieves side */
+        RING_BUFFER_ALIGNED _atomic_llong m_top;
+    };
+
+    /* default capacity of RING_BUFFER_SIZE entries, storage allocated on the heap */
+    EXTERN_WORK_STEALING_DEQUE int init_work_stealing_deque(struct work_stealing_deque* deque);
+
+    /* capacity must be a power of two, storage can be NULL (allocated on the heap and released by deinit)
+       or point to work_stealing_deque_storage_size(capacity) bytes owned by the caller */
+    EXTERN_WORK_STEALING_DEQUE int init_work_stealing_deque_ex(struct work_stealing_deque* deque, unsigned long long capacity, void* storage);
+    EXTERN_WORK_STEALING_DEQUE size_t work_stealing_deque_storage_size(unsigned long long capacity);
+    EXTERN_WORK_STEALING_DEQUE int deinit_work_stealing_deque(struct work_stealing_deque* deque);
+
+    /* owner thread only, push returns false if full, pop takes the most recently pushed element */
+    EXTERN_WORK_STEALING_DEQUE bool work_stealing_deque_push(struct work_stealing_deque* deque, void* elem);
+    EXTERN_WORK_STEALING_DEQUE bool work_stealing_deque_pop(struct work_stealing_deque* deque, void** elem);
+
+    /* any thread, takes the oldest element, returns false if empty or if another thread won the race */
+    EXTERN_WORK_STEALING_DEQUE bool work_stealing_deque_steal(struct work_stealing_deque* deque, void** elem);
+
+    /* may be stale as soon as it returns */
+    EXTERN_WORK_STEALING_DEQUE bool work_stealing_deque_is_empty(struct work_stealing_deque* deque);
+
+#if defined(__cplusplus)
+};
+#endif
+
+#endif /*  __WORK_STEALING_DEQUE_H__ */